@@ -28,7 +28,7 @@ def print_call_settings(nick, cmd, stdin, time_limit, memory_limit):
     logging.info("{} command line string: {}".format(nick, " ".join(escaped_cmd)))
 
 
-def _get_preexec_function(time_limit, memory_limit):
+def _get_preexec_function(time_limit, memory_limit, exclude_shared_mappings=False):
     def set_limits():
         def _try_or_exit(function, description):
             def fail(exception, exitcode):
@@ -44,7 +44,9 @@ def _get_preexec_function(time_limit, memory_limit):
                 fail(err, returncodes.DRIVER_INPUT_ERROR)
 
         _try_or_exit(lambda: limits.set_time_limit(time_limit), "Setting time limit")
-        _try_or_exit(lambda: limits.set_memory_limit(memory_limit), "Setting memory limit")
+        _try_or_exit(
+            lambda: limits.set_memory_limit(memory_limit, exclude_shared_mappings),
+            "Setting memory limit")
 
     if time_limit is None and memory_limit is None:
         return None
@@ -52,10 +54,14 @@ def _get_preexec_function(time_limit, memory_limit):
         return set_limits
 
 
-def check_call(nick, cmd, stdin=None, time_limit=None, memory_limit=None):
+def check_call(nick, cmd, stdin=None, time_limit=None, memory_limit=None,
+               exclude_shared_mappings=False):
     print_call_settings(nick, cmd, stdin, time_limit, memory_limit)
+    if memory_limit is not None and exclude_shared_mappings:
+        logging.info("{} memory limit excludes shared file mappings".format(nick))
 
-    kwargs = {"preexec_fn": _get_preexec_function(time_limit, memory_limit)}
+    kwargs = {"preexec_fn": _get_preexec_function(
+        time_limit, memory_limit, exclude_shared_mappings)}
 
     sys.stdout.flush()
     if stdin:
@@ -5,6 +5,7 @@ try:
     import resource
 except ImportError:
     resource = None
+import re
 import sys
 
 
@@ -47,13 +48,32 @@ def set_time_limit(time_limit):
         resource.setrlimit(resource.RLIMIT_CPU, (time_limit, time_limit))
 
 
-def set_memory_limit(memory):
-    """*memory* must be given in bytes or None."""
+def set_memory_limit(memory, exclude_shared_mappings=False):
+    """*memory* must be given in bytes or None.
+
+    The limit applies to the address space of the process. If
+    *exclude_shared_mappings* is true, we limit the data segment instead,
+    which (since Linux 4.7) covers the heap and all private writable
+    mappings, but not shared file mappings such as the storage file of the
+    search (option storage_directory).
+    """
     if memory is None:
         return
     if not can_set_memory_limit():
         raise NotImplementedError(CANNOT_LIMIT_MEMORY_MSG)
-    resource.setrlimit(resource.RLIMIT_AS, (memory, memory))
+    if exclude_shared_mappings:
+        resource.setrlimit(resource.RLIMIT_DATA, (memory, memory))
+    else:
+        resource.setrlimit(resource.RLIMIT_AS, (memory, memory))
+
+
+def uses_file_backed_storage(search_options):
+    """
+    Return whether the search options store states in a memory-mapped file
+    (storage_directory other than none).
+    """
+    pattern = re.compile(r"storage_directory\s*=\s*(?!none\b)[^\s,)]")
+    return any(pattern.search(option) for option in search_options)
 
 
 def convert_to_mb(num_bytes):
@@ -0,0 +1,230 @@
+#! /usr/bin/env python3
+
+"""
+Decode sample files written with sample_format=binary (see
+src/search/sampling_engines/binary_sample_format.h) and print one JSON
+object per sample.
+
+The functions can also be used to load the samples directly, e.g. for
+training:
+
+    for header, sample in read_samples("samples.bin"):
+        ...
+"""
+
+import argparse
+import collections
+import json
+import sys
+import zlib
+
+
+MAGIC_WORD = b"FDBSAMPLES"
+VERSION = 1
+
+FIELD_GOAL = 1 << 0
+FIELD_SECOND_STATE = 1 << 1
+FIELD_ACTION = 1 << 2
+FIELD_UNSOLVED = 1 << 3
+
+COMPRESSION_NONE = 0
+COMPRESSION_ZLIB = 1
+
+
+Variable = collections.namedtuple(
+    "Variable",
+    ["name", "domain_size", "bin_index", "shift", "num_bits", "fact_names"])
+
+Header = collections.namedtuple(
+    "Header",
+    ["version", "fields", "compression", "sample_types", "heuristic_names",
+     "num_bins", "variables"])
+
+# States are lists of values. None marks an unassigned (goal) or undefined
+# (partial state) variable. Missing optional parts are None.
+Sample = collections.namedtuple(
+    "Sample",
+    ["sample_type", "modification_hash", "state", "goal", "second_state",
+     "operator_id", "unsolved", "heuristics"])
+
+
+class Reader:
+    def __init__(self, data, pos=0):
+        self.data = data
+        self.pos = pos
+
+    def at_end(self):
+        return self.pos >= len(self.data)
+
+    def read_bytes(self, size):
+        if self.pos + size > len(self.data):
+            raise ValueError("unexpected end of sample data")
+        result = self.data[self.pos:self.pos + size]
+        self.pos += size
+        return result
+
+    def read_byte(self):
+        return self.read_bytes(1)[0]
+
+    def read_uint(self, size):
+        return int.from_bytes(self.read_bytes(size), "little")
+
+    def read_varint(self):
+        value = 0
+        shift = 0
+        while True:
+            byte = self.read_byte()
+            value |= (byte & 0x7F) << shift
+            if byte < 0x80:
+                return value
+            shift += 7
+
+    def read_signed_varint(self):
+        value = self.read_varint()
+        return (value >> 1) ^ -(value & 1)
+
+    def read_string(self):
+        return self.read_bytes(self.read_varint()).decode("utf-8")
+
+    def read_strings(self):
+        return [self.read_string() for _ in range(self.read_varint())]
+
+
+def read_header(reader):
+    if reader.read_bytes(len(MAGIC_WORD)) != MAGIC_WORD:
+        raise ValueError("not a binary sample chunk at offset %d" %
+                         (reader.pos - len(MAGIC_WORD)))
+    version = reader.read_varint()
+    if version != VERSION:
+        raise ValueError("unsupported sample format version %d" % version)
+    fields = reader.read_varint()
+    compression = reader.read_varint()
+    sample_types = reader.read_strings()
+    heuristic_names = reader.read_strings()
+    num_bins = reader.read_varint()
+    variables = []
+    for _ in range(reader.read_varint()):
+        name = reader.read_string()
+        domain_size = reader.read_varint()
+        bin_index = reader.read_varint()
+        shift = reader.read_varint()
+        num_bits = reader.read_varint()
+        fact_names = [reader.read_string() for _ in range(domain_size)]
+        variables.append(Variable(
+            name, domain_size, bin_index, shift, num_bits, fact_names))
+    return Header(version, fields, compression, sample_types,
+                  heuristic_names, num_bins, variables)
+
+
+def read_state(reader, header):
+    bins = [reader.read_uint(4) for _ in range(header.num_bins)]
+    values = []
+    for var in header.variables:
+        value = (bins[var.bin_index] >> var.shift) & ((1 << var.num_bits) - 1)
+        values.append(None if value == var.domain_size else value)
+    return values
+
+
+def read_sample(reader, header):
+    sample_type = header.sample_types[reader.read_byte()]
+    modification_hash = reader.read_uint(8)
+    state = read_state(reader, header)
+    goal = second_state = operator_id = unsolved = None
+    if header.fields & FIELD_GOAL:
+        goal = read_state(reader, header)
+    if header.fields & FIELD_SECOND_STATE:
+        if reader.read_byte():
+            second_state = read_state(reader, header)
+    if header.fields & FIELD_ACTION:
+        # 0 marks a sample without operator.
+        operator_id = reader.read_varint() - 1
+        if operator_id == -1:
+            operator_id = None
+    if header.fields & FIELD_UNSOLVED:
+        unsolved = bool(reader.read_byte())
+    heuristics = [reader.read_signed_varint()
+                  for _ in range(reader.read_varint())]
+    return Sample(sample_type, modification_hash, state, goal, second_state,
+                  operator_id, unsolved, heuristics)
+
+
+def read_block(reader, header):
+    """Return the samples of the next block or None at the end marker."""
+    num_samples = reader.read_varint()
+    if num_samples == 0:
+        return None
+    raw_size = reader.read_varint()
+    stored_size = reader.read_varint()
+    data = reader.read_bytes(stored_size)
+    if header.compression == COMPRESSION_ZLIB:
+        data = zlib.decompress(data)
+    elif header.compression != COMPRESSION_NONE:
+        raise ValueError("unknown compression %d" % header.compression)
+    if len(data) != raw_size:
+        raise ValueError("block has %d bytes instead of %d" %
+                         (len(data), raw_size))
+    block_reader = Reader(data)
+    samples = []
+    for _ in range(num_samples):
+        sample_end = block_reader.read_varint()
+        sample_end += block_reader.pos
+        samples.append(read_sample(block_reader, header))
+        if block_reader.pos != sample_end:
+            raise ValueError("sample size does not match its content")
+    if not block_reader.at_end():
+        raise ValueError("block has more data than samples")
+    return samples
+
+
+def read_samples(path):
+    """Yield (header, sample) for all samples of all chunks of the file."""
+    with open(path, "rb") as f:
+        reader = Reader(f.read())
+    while not reader.at_end():
+        header = read_header(reader)
+        while True:
+            samples = read_block(reader, header)
+            if samples is None:
+                break
+            for sample in samples:
+                yield header, sample
+
+
+def state_to_facts(header, values):
+    return [var.fact_names[value]
+            for var, value in zip(header.variables, values)
+            if value is not None]
+
+
+def sample_to_json(header, sample, fact_names):
+    entry = sample._asdict()
+    entry["modification_hash"] = str(sample.modification_hash)
+    entry["heuristics"] = dict(zip(header.heuristic_names, sample.heuristics))
+    if fact_names:
+        for key in ["state", "goal", "second_state"]:
+            if entry[key] is not None:
+                entry[key] = state_to_facts(header, entry[key])
+    return json.dumps(entry)
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("sample_files", nargs="+")
+    parser.add_argument(
+        "--fact-names", action="store_true",
+        help="print states as lists of fact names instead of values")
+    return parser.parse_args()
+
+
+def main():
+    args = parse_args()
+    for path in args.sample_files:
+        try:
+            for header, sample in read_samples(path):
+                print(sample_to_json(header, sample, args.fact_names))
+        except ValueError as err:
+            sys.exit("%s: %s" % (path, err))
+
+
+if __name__ == "__main__":
+    main()
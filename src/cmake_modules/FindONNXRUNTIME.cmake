@@ -0,0 +1,71 @@
+# Find the ONNX Runtime package. This includes the library and include
+# files. Download a prebuilt release (onnxruntime-linux-x64-*.tgz) and point
+# PATH_ONNXRUNTIME to the extracted directory.
+#
+# This code defines the following variables:
+#
+#  ONNXRUNTIME_FOUND             - TRUE if all components are found.
+#  ONNXRUNTIME_INCLUDE_DIRS      - Full paths to all include dirs.
+#  ONNXRUNTIME_LIBRARIES         - Full paths to all libraries.
+#  ONNXRUNTIME_SUPPRESS_WARNINGS - Flag to ignore compiler warnings
+#
+# Example Usages:
+#  find_package(ONNXRUNTIME)
+#
+# The location of ONNXRUNTIME can be specified using the environment variable
+# or cmake parameter PATH_ONNXRUNTIME. If different installations
+# for release/debug versions are available, they can be specified with
+#   PATH_ONNXRUNTIME
+#   PATH_ONNXRUNTIME_RELEASE
+#   PATH_ONNXRUNTIME_DEBUG
+# More specific paths are preferred over less specific ones
+#
+# Note that the standard FIND_PACKAGE features are supported
+# (QUIET, REQUIRED, etc.).
+
+set(ONNXRUNTIME_SUPPRESS_WARNINGS "FLAG_SUPPRESS_WARNINGS")
+
+foreach(BUILDMODE "RELEASE" "DEBUG")
+    set(ONNXRUNTIME_HINT_PATHS_${BUILDMODE}
+        ${PATH_ONNXRUNTIME_${BUILDMODE}}
+        $ENV{PATH_ONNXRUNTIME_${BUILDMODE}}
+        ${PATH_ONNXRUNTIME}
+        $ENV{PATH_ONNXRUNTIME}
+    )
+endforeach()
+
+find_path(ONNXRUNTIME_INCLUDE_DIRS
+    NAMES onnxruntime_cxx_api.h
+    HINTS ${ONNXRUNTIME_HINT_PATHS_RELEASE} ${ONNXRUNTIME_HINT_PATHS_DEBUG}
+    PATH_SUFFIXES include include/onnxruntime
+                  include/onnxruntime/core/session
+)
+
+find_library(ONNXRUNTIME_LIBRARY_RELEASE
+    NAMES onnxruntime
+    HINTS ${ONNXRUNTIME_HINT_PATHS_RELEASE}
+    PATH_SUFFIXES lib lib64
+)
+
+find_library(ONNXRUNTIME_LIBRARY_DEBUG
+    NAMES onnxruntime
+    HINTS ${ONNXRUNTIME_HINT_PATHS_DEBUG}
+    PATH_SUFFIXES lib lib64
+)
+
+set(ONNXRUNTIME_LIBRARIES
+    optimized ${ONNXRUNTIME_LIBRARY_RELEASE}
+    debug ${ONNXRUNTIME_LIBRARY_DEBUG})
+
+# Check for consistency and handle arguments like QUIET, REQUIRED, etc.
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(
+    ONNXRUNTIME
+    REQUIRED_VARS ONNXRUNTIME_INCLUDE_DIRS ONNXRUNTIME_LIBRARY_RELEASE
+)
+
+# Do not show internal variables in cmake GUIs like ccmake.
+mark_as_advanced(ONNXRUNTIME_INCLUDE_DIRS
+                 ONNXRUNTIME_LIBRARY_RELEASE ONNXRUNTIME_LIBRARY_DEBUG
+                 ONNXRUNTIME_LIBRARIES
+                 ONNXRUNTIME_HINT_PATHS_RELEASE ONNXRUNTIME_HINT_PATHS_DEBUG)
@@ -53,6 +53,8 @@ fast_downward_plugin(
         abstract_task
         axioms
         command_line
+        concurrent_per_state_information
+        concurrent_state_registry
         evaluation_context
         evaluation_result
         evaluator
@@ -81,7 +83,7 @@ fast_downward_plugin(
         task_id
         task_proxy
 
-    DEPENDS CAUSAL_GRAPH INT_HASH_SET INT_PACKER ORDERED_SET SEGMENTED_VECTOR SUBSCRIBER SUCCESSOR_GENERATOR TASK_PROPERTIES
+    DEPENDS CAUSAL_GRAPH CONCURRENT_SEGMENTED_VECTOR INT_HASH_SET INT_PACKER ORDERED_SET SEGMENT_STORAGE SEGMENTED_VECTOR SUBSCRIBER SUCCESSOR_GENERATOR TASK_PROPERTIES
     CORE_PLUGIN
 )
 
@@ -109,6 +111,7 @@ fast_downward_plugin(
     NAME UTILS
     HELP "System utilities"
     SOURCES
+        utils/binary_io
         utils/collections
         utils/countdown_timer
         utils/distribution
@@ -143,6 +146,13 @@ fast_downward_plugin(
         open_lists/best_first_open_list
 )
 
+fast_downward_plugin(
+    NAME BUCKET_OPEN_LIST
+    HELP "Open lists for small integer values based on bucket arrays and radix heaps"
+    SOURCES
+        open_lists/bucket_open_list
+)
+
 fast_downward_plugin(
     NAME EPSILON_GREEDY_OPEN_LIST
     HELP "Open list that chooses an entry randomly with probability epsilon"
@@ -195,6 +205,22 @@ fast_downward_plugin(
     DEPENDENCY_ONLY
 )
 
+fast_downward_plugin(
+    NAME CONCURRENT_SEGMENTED_VECTOR
+    HELP "Segmented vector which several threads can grow at the same time"
+    SOURCES
+        algorithms/concurrent_segmented_vector
+    DEPENDENCY_ONLY
+)
+
+fast_downward_plugin(
+    NAME THREAD_POOL
+    HELP "Worker threads for data-parallel loops"
+    SOURCES
+        algorithms/thread_pool
+    DEPENDENCY_ONLY
+)
+
 fast_downward_plugin(
     NAME INT_HASH_SET
     HELP "Hash set storing non-negative integers"
@@ -235,6 +261,14 @@ fast_downward_plugin(
     DEPENDENCY_ONLY
 )
 
+fast_downward_plugin(
+    NAME SEGMENT_STORAGE
+    HELP "Segment allocation in RAM or a memory-mapped file"
+    SOURCES
+        algorithms/segment_storage
+    DEPENDENCY_ONLY
+)
+
 fast_downward_plugin(
     NAME SEGMENTED_VECTOR
     HELP "Memory-friendly and vector-like data structure"
@@ -405,6 +439,22 @@ fast_downward_plugin(
     DEPENDS EAGER_SEARCH SEARCH_COMMON
 )
 
+fast_downward_plugin(
+    NAME EXTERNAL_ASTAR
+    HELP "External memory A* with delayed duplicate detection"
+    SOURCES
+        search_engines/external_astar
+    DEPENDS SUCCESSOR_GENERATOR TASK_PROPERTIES
+)
+
+fast_downward_plugin(
+    NAME HDA_SEARCH
+    HELP "Hash distributed A* with shared memory threads"
+    SOURCES
+        search_engines/hda_search
+    DEPENDS SEARCH_COMMON SUCCESSOR_GENERATOR
+)
+
 fast_downward_plugin(
     NAME PLUGIN_LAZY
     HELP "Best-first search with deferred evaluation (lazy)"
@@ -458,6 +508,7 @@ fast_downward_plugin(
     NAME SAMPLING_SEARCH
     HELP "Sampling search algorithm"
     SOURCES
+        sampling_engines/binary_sample_format
         sampling_engines/sample_cache
         sampling_engines/sampling_engine
         sampling_engines/sampling_state_engine
@@ -465,6 +516,7 @@ fast_downward_plugin(
         sampling_engines/sampling_search_base
         sampling_engines/sampling_search_simple
         sampling_engines/sampling_v
+        sampling_engines/sampling_worker_pool
         sampling_engines/sampling_tasks
         sampling_engines/plugin_sampling.cc
     DEPENDS EXTRA_TASKS NULL_PRUNING_METHOD ORDERED_SET SAMPLING_TECHNIQUES
@@ -530,6 +582,31 @@ fast_downward_plugin(
 #       PACKAGES Torch
 #)
 
+#fast_downward_plugin(
+#       NAME ONNX_NETWORKS
+#       HELP "Networks using ONNX Runtime (CPU)"
+#       SOURCES
+#       neural_networks/onnx_network
+#       DEPENDS NEURAL_NETWORKS
+#       PACKAGES ONNXRUNTIME
+#)
+
+fast_downward_plugin(
+    NAME MLP_NETWORK
+    HELP "Multilayer perceptron networks evaluated without external libraries"
+    SOURCES
+        neural_networks/mlp_network
+    DEPENDS NEURAL_NETWORKS
+)
+
+fast_downward_plugin(
+    NAME CACHED_NETWORK
+    HELP "Cache for the outputs of networks shared across searches"
+    SOURCES
+        neural_networks/cached_network
+    DEPENDS NEURAL_NETWORKS
+)
+
 fast_downward_plugin(
     NAME NETWORK_HEURISTIC
     HELP "The network heuristic"
@@ -667,6 +744,7 @@ fast_downward_plugin(
         tasks/modified_init_goals_task
         tasks/modified_operator_costs_task
         tasks/partial_state_wrapper_task
+        tasks/replaceable_initial_state_task
     DEPENDS TASK_PROPERTIES
     DEPENDENCY_ONLY
 )
@@ -718,6 +796,7 @@ fast_downward_plugin(
     NAME SUCCESSOR_GENERATOR
     HELP "Successor generator"
     SOURCES
+        task_utils/bitset_operator_generator
         task_utils/operator_generator_factory
         task_utils/operator_generator_internals
         task_utils/successor_generator
@@ -806,7 +885,7 @@ fast_downward_plugin(
         merge_and_shrink/transition_system
         merge_and_shrink/types
         merge_and_shrink/utils
-    DEPENDS PRIORITY_QUEUES EQUIVALENCE_RELATION SCCS TASK_PROPERTIES VARIABLE_ORDER_FINDER
+    DEPENDS PRIORITY_QUEUES EQUIVALENCE_RELATION SCCS TASK_PROPERTIES THREAD_POOL VARIABLE_ORDER_FINDER
 )
 
 fast_downward_plugin(
@@ -847,6 +926,7 @@ fast_downward_plugin(
     SOURCES
         pdbs/canonical_pdbs
         pdbs/canonical_pdbs_heuristic
+        pdbs/distance_table
         pdbs/dominance_pruning
         pdbs/incremental_canonical_pdbs
         pdbs/match_tree
@@ -870,7 +950,7 @@ fast_downward_plugin(
         pdbs/validation
         pdbs/zero_one_pdbs
         pdbs/zero_one_pdbs_heuristic
-    DEPENDS CAUSAL_GRAPH MAX_CLIQUES PRIORITY_QUEUES SAMPLING SUCCESSOR_GENERATOR TASK_PROPERTIES VARIABLE_ORDER_FINDER
+    DEPENDS CAUSAL_GRAPH MAX_CLIQUES PRIORITY_QUEUES SAMPLING SUCCESSOR_GENERATOR TASK_PROPERTIES THREAD_POOL VARIABLE_ORDER_FINDER
 )
 
 fast_downward_plugin(
@@ -0,0 +1,107 @@
+#ifndef ALGORITHMS_CONCURRENT_SEGMENTED_VECTOR_H
+#define ALGORITHMS_CONCURRENT_SEGMENTED_VECTOR_H
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <memory>
+
+/*
+  ConcurrentSegmentedArrayVector is a variant of SegmentedArrayVector (see
+  segmented_vector.h) which several threads can use at the same time.
+
+  Other than SegmentedArrayVector, it has no size and no push_back. Instead,
+  the maximum number of arrays is fixed on construction and every index
+  below it can be accessed at any time. The segment of an index is allocated
+  by the first thread accessing it (and filled with the default value). If
+  two threads allocate the same segment simultaneously, the one which loses
+  the compare-and-swap frees its segment again. Segments are never moved, so
+  pointers to arrays stay valid until the vector is destroyed.
+
+  Only the allocation is synchronized. Threads accessing the same array have
+  to synchronize the access to its elements themselves.
+*/
+
+namespace concurrent_segmented_vector {
+template<class Element>
+class ConcurrentSegmentedArrayVector {
+    static const size_t SEGMENT_BYTES = 8192;
+
+    const size_t elements_per_array;
+    const size_t arrays_per_segment;
+    const size_t elements_per_segment;
+    const size_t num_segments;
+    const Element default_value;
+
+    std::unique_ptr<std::atomic<Element *>[]> segments;
+
+    size_t get_segment(size_t index) const {
+        return index / arrays_per_segment;
+    }
+
+    size_t get_offset(size_t index) const {
+        return (index % arrays_per_segment) * elements_per_array;
+    }
+
+    Element *get_or_allocate_segment(size_t segment) {
+        assert(segment < num_segments);
+        Element *data = segments[segment].load(std::memory_order_acquire);
+        if (!data) {
+            Element *new_data = new Element[elements_per_segment];
+            std::fill_n(new_data, elements_per_segment, default_value);
+            if (segments[segment].compare_exchange_strong(
+                    data, new_data, std::memory_order_acq_rel)) {
+                data = new_data;
+            } else {
+                // Another thread was faster; data now points to its segment.
+                delete[] new_data;
+            }
+        }
+        return data;
+    }
+
+public:
+    ConcurrentSegmentedArrayVector(
+        size_t elements_per_array_, size_t max_arrays,
+        const Element &default_value_ = Element())
+        : elements_per_array(elements_per_array_),
+          arrays_per_segment(
+              std::max(SEGMENT_BYTES / (elements_per_array * sizeof(Element)), size_t(1))),
+          elements_per_segment(elements_per_array * arrays_per_segment),
+          num_segments((max_arrays + arrays_per_segment - 1) / arrays_per_segment),
+          default_value(default_value_),
+          segments(new std::atomic<Element *>[num_segments]) {
+        for (size_t i = 0; i < num_segments; ++i) {
+            segments[i].store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    ~ConcurrentSegmentedArrayVector() {
+        for (size_t i = 0; i < num_segments; ++i) {
+            delete[] segments[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    ConcurrentSegmentedArrayVector(const ConcurrentSegmentedArrayVector &) = delete;
+    ConcurrentSegmentedArrayVector &operator=(const ConcurrentSegmentedArrayVector &) = delete;
+
+    Element *operator[](size_t index) {
+        return get_or_allocate_segment(get_segment(index)) + get_offset(index);
+    }
+
+    // The segment of the index must have been allocated before.
+    const Element *operator[](size_t index) const {
+        assert(get_segment(index) < num_segments);
+        const Element *data =
+            segments[get_segment(index)].load(std::memory_order_acquire);
+        assert(data);
+        return data + get_offset(index);
+    }
+
+    size_t get_max_size() const {
+        return num_segments * arrays_per_segment;
+    }
+};
+}
+
+#endif
@@ -292,6 +292,15 @@ public:
         return insert(key, hasher(key));
     }
 
+    /*
+      Return the key in the hash set which is equal to the given key, or -1
+      if there is none.
+    */
+    KeyType find(KeyType key) const {
+        assert(key >= 0);
+        return find_equal_key(key, hasher(key));
+    }
+
     void dump() const {
         int num_buckets = capacity();
         utils::g_log << "[";
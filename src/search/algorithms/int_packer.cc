@@ -62,6 +62,18 @@ public:
         Bin &bin = buffer[bin_index];
         bin = (bin & clear_mask) | (value << shift);
     }
+
+    int get_bin_index() const {
+        return bin_index;
+    }
+
+    int get_shift() const {
+        return shift;
+    }
+
+    int get_num_bits() const {
+        return get_bit_size_for_range(range);
+    }
 };
 
 
@@ -81,6 +93,18 @@ void IntPacker::set(Bin *buffer, int var, int value) const {
     var_infos[var].set(buffer, value);
 }
 
+int IntPacker::get_bin_index(int var) const {
+    return var_infos[var].get_bin_index();
+}
+
+int IntPacker::get_shift(int var) const {
+    return var_infos[var].get_shift();
+}
+
+int IntPacker::get_num_bits(int var) const {
+    return var_infos[var].get_num_bits();
+}
+
 void IntPacker::pack_bins(const vector<int> &ranges) {
     assert(var_infos.empty());
 
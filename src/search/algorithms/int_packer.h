@@ -43,6 +43,15 @@ public:
     void set(Bin *buffer, int var, int value) const;
 
     int get_num_bins() const {return num_bins;}
+
+    /*
+      Layout of a variable: its value is stored in the bits
+      [shift, shift + num_bits) of the bin with the given index. Use these to
+      decode packed data outside of the planner.
+    */
+    int get_bin_index(int var) const;
+    int get_shift(int var) const;
+    int get_num_bits(int var) const;
 };
 }
 
@@ -0,0 +1,151 @@
+#include "segment_storage.h"
+
+#include "../utils/logging.h"
+#include "../utils/system.h"
+
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace segment_storage {
+// Segments cut from a chunk are aligned to cache lines.
+static const size_t ALIGNMENT = 64;
+
+static size_t align(size_t bytes) {
+    return (bytes + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+SegmentStorage::SegmentStorage(
+    const string &directory, size_t ram_budget, size_t chunk_size)
+    : directory(directory),
+      ram_budget(ram_budget),
+      chunk_size(chunk_size),
+      fd(-1),
+      file_size(0),
+      chunk_offset(0),
+      ram_used(0),
+      mapped_used(0) {
+}
+
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+SegmentStorage::~SegmentStorage() {
+    for (const Chunk &chunk : chunks) {
+        munmap(chunk.data, chunk.size);
+    }
+    if (fd != -1) {
+        close(fd);
+    }
+}
+
+void SegmentStorage::open_file() {
+    string path = directory + "/downward-segments-XXXXXX";
+    vector<char> buffer(path.begin(), path.end());
+    buffer.push_back('\0');
+    fd = mkstemp(buffer.data());
+    if (fd == -1) {
+        cerr << "Could not create segment storage file in " << directory
+             << ": " << strerror(errno) << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+    }
+    // The file is removed as soon as it is closed.
+    unlink(buffer.data());
+    utils::g_log << "Segments exceeding " << (ram_budget >> 20)
+                 << " MiB are stored in " << directory << endl;
+}
+
+void SegmentStorage::add_chunk(size_t min_size) {
+    if (fd == -1) {
+        open_file();
+    }
+    size_t size = max(chunk_size, min_size);
+    if (ftruncate(fd, file_size + size) != 0) {
+        cerr << "Could not grow segment storage file: " << strerror(errno)
+             << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_OUT_OF_MEMORY);
+    }
+    void *data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                      fd, file_size);
+    if (data == MAP_FAILED) {
+        cerr << "Could not map segment storage file: " << strerror(errno)
+             << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_OUT_OF_MEMORY);
+    }
+    file_size += size;
+    chunks.push_back({static_cast<char *>(data), size});
+    chunk_offset = 0;
+}
+#else
+SegmentStorage::~SegmentStorage() {
+}
+
+void SegmentStorage::open_file() {
+    ABORT("File-backed segment storage is not supported on this platform.");
+}
+
+void SegmentStorage::add_chunk(size_t) {
+    open_file();
+}
+#endif
+
+void *SegmentStorage::allocate_mapped(size_t bytes) {
+    vector<void *> &free_segments = free_mapped_segments[bytes];
+    if (!free_segments.empty()) {
+        void *ptr = free_segments.back();
+        free_segments.pop_back();
+        return ptr;
+    }
+    size_t aligned_bytes = align(bytes);
+    if (chunks.empty() || chunk_offset + aligned_bytes > chunks.back().size) {
+        add_chunk(aligned_bytes);
+    }
+    void *ptr = chunks.back().data + chunk_offset;
+    chunk_offset += aligned_bytes;
+    return ptr;
+}
+
+bool SegmentStorage::is_mapped(const void *ptr) const {
+    const char *address = static_cast<const char *>(ptr);
+    for (const Chunk &chunk : chunks) {
+        if (address >= chunk.data && address < chunk.data + chunk.size) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void *SegmentStorage::allocate(size_t bytes) {
+    lock_guard<mutex> lock(storage_mutex);
+    if (ram_used + bytes <= ram_budget) {
+        ram_used += bytes;
+        return ::operator new(bytes);
+    }
+    mapped_used += bytes;
+    return allocate_mapped(bytes);
+}
+
+void SegmentStorage::deallocate(void *ptr, size_t bytes) {
+    lock_guard<mutex> lock(storage_mutex);
+    if (is_mapped(ptr)) {
+        mapped_used -= bytes;
+        free_mapped_segments[bytes].push_back(ptr);
+    } else {
+        assert(ram_used >= bytes);
+        ram_used -= bytes;
+        ::operator delete(ptr);
+    }
+}
+
+void SegmentStorage::print_statistics() const {
+    utils::g_log << "Segment storage: " << (ram_used >> 20) << " MiB in RAM, "
+                 << (mapped_used >> 20) << " MiB file-backed ("
+                 << (file_size >> 20) << " MiB file)" << endl;
+}
+}
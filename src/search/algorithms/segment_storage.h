@@ -0,0 +1,142 @@
+#ifndef ALGORITHMS_SEGMENT_STORAGE_H
+#define ALGORITHMS_SEGMENT_STORAGE_H
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/*
+  SegmentStorage provides the memory for the segments of SegmentedVector and
+  SegmentedArrayVector (via SegmentAllocator) if the data might not fit into
+  RAM.
+
+  The first ram_budget bytes are allocated as usual. All further segments are
+  placed in a memory-mapped file in the given directory (the file is deleted
+  on creation and vanishes with the process). The file is mapped in chunks of
+  chunk_size bytes from which the segments are cut. Pages of the file are
+  paged in and out by the operating system: recently used ("hot") segments
+  stay resident, while cold segments are written back to the file if
+  physical memory gets scarce. The mapping still counts against an address
+  space limit (RLIMIT_AS), but not against a data segment limit
+  (RLIMIT_DATA), which the driver uses when a storage is configured. Freed
+  file segments are reused for segments of the same size.
+
+  Thread-safe; file-backed storage is only supported on Linux and macOS.
+*/
+
+namespace segment_storage {
+class SegmentStorage {
+    struct Chunk {
+        char *data;
+        size_t size;
+    };
+
+    const std::string directory;
+    const size_t ram_budget;
+    const size_t chunk_size;
+
+    std::mutex storage_mutex;
+    int fd;
+    size_t file_size;
+    std::vector<Chunk> chunks;
+    // Bytes used in the last chunk.
+    size_t chunk_offset;
+    std::unordered_map<size_t, std::vector<void *>> free_mapped_segments;
+
+    size_t ram_used;
+    size_t mapped_used;
+
+    void open_file();
+    void add_chunk(size_t min_size);
+    void *allocate_mapped(size_t bytes);
+    bool is_mapped(const void *ptr) const;
+
+public:
+    SegmentStorage(
+        const std::string &directory, size_t ram_budget,
+        size_t chunk_size = 64 << 20);
+    ~SegmentStorage();
+
+    SegmentStorage(const SegmentStorage &) = delete;
+    SegmentStorage &operator=(const SegmentStorage &) = delete;
+
+    void *allocate(size_t bytes);
+    void deallocate(void *ptr, size_t bytes);
+
+    void print_statistics() const;
+};
+
+/*
+  Allocator using the given storage or the default heap allocation if the
+  storage is a null pointer.
+*/
+template<class T>
+class SegmentAllocator {
+    template<class U>
+    friend class SegmentAllocator;
+
+    std::shared_ptr<SegmentStorage> storage;
+public:
+    using value_type = T;
+
+    template<class U>
+    struct rebind {
+        using other = SegmentAllocator<U>;
+    };
+
+    SegmentAllocator(const std::shared_ptr<SegmentStorage> &storage = nullptr)
+        : storage(storage) {
+    }
+
+    template<class U>
+    SegmentAllocator(const SegmentAllocator<U> &other)
+        : storage(other.storage) {
+    }
+
+    T *allocate(size_t n) {
+        if (storage) {
+            return static_cast<T *>(storage->allocate(n * sizeof(T)));
+        }
+        return static_cast<T *>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T *ptr, size_t n) {
+        if (storage) {
+            storage->deallocate(ptr, n * sizeof(T));
+        } else {
+            ::operator delete(ptr);
+        }
+    }
+
+    template<class U, class ... Args>
+    void construct(U *ptr, Args && ... args) {
+        ::new(static_cast<void *>(ptr)) U(std::forward<Args>(args) ...);
+    }
+
+    template<class U>
+    void destroy(U *ptr) {
+        ptr->~U();
+    }
+
+    const std::shared_ptr<SegmentStorage> &get_storage() const {
+        return storage;
+    }
+
+    template<class U>
+    bool operator==(const SegmentAllocator<U> &other) const {
+        return storage == other.storage;
+    }
+
+    template<class U>
+    bool operator!=(const SegmentAllocator<U> &other) const {
+        return storage != other.storage;
+    }
+};
+}
+
+#endif
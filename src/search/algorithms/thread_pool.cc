@@ -0,0 +1,97 @@
+#include "thread_pool.h"
+
+#include <cassert>
+
+using namespace std;
+
+namespace thread_pool {
+ThreadPool::ThreadPool(int num_threads)
+    : generation(0),
+      num_finished_workers(0),
+      shutdown(false),
+      current_task(nullptr),
+      num_tasks(0),
+      next_task(0) {
+    assert(num_threads >= 1);
+    workers.reserve(num_threads - 1);
+    for (int i = 1; i < num_threads; ++i) {
+        workers.emplace_back(&ThreadPool::run_worker, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> lock(pool_mutex);
+        shutdown = true;
+    }
+    work_available.notify_all();
+    for (thread &worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::work_on_tasks(const function<void(int)> &task) {
+    while (true) {
+        int task_id = next_task.fetch_add(1, memory_order_relaxed);
+        if (task_id >= num_tasks) {
+            return;
+        }
+        task(task_id);
+    }
+}
+
+void ThreadPool::run_worker() {
+    int seen_generation = 0;
+    while (true) {
+        const function<void(int)> *task;
+        {
+            unique_lock<mutex> lock(pool_mutex);
+            work_available.wait(lock, [&]() {
+                                    return shutdown || generation != seen_generation;
+                                });
+            if (shutdown) {
+                return;
+            }
+            seen_generation = generation;
+            task = current_task;
+        }
+        work_on_tasks(*task);
+        bool last = false;
+        {
+            lock_guard<mutex> lock(pool_mutex);
+            last = (++num_finished_workers == static_cast<int>(workers.size()));
+        }
+        if (last) {
+            work_finished.notify_one();
+        }
+    }
+}
+
+void ThreadPool::run(int num_tasks_, const function<void(int)> &task) {
+    if (workers.empty() || num_tasks_ <= 1) {
+        for (int task_id = 0; task_id < num_tasks_; ++task_id) {
+            task(task_id);
+        }
+        return;
+    }
+    {
+        lock_guard<mutex> lock(pool_mutex);
+        current_task = &task;
+        num_tasks = num_tasks_;
+        next_task.store(0, memory_order_relaxed);
+        num_finished_workers = 0;
+        ++generation;
+    }
+    work_available.notify_all();
+    work_on_tasks(task);
+    /*
+      Wait until every worker has seen this generation. Otherwise, a late
+      worker could pick up the task of the next call of run.
+    */
+    unique_lock<mutex> lock(pool_mutex);
+    work_finished.wait(lock, [this]() {
+                           return num_finished_workers == static_cast<int>(workers.size());
+                       });
+    current_task = nullptr;
+}
+}
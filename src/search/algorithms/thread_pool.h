@@ -0,0 +1,57 @@
+#ifndef ALGORITHMS_THREAD_POOL_H
+#define ALGORITHMS_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+  A fixed set of worker threads for data-parallel loops. run(num_tasks, task)
+  calls task(i) for every i in [0, num_tasks) and returns when all calls are
+  finished. The calling thread takes part in the work, so a pool with a
+  single thread starts no threads at all and runs the tasks in order.
+
+  The task indices are handed out dynamically. Hence, tasks must not depend
+  on the order in which they are executed and must not throw. Results that
+  only depend on the task index (e.g. written to position i of a vector) are
+  independent of the number of threads.
+*/
+
+namespace thread_pool {
+class ThreadPool {
+    std::vector<std::thread> workers;
+
+    std::mutex pool_mutex;
+    std::condition_variable work_available;
+    std::condition_variable work_finished;
+    // Incremented for every call of run, so workers notice new work.
+    int generation;
+    int num_finished_workers;
+    bool shutdown;
+
+    const std::function<void(int)> *current_task;
+    int num_tasks;
+    std::atomic<int> next_task;
+
+    void work_on_tasks(const std::function<void(int)> &task);
+    void run_worker();
+
+public:
+    explicit ThreadPool(int num_threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    int get_num_threads() const {
+        return workers.size() + 1;
+    }
+
+    void run(int num_tasks, const std::function<void(int)> &task);
+};
+}
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef CONCURRENT_PER_STATE_INFORMATION_H
+#define CONCURRENT_PER_STATE_INFORMATION_H
+
+#include "concurrent_state_registry.h"
+
+#include "algorithms/concurrent_segmented_vector.h"
+
+#include <cassert>
+
+/*
+  ConcurrentPerStateInformation associates information with the states of
+  one ConcurrentStateRegistry, like PerStateInformation does for
+  StateRegistry. The entries grow with the registry: the storage for a
+  state is allocated (and set to the default value) by the first thread
+  accessing it, so threads can look up their states without a lock.
+
+  The object must not outlive its registry. Threads which access the entry
+  of the same state have to synchronize the access to the entry themselves.
+*/
+template<class Entry>
+class ConcurrentPerStateInformation {
+    const ConcurrentStateRegistry &registry;
+    // Looking up a state allocates its storage if needed, also if const.
+    mutable concurrent_segmented_vector::ConcurrentSegmentedArrayVector<Entry> entries;
+
+public:
+    explicit ConcurrentPerStateInformation(
+        const ConcurrentStateRegistry &registry,
+        const Entry &default_value = Entry())
+        : registry(registry),
+          entries(1, registry.get_capacity(), default_value) {
+    }
+
+    ConcurrentPerStateInformation(const ConcurrentPerStateInformation &) = delete;
+    ConcurrentPerStateInformation &operator=(const ConcurrentPerStateInformation &) = delete;
+
+    Entry &operator[](StateID id) {
+        assert(id.value >= 0 && id.value < registry.get_capacity());
+        return *entries[id.value];
+    }
+
+    const Entry &operator[](StateID id) const {
+        assert(id.value >= 0 && id.value < registry.get_capacity());
+        return *entries[id.value];
+    }
+};
+
+#endif
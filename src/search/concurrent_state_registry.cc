@@ -0,0 +1,169 @@
+#include "concurrent_state_registry.h"
+
+#include "axioms.h"
+
+#include "task_utils/task_properties.h"
+#include "utils/hash.h"
+#include "utils/logging.h"
+#include "utils/system.h"
+
+#include <thread>
+
+using namespace std;
+
+static const uint64_t ID_MASK = 0xFFFFFFFF;
+// ID part of a slot which is claimed but whose ID is not yet published.
+static const uint64_t BUSY = ID_MASK;
+
+static uint64_t get_table_size(int capacity) {
+    // Keep the load factor at most 1/2.
+    uint64_t size = 1;
+    while (size < 2 * static_cast<uint64_t>(capacity)) {
+        size *= 2;
+    }
+    return size;
+}
+
+ConcurrentStateRegistry::ConcurrentStateRegistry(
+    const TaskProxy &task_proxy, int capacity)
+    : task_proxy(task_proxy),
+      state_packer(task_properties::g_state_packers[task_proxy]),
+      axiom_evaluator(g_axiom_evaluators[task_proxy]),
+      num_bins(state_packer.get_num_bins()),
+      capacity(capacity),
+      state_data_pool(num_bins, capacity),
+      slots(new atomic<uint64_t>[get_table_size(capacity)]),
+      slot_mask(get_table_size(capacity) - 1),
+      num_states(0) {
+    for (uint64_t i = 0; i <= slot_mask; ++i) {
+        slots[i].store(0, memory_order_relaxed);
+    }
+}
+
+uint32_t ConcurrentStateRegistry::compute_hash(
+    const PackedStateBin *buffer) const {
+    utils::HashState hash_state;
+    for (int i = 0; i < num_bins; ++i) {
+        hash_state.feed(buffer[i]);
+    }
+    return hash_state.get_hash32();
+}
+
+void ConcurrentStateRegistry::exit_because_full() {
+    // Only the first thread reports the error and exits.
+    lock_guard<mutex> lock(full_mutex);
+    cerr << "Concurrent state registry is full (" << capacity << " states)."
+         << endl;
+    utils::exit_with(utils::ExitCode::SEARCH_OUT_OF_MEMORY);
+}
+
+pair<StateID, bool> ConcurrentStateRegistry::insert_packed_state(
+    const PackedStateBin *buffer) {
+    uint64_t hash = compute_hash(buffer);
+    uint64_t pos = hash & slot_mask;
+    for (uint64_t num_probes = 0; num_probes <= slot_mask; ++num_probes) {
+        uint64_t slot = slots[pos].load(memory_order_acquire);
+        if (slot == 0) {
+            uint64_t busy = (hash << 32) | BUSY;
+            if (slots[pos].compare_exchange_strong(
+                    slot, busy, memory_order_acq_rel)) {
+                int id = num_states.fetch_add(1, memory_order_relaxed);
+                if (id >= capacity) {
+                    exit_because_full();
+                }
+                copy(buffer, buffer + num_bins, state_data_pool[id]);
+                slots[pos].store((hash << 32) | (id + 1), memory_order_release);
+                return make_pair(StateID(id), true);
+            }
+            // Another thread claimed the slot; slot holds its content now.
+        }
+        if ((slot >> 32) == hash) {
+            while ((slot & ID_MASK) == BUSY) {
+                this_thread::yield();
+                slot = slots[pos].load(memory_order_acquire);
+            }
+            int id = static_cast<int>(slot & ID_MASK) - 1;
+            const PackedStateBin *data = state_data_pool[id];
+            if (equal(buffer, buffer + num_bins, data)) {
+                return make_pair(StateID(id), false);
+            }
+        }
+        pos = (pos + 1) & slot_mask;
+    }
+    exit_because_full();
+}
+
+pair<StateID, bool> ConcurrentStateRegistry::insert_state(
+    const vector<int> &values) {
+    assert(values.size() == task_proxy.get_variables().size());
+    vector<PackedStateBin> buffer(num_bins, 0);
+    for (size_t var = 0; var < values.size(); ++var) {
+        state_packer.set(buffer.data(), var, values[var]);
+    }
+    return insert_packed_state(buffer.data());
+}
+
+pair<StateID, bool> ConcurrentStateRegistry::get_successor_state(
+    StateID predecessor, const OperatorProxy &op) {
+    assert(!op.is_axiom());
+    if (task_properties::has_axioms(task_proxy)) {
+        vector<int> values = lookup_values(predecessor);
+        State state = task_proxy.create_state(vector<int>(values));
+        for (EffectProxy effect : op.get_effects()) {
+            if (does_fire(effect, state)) {
+                FactPair effect_pair = effect.get_fact().get_pair();
+                values[effect_pair.var] = effect_pair.value;
+            }
+        }
+        {
+            lock_guard<mutex> lock(axiom_mutex);
+            axiom_evaluator.evaluate(values);
+        }
+        return insert_state(values);
+    }
+
+    const PackedStateBin *predecessor_buffer = lookup_buffer(predecessor);
+    vector<PackedStateBin> buffer(
+        predecessor_buffer, predecessor_buffer + num_bins);
+    for (EffectProxy effect : op.get_effects()) {
+        bool fires = true;
+        for (FactProxy condition : effect.get_conditions()) {
+            FactPair condition_pair = condition.get_pair();
+            if (state_packer.get(predecessor_buffer, condition_pair.var) !=
+                condition_pair.value) {
+                fires = false;
+                break;
+            }
+        }
+        if (fires) {
+            FactPair effect_pair = effect.get_fact().get_pair();
+            state_packer.set(buffer.data(), effect_pair.var, effect_pair.value);
+        }
+    }
+    return insert_packed_state(buffer.data());
+}
+
+const PackedStateBin *ConcurrentStateRegistry::lookup_buffer(StateID id) const {
+    assert(id.value >= 0 && id.value < capacity);
+    return state_data_pool[id.value];
+}
+
+vector<int> ConcurrentStateRegistry::lookup_values(StateID id) const {
+    const PackedStateBin *buffer = lookup_buffer(id);
+    int num_variables = task_proxy.get_variables().size();
+    vector<int> values(num_variables);
+    for (int var = 0; var < num_variables; ++var) {
+        values[var] = state_packer.get(buffer, var);
+    }
+    return values;
+}
+
+int ConcurrentStateRegistry::get_state_size_in_bytes() const {
+    return num_bins * sizeof(PackedStateBin);
+}
+
+void ConcurrentStateRegistry::print_statistics() const {
+    utils::g_log << "Number of registered states: " << size() << endl;
+    utils::g_log << "Concurrent state registry capacity: " << capacity
+                 << " states, " << (slot_mask + 1) << " hash slots" << endl;
+}
@@ -0,0 +1,104 @@
+#ifndef CONCURRENT_STATE_REGISTRY_H
+#define CONCURRENT_STATE_REGISTRY_H
+
+#include "state_id.h"
+#include "state_registry.h"
+#include "task_proxy.h"
+
+#include "algorithms/concurrent_segmented_vector.h"
+#include "utils/system.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+class AxiomEvaluator;
+
+/*
+  ConcurrentStateRegistry is a variant of StateRegistry that several threads
+  can use at the same time without a global lock. HDA* (see hda_search.h)
+  uses it to share the duplicate detection between its threads.
+
+  The packed states are stored in a ConcurrentSegmentedArrayVector and
+  deduplicated by an open addressing hash set (linear probing) of 64-bit
+  slots. A slot holds the 32-bit hash of a state and its ID + 1. To insert
+  a state, a thread claims an empty slot with compare-and-swap, marking it
+  as busy, then takes the next ID (fetch_add), copies the packed data and
+  publishes the ID in the slot. Threads probing a busy slot with the same
+  hash wait until the ID is published. Thus, no state is stored twice and
+  IDs are dense.
+
+  Other than StateRegistry, the capacity is fixed on construction (the hash
+  set is never resized) and the registry does not create State objects,
+  because State and PerStateInformation are bound to StateRegistry. Use the
+  returned IDs with ConcurrentPerStateInformation and lookup_values to
+  create unregistered states, if needed.
+*/
+class ConcurrentStateRegistry {
+    TaskProxy task_proxy;
+    const int_packer::IntPacker &state_packer;
+    AxiomEvaluator &axiom_evaluator;
+    const int num_bins;
+    const int capacity;
+
+    concurrent_segmented_vector::ConcurrentSegmentedArrayVector<PackedStateBin>
+    state_data_pool;
+    std::unique_ptr<std::atomic<std::uint64_t>[]> slots;
+    const std::uint64_t slot_mask;
+    std::atomic<int> num_states;
+
+    // AxiomEvaluator is not thread-safe.
+    std::mutex axiom_mutex;
+    std::mutex full_mutex;
+
+    std::uint32_t compute_hash(const PackedStateBin *buffer) const;
+    NO_RETURN void exit_because_full();
+    std::pair<StateID, bool> insert_packed_state(const PackedStateBin *buffer);
+public:
+    ConcurrentStateRegistry(const TaskProxy &task_proxy, int capacity);
+
+    ConcurrentStateRegistry(const ConcurrentStateRegistry &) = delete;
+    ConcurrentStateRegistry &operator=(const ConcurrentStateRegistry &) = delete;
+
+    const TaskProxy &get_task_proxy() const {
+        return task_proxy;
+    }
+
+    int get_capacity() const {
+        return capacity;
+    }
+
+    /*
+      Registers the state with the given values (if this was not done
+      before) and returns its ID and whether it was new.
+    */
+    std::pair<StateID, bool> insert_state(const std::vector<int> &values);
+
+    /*
+      Registers the state resulting from applying op in the given registered
+      state (if this was not done before) and returns its ID and whether it
+      was new.
+    */
+    std::pair<StateID, bool> get_successor_state(
+        StateID predecessor, const OperatorProxy &op);
+
+    /*
+      The ID must be returned by this registry before (by this thread or a
+      thread which synchronized with the one which got the ID).
+    */
+    const PackedStateBin *lookup_buffer(StateID id) const;
+    std::vector<int> lookup_values(StateID id) const;
+
+    size_t size() const {
+        return num_states.load(std::memory_order_relaxed);
+    }
+
+    int get_state_size_in_bytes() const;
+
+    void print_statistics() const;
+};
+
+#endif
@@ -23,7 +23,9 @@ EvaluationContext::EvaluationContext(
       preferred(is_preferred),
       statistics(statistics),
       calculate_preferred(calculate_preferred),
-      report_confidence(report_confidence) {
+      report_confidence(report_confidence),
+      parent_id(StateID::no_state),
+      creating_operator(OperatorID::no_operator) {
 }
 
 
@@ -61,6 +63,16 @@ const EvaluationResult &EvaluationContext::get_result(Evaluator *evaluator) {
     return result;
 }
 
+void EvaluationContext::set_result(Evaluator *evaluator, EvaluationResult &&result) {
+    assert(!result.is_uninitialized());
+    if (statistics &&
+        evaluator->is_used_for_counting_evaluations() &&
+        result.get_count_evaluation()) {
+        statistics->inc_evaluations();
+    }
+    cache[evaluator] = move(result);
+}
+
 const PolicyResult &EvaluationContext::get_result(Policy *policy) {
     PolicyResult &result = policy_cache[policy];
     if (result.is_uninitialized()) {
@@ -132,3 +144,17 @@ bool EvaluationContext::get_calculate_preferred() const {
 bool EvaluationContext::get_report_confidence() const {
     return report_confidence;
 }
+
+void EvaluationContext::set_transition(
+    StateID parent_id, OperatorID creating_operator) {
+    this->parent_id = parent_id;
+    this->creating_operator = creating_operator;
+}
+
+StateID EvaluationContext::get_parent_id() const {
+    return parent_id;
+}
+
+OperatorID EvaluationContext::get_creating_operator() const {
+    return creating_operator;
+}
@@ -5,6 +5,7 @@
 #include "evaluator_cache.h"
 #include "policy_cache.h"
 #include "operator_id.h"
+#include "state_id.h"
 #include "task_proxy.h"
 
 #include <unordered_map>
@@ -50,6 +51,8 @@ class EvaluationContext {
     SearchStatistics *statistics;
     bool calculate_preferred;
     bool report_confidence;
+    StateID parent_id;
+    OperatorID creating_operator;
 
     static const int INVALID = -1;
 
@@ -97,6 +100,12 @@ public:
         bool report_confidence = false);
 
     const EvaluationResult &get_result(Evaluator *eval);
+    /*
+      Store a result that was computed outside of this context, e.g., by
+      evaluating many contexts at once with Evaluator::compute_results.
+      Later calls of get_result for this evaluator return the stored result.
+    */
+    void set_result(Evaluator *eval, EvaluationResult &&result);
     const PolicyResult &get_result(Policy *eval);
     const EvaluatorCache &get_cache() const;
     const State &get_state() const;
@@ -123,6 +132,15 @@ public:
     const std::vector<float> &get_operator_preferences(Policy *policy);
     bool get_calculate_preferred() const;
     bool get_report_confidence() const;
+
+    /*
+      Optionally record the transition which generated the state. Evaluators
+      may use it to derive their estimate from the parent (e.g., the MLP
+      network), but the estimate must not depend on it.
+    */
+    void set_transition(StateID parent_id, OperatorID creating_operator);
+    StateID get_parent_id() const;
+    OperatorID get_creating_operator() const;
 };
 
 #endif
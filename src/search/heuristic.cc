@@ -51,6 +51,15 @@ std::pair<int, double> Heuristic::compute_heuristic_and_confidence(const State &
     return {compute_heuristic(state), DEAD_END};
 }
 
+void Heuristic::compute_heuristics(
+    const vector<State> &ancestor_states, vector<int> &heuristics) {
+    heuristics.clear();
+    heuristics.reserve(ancestor_states.size());
+    for (const State &state : ancestor_states) {
+        heuristics.push_back(compute_heuristic(state));
+    }
+}
+
 EvaluationResult Heuristic::compute_result(EvaluationContext &eval_context) {
     EvaluationResult result;
 
@@ -63,7 +72,7 @@ EvaluationResult Heuristic::compute_result(EvaluationContext &eval_context) {
     int heuristic = NO_VALUE;
     double confidence = DEAD_END;
 
-    if (!report_confidence && !calculate_preferred && cache_evaluator_values &&
+    if (!report_confidence && !calculate_preferred && use_cache(state) &&
         heuristic_cache[state].h != NO_VALUE && !heuristic_cache[state].dirty) {
         heuristic = heuristic_cache[state].h;
         result.set_count_evaluation(false);
@@ -75,7 +84,7 @@ EvaluationResult Heuristic::compute_result(EvaluationContext &eval_context) {
         } else {
             heuristic = compute_heuristic(state);
         }
-        if (cache_evaluator_values) {
+        if (use_cache(state)) {
             heuristic_cache[state] = HEntry(heuristic, false);
         }
         result.set_count_evaluation(true);
@@ -113,6 +122,49 @@ EvaluationResult Heuristic::compute_result(EvaluationContext &eval_context) {
     return result;
 }
 
+vector<EvaluationResult> Heuristic::compute_results(
+    vector<EvaluationContext> &eval_contexts) {
+    vector<EvaluationResult> results(eval_contexts.size());
+    /*
+      Contexts which ask for preferred operators or confidences and cached
+      states are handled by compute_result, all others in one batch.
+    */
+    vector<size_t> batch_ids;
+    vector<State> batch_states;
+    for (size_t i = 0; i < eval_contexts.size(); ++i) {
+        EvaluationContext &eval_context = eval_contexts[i];
+        const State &state = eval_context.get_state();
+        if (eval_context.get_calculate_preferred() ||
+            eval_context.get_report_confidence() ||
+            (use_cache(state) && heuristic_cache[state].h != NO_VALUE &&
+             !heuristic_cache[state].dirty)) {
+            results[i] = compute_result(eval_context);
+        } else {
+            batch_ids.push_back(i);
+            batch_states.push_back(state);
+        }
+    }
+
+    vector<int> heuristics;
+    compute_heuristics(batch_states, heuristics);
+    assert(heuristics.size() == batch_states.size());
+    // Nobody asked for the preferred operators of these states.
+    preferred_operators.clear();
+    for (size_t i = 0; i < batch_ids.size(); ++i) {
+        int heuristic = heuristics[i];
+        assert(heuristic == DEAD_END || heuristic >= 0);
+        if (use_cache(batch_states[i])) {
+            heuristic_cache[batch_states[i]] = HEntry(heuristic, false);
+        }
+        EvaluationResult &result = results[batch_ids[i]];
+        result.set_count_evaluation(true);
+        result.set_evaluator_value(
+            heuristic == DEAD_END ? EvaluationResult::INFTY : heuristic);
+        result.set_confidence(DEAD_END);
+    }
+    return results;
+}
+
 bool Heuristic::does_cache_estimates() const {
     return cache_evaluator_values;
 }
@@ -46,13 +46,18 @@ protected:
     ordered_set::OrderedSet<OperatorID> preferred_operators;
     /*
       Cache for saving h values
-      Before accessing this cache always make sure that the cache_evaluator_values
-      flag is set to true - as soon as the cache is accessed it will create
-      entries for all existing states
+      Before accessing this cache always make sure that use_cache(state) is
+      true - as soon as the cache is accessed it will create entries for all
+      existing states
     */
     PerStateInformation<HEntry> heuristic_cache;
     bool cache_evaluator_values;
 
+    // States which are not registered (e.g. in HDA*) are never cached.
+    bool use_cache(const State &state) const {
+        return cache_evaluator_values && state.get_registry();
+    }
+
     // Hold a reference to the task implementation and pass it to objects that need it.
     const std::shared_ptr<AbstractTask> task;
     // Use task_proxy to access task information.
@@ -63,6 +68,13 @@ public:
 
     virtual int compute_heuristic(const State &ancestor_state) = 0;
     virtual std::pair<int, double> compute_heuristic_and_confidence(const State &state);
+    /*
+      Compute the heuristic values of several states at once. Used by
+      compute_results for the states without a cached value. The default
+      implementation calls compute_heuristic for each state.
+    */
+    virtual void compute_heuristics(
+        const std::vector<State> &ancestor_states, std::vector<int> &heuristics);
 
     /*
       Usage note: Marking the same operator as preferred multiple times
@@ -85,6 +97,8 @@ public:
 
     virtual EvaluationResult compute_result(
         EvaluationContext &eval_context) override;
+    virtual std::vector<EvaluationResult> compute_results(
+        std::vector<EvaluationContext> &eval_contexts) override;
 
     virtual bool does_cache_estimates() const override;
     virtual bool is_estimate_cached(const State &state) const override;
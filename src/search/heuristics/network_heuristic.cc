@@ -11,7 +11,9 @@ using namespace std;
 namespace network_heuristic {
 NetworkHeuristic::NetworkHeuristic(const Options &opts)
     : Heuristic(opts),
-      network(opts.get<shared_ptr<neural_networks::AbstractNetwork>>("network")) {
+      network(opts.get<shared_ptr<neural_networks::AbstractNetwork>>("network")),
+      current_parent_id(StateID::no_state),
+      current_creating_operator(OperatorID::no_operator) {
     cout << "Initializing network heuristic..." << endl;
     network->verify_heuristic();
     network->initialize();
@@ -24,7 +26,8 @@ int NetworkHeuristic::compute_heuristic(const State &state) {
     if (task_properties::is_goal_state(task_proxy, state)) {
         return 0;
     }
-    network->evaluate(state);
+    network->evaluate_successor(
+        state, current_parent_id, current_creating_operator);
     int h = network->get_heuristic();
 
     if (network->is_preferred()) {
@@ -44,12 +47,24 @@ std::pair<int, double> NetworkHeuristic::compute_heuristic_and_confidence(const
     return {h, confidence};
 }
 
+EvaluationResult NetworkHeuristic::compute_result(
+    EvaluationContext &eval_context) {
+    current_parent_id = eval_context.get_parent_id();
+    current_creating_operator = eval_context.get_creating_operator();
+    EvaluationResult result = Heuristic::compute_result(eval_context);
+    current_parent_id = StateID::no_state;
+    current_creating_operator = OperatorID::no_operator;
+    return result;
+}
+
 vector<EvaluationResult> NetworkHeuristic::compute_results(
         vector<EvaluationContext> &eval_contexts) {
     vector<EvaluationResult> results;
     results.reserve(eval_contexts.size());
 
     vector<State> eval_states;
+    vector<StateID> parent_ids;
+    vector<OperatorID> creating_operators;
     vector<int> old_heuristics;
     old_heuristics.reserve(eval_contexts.size());
 
@@ -57,21 +72,24 @@ vector<EvaluationResult> NetworkHeuristic::compute_results(
         const State &state = eval_contexts[idx_ec].get_state();
         bool calculate_preferred = eval_contexts[idx_ec].get_calculate_preferred();
 
-        if (!calculate_preferred && cache_evaluator_values &&
+        if (!calculate_preferred && use_cache(state) &&
             heuristic_cache[state].h != NO_VALUE && !heuristic_cache[state].dirty) {
             old_heuristics.push_back(heuristic_cache[state].h);
         } else if (!calculate_preferred && task_properties::is_goal_state(task_proxy, state)) {
             old_heuristics.push_back(0);
-            if (cache_evaluator_values) {
+            if (use_cache(state)) {
                 heuristic_cache[state] = HEntry(0, false);
             }
         } else {
             old_heuristics.push_back(NO_VALUE);
             eval_states.push_back(state);
+            parent_ids.push_back(eval_contexts[idx_ec].get_parent_id());
+            creating_operators.push_back(
+                eval_contexts[idx_ec].get_creating_operator());
         }
     }
 
-    network->evaluate(eval_states);
+    network->evaluate_successors(eval_states, parent_ids, creating_operators);
     size_t idx_evaluated_states = 0;
 
     for (size_t idx_ec = 0; idx_ec < eval_contexts.size(); ++idx_ec) {
@@ -79,7 +97,7 @@ vector<EvaluationResult> NetworkHeuristic::compute_results(
         int heuristic;
         if (old_heuristics[idx_ec] == NO_VALUE) {
             heuristic = network->get_heuristics()[idx_evaluated_states];
-            if (cache_evaluator_values) {
+            if (use_cache(eval_contexts[idx_ec].get_state())) {
                 heuristic_cache[eval_contexts[idx_ec].get_state()] =
                         HEntry(heuristic, false);
             }
@@ -12,6 +12,9 @@ namespace network_heuristic {
 class NetworkHeuristic : public Heuristic {
 protected:
     std::shared_ptr<neural_networks::AbstractNetwork> network;
+    // Transition which generated the state passed to compute_heuristic.
+    StateID current_parent_id;
+    OperatorID current_creating_operator;
 
     virtual int compute_heuristic(const State &ancestor_state) override;
     std::pair<int, double> compute_heuristic_and_confidence(const State &state) override;
@@ -21,6 +24,8 @@ public:
     explicit NetworkHeuristic(const options::Options &options);
     ~NetworkHeuristic();
     
+    virtual EvaluationResult compute_result(
+        EvaluationContext &eval_context) override;
     virtual std::vector<EvaluationResult> compute_results(
         std::vector<EvaluationContext> &eval_contexts) override;
 };
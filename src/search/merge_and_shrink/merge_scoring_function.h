@@ -6,6 +6,10 @@
 
 class TaskProxy;
 
+namespace thread_pool {
+class ThreadPool;
+}
+
 namespace merge_and_shrink {
 class FactoredTransitionSystem;
 class MergeScoringFunction {
@@ -16,9 +20,15 @@ protected:
 public:
     MergeScoringFunction();
     virtual ~MergeScoringFunction() = default;
+    /*
+      Scoring functions may score the candidates concurrently with the
+      threads of the given pool. The scores must not depend on the number
+      of threads.
+    */
     virtual std::vector<double> compute_scores(
         const FactoredTransitionSystem &fts,
-        const std::vector<std::pair<int, int>> &merge_candidates) = 0;
+        const std::vector<std::pair<int, int>> &merge_candidates,
+        thread_pool::ThreadPool &pool) = 0;
     virtual bool requires_init_distances() const = 0;
     virtual bool requires_goal_distances() const = 0;
 
@@ -9,6 +9,7 @@
 #include "../options/option_parser.h"
 #include "../options/plugin.h"
 
+#include "../algorithms/thread_pool.h"
 #include "../utils/markup.h"
 
 #include <cassert>
@@ -63,39 +64,49 @@ vector<int> MergeScoringFunctionDFP::compute_label_ranks(
 
 vector<double> MergeScoringFunctionDFP::compute_scores(
     const FactoredTransitionSystem &fts,
-    const vector<pair<int, int>> &merge_candidates) {
+    const vector<pair<int, int>> &merge_candidates,
+    thread_pool::ThreadPool &pool) {
     int num_ts = fts.get_size();
 
-    vector<vector<int>> transition_system_label_ranks(num_ts);
-    vector<double> scores;
-    scores.reserve(merge_candidates.size());
-
-    // Go over all pairs of transition systems and compute their weight.
+    // Compute the label ranks of all transition systems of the candidates.
+    vector<bool> is_candidate_ts(num_ts, false);
+    vector<int> candidate_ts_indices;
     for (pair<int, int> merge_candidate : merge_candidates) {
-        int ts_index1 = merge_candidate.first;
-        int ts_index2 = merge_candidate.second;
-
-        vector<int> &label_ranks1 = transition_system_label_ranks[ts_index1];
-        if (label_ranks1.empty()) {
-            label_ranks1 = compute_label_ranks(fts, ts_index1);
-        }
-        vector<int> &label_ranks2 = transition_system_label_ranks[ts_index2];
-        if (label_ranks2.empty()) {
-            label_ranks2 = compute_label_ranks(fts, ts_index2);
-        }
-        assert(label_ranks1.size() == label_ranks2.size());
-
-        // Compute the weight associated with this pair
-        int pair_weight = INF;
-        for (size_t i = 0; i < label_ranks1.size(); ++i) {
-            if (label_ranks1[i] != -1 && label_ranks2[i] != -1) {
-                // label is relevant in both transition_systems
-                int max_label_rank = max(label_ranks1[i], label_ranks2[i]);
-                pair_weight = min(pair_weight, max_label_rank);
+        for (int ts_index : {merge_candidate.first, merge_candidate.second}) {
+            if (!is_candidate_ts[ts_index]) {
+                is_candidate_ts[ts_index] = true;
+                candidate_ts_indices.push_back(ts_index);
             }
         }
-        scores.push_back(pair_weight);
     }
+    vector<vector<int>> transition_system_label_ranks(num_ts);
+    pool.run(candidate_ts_indices.size(), [&](int i) {
+                 int ts_index = candidate_ts_indices[i];
+                 transition_system_label_ranks[ts_index] =
+                     compute_label_ranks(fts, ts_index);
+             });
+
+    // Go over all pairs of transition systems and compute their weight.
+    vector<double> scores(merge_candidates.size());
+    pool.run(merge_candidates.size(), [&](int candidate_index) {
+                 pair<int, int> merge_candidate = merge_candidates[candidate_index];
+                 const vector<int> &label_ranks1 =
+                     transition_system_label_ranks[merge_candidate.first];
+                 const vector<int> &label_ranks2 =
+                     transition_system_label_ranks[merge_candidate.second];
+                 assert(label_ranks1.size() == label_ranks2.size());
+
+                 // Compute the weight associated with this pair
+                 int pair_weight = INF;
+                 for (size_t i = 0; i < label_ranks1.size(); ++i) {
+                     if (label_ranks1[i] != -1 && label_ranks2[i] != -1) {
+                         // label is relevant in both transition_systems
+                         int max_label_rank = max(label_ranks1[i], label_ranks2[i]);
+                         pair_weight = min(pair_weight, max_label_rank);
+                     }
+                 }
+                 scores[candidate_index] = pair_weight;
+             });
     return scores;
 }
 
@@ -7,20 +7,24 @@
 #include "../options/option_parser.h"
 #include "../options/plugin.h"
 
+#include "../algorithms/thread_pool.h"
+
 using namespace std;
 
 namespace merge_and_shrink {
 vector<double> MergeScoringFunctionGoalRelevance::compute_scores(
     const FactoredTransitionSystem &fts,
-    const vector<pair<int, int>> &merge_candidates) {
+    const vector<pair<int, int>> &merge_candidates,
+    thread_pool::ThreadPool &pool) {
     int num_ts = fts.get_size();
-    vector<bool> goal_relevant(num_ts, false);
-    for (int ts_index : fts) {
-        const TransitionSystem &ts = fts.get_transition_system(ts_index);
-        if (is_goal_relevant(ts)) {
-            goal_relevant[ts_index] = true;
-        }
-    }
+    // Not vector<bool>: threads write to different entries concurrently.
+    vector<char> goal_relevant(num_ts, false);
+    pool.run(num_ts, [&](int ts_index) {
+                 if (fts.is_active(ts_index) &&
+                     is_goal_relevant(fts.get_transition_system(ts_index))) {
+                     goal_relevant[ts_index] = true;
+                 }
+             });
 
     vector<double> scores;
     scores.reserve(merge_candidates.size());
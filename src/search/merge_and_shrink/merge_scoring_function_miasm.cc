@@ -11,6 +11,7 @@
 #include "../options/options.h"
 #include "../options/plugin.h"
 
+#include "../algorithms/thread_pool.h"
 #include "../utils/logging.h"
 #include "../utils/markup.h"
 
@@ -25,46 +26,61 @@ MergeScoringFunctionMIASM::MergeScoringFunctionMIASM(
       shrink_threshold_before_merge(options.get<int>("threshold_before_merge")) {
 }
 
-vector<double> MergeScoringFunctionMIASM::compute_scores(
-    const FactoredTransitionSystem &fts,
-    const vector<pair<int, int>> &merge_candidates) {
-    vector<double> scores;
-    scores.reserve(merge_candidates.size());
-    for (pair<int, int> merge_candidate : merge_candidates) {
-        int index1 = merge_candidate.first;
-        int index2 = merge_candidate.second;
-        unique_ptr<TransitionSystem> product = shrink_before_merge_externally(
-            fts,
-            index1,
-            index2,
-            *shrink_strategy,
-            max_states,
-            max_states_before_merge,
-            shrink_threshold_before_merge);
-
-        // Compute distances for the product and count the alive states.
-        unique_ptr<Distances> distances = utils::make_unique_ptr<Distances>(*product);
-        const bool compute_init_distances = true;
-        const bool compute_goal_distances = true;
-        const utils::Verbosity verbosity = utils::Verbosity::SILENT;
-        distances->compute_distances(compute_init_distances, compute_goal_distances, verbosity);
-        int num_states = product->get_size();
-        int alive_states_count = 0;
-        for (int state = 0; state < num_states; ++state) {
-            if (distances->get_init_distance(state) != INF &&
-                distances->get_goal_distance(state) != INF) {
-                ++alive_states_count;
-            }
+double MergeScoringFunctionMIASM::compute_score(
+    const FactoredTransitionSystem &fts, int index1, int index2) const {
+    unique_ptr<TransitionSystem> product = shrink_before_merge_externally(
+        fts,
+        index1,
+        index2,
+        *shrink_strategy,
+        max_states,
+        max_states_before_merge,
+        shrink_threshold_before_merge);
+
+    // Compute distances for the product and count the alive states.
+    unique_ptr<Distances> distances = utils::make_unique_ptr<Distances>(*product);
+    const bool compute_init_distances = true;
+    const bool compute_goal_distances = true;
+    const utils::Verbosity verbosity = utils::Verbosity::SILENT;
+    distances->compute_distances(compute_init_distances, compute_goal_distances, verbosity);
+    int num_states = product->get_size();
+    int alive_states_count = 0;
+    for (int state = 0; state < num_states; ++state) {
+        if (distances->get_init_distance(state) != INF &&
+            distances->get_goal_distance(state) != INF) {
+            ++alive_states_count;
         }
+    }
+
+    /*
+      Compute the score as the ratio of alive states of the product
+      compared to the number of states of the full product.
+    */
+    assert(num_states);
+    return static_cast<double>(alive_states_count) /
+           static_cast<double>(num_states);
+}
 
+vector<double> MergeScoringFunctionMIASM::compute_scores(
+    const FactoredTransitionSystem &fts,
+    const vector<pair<int, int>> &merge_candidates,
+    thread_pool::ThreadPool &pool) {
+    vector<double> scores(merge_candidates.size());
+    auto score_candidate = [&](int candidate_index) {
+            pair<int, int> merge_candidate = merge_candidates[candidate_index];
+            scores[candidate_index] = compute_score(
+                fts, merge_candidate.first, merge_candidate.second);
+        };
+    if (shrink_strategy->uses_random_numbers()) {
         /*
-          Compute the score as the ratio of alive states of the product
-          compared to the number of states of the full product.
+          The products are shrunk with random numbers, so we must compute
+          them in a fixed order to obtain the same scores in every run.
         */
-        assert(num_states);
-        double score = static_cast<double>(alive_states_count) /
-            static_cast<double>(num_states);
-        scores.push_back(score);
+        for (size_t i = 0; i < merge_candidates.size(); ++i) {
+            score_candidate(i);
+        }
+    } else {
+        pool.run(merge_candidates.size(), score_candidate);
     }
     return scores;
 }
@@ -16,6 +16,10 @@ class MergeScoringFunctionMIASM : public MergeScoringFunction {
     const int max_states;
     const int max_states_before_merge;
     const int shrink_threshold_before_merge;
+
+    // Shrink the product of the given transition systems and score it.
+    double compute_score(
+        const FactoredTransitionSystem &fts, int index1, int index2) const;
 protected:
     virtual std::string name() const override;
 public:
@@ -23,7 +27,8 @@ public:
     virtual ~MergeScoringFunctionMIASM() override = default;
     virtual std::vector<double> compute_scores(
         const FactoredTransitionSystem &fts,
-        const std::vector<std::pair<int, int>> &merge_candidates) override;
+        const std::vector<std::pair<int, int>> &merge_candidates,
+        thread_pool::ThreadPool &pool) override;
 
     virtual bool requires_init_distances() const override {
         return true;
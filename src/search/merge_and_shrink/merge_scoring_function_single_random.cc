@@ -23,7 +23,8 @@ MergeScoringFunctionSingleRandom::MergeScoringFunctionSingleRandom(
 
 vector<double> MergeScoringFunctionSingleRandom::compute_scores(
     const FactoredTransitionSystem &,
-    const vector<pair<int, int>> &merge_candidates) {
+    const vector<pair<int, int>> &merge_candidates,
+    thread_pool::ThreadPool &) {
     int chosen_index = (*rng)(merge_candidates.size());
     vector<double> scores;
     scores.reserve(merge_candidates.size());
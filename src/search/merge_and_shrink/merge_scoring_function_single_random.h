@@ -26,7 +26,8 @@ public:
     virtual ~MergeScoringFunctionSingleRandom() override = default;
     virtual std::vector<double> compute_scores(
         const FactoredTransitionSystem &fts,
-        const std::vector<std::pair<int, int>> &merge_candidates) override;
+        const std::vector<std::pair<int, int>> &merge_candidates,
+        thread_pool::ThreadPool &pool) override;
 
     virtual bool requires_init_distances() const override {
         return false;
@@ -30,7 +30,8 @@ MergeScoringFunctionTotalOrder::MergeScoringFunctionTotalOrder(
 
 vector<double> MergeScoringFunctionTotalOrder::compute_scores(
     const FactoredTransitionSystem &,
-    const vector<pair<int, int>> &merge_candidates) {
+    const vector<pair<int, int>> &merge_candidates,
+    thread_pool::ThreadPool &) {
     assert(initialized);
     vector<double> scores;
     scores.reserve(merge_candidates.size());
@@ -40,7 +40,8 @@ public:
     virtual ~MergeScoringFunctionTotalOrder() override = default;
     virtual std::vector<double> compute_scores(
         const FactoredTransitionSystem &fts,
-        const std::vector<std::pair<int, int>> &merge_candidates) override;
+        const std::vector<std::pair<int, int>> &merge_candidates,
+        thread_pool::ThreadPool &pool) override;
     virtual void initialize(const TaskProxy &task_proxy) override;
     static void add_options_to_parser(options::OptionParser &parser);
 
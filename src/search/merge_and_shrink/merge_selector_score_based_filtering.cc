@@ -7,6 +7,10 @@
 #include "../options/options.h"
 #include "../options/plugin.h"
 
+#include "../algorithms/thread_pool.h"
+#include "../utils/logging.h"
+#include "../utils/memory.h"
+
 #include <cassert>
 
 using namespace std;
@@ -16,7 +20,12 @@ MergeSelectorScoreBasedFiltering::MergeSelectorScoreBasedFiltering(
     const options::Options &options)
     : merge_scoring_functions(
           options.get_list<shared_ptr<MergeScoringFunction>>(
-              "scoring_functions")) {
+              "scoring_functions")),
+      pool(utils::make_unique_ptr<thread_pool::ThreadPool>(
+               options.get<int>("threads"))) {
+}
+
+MergeSelectorScoreBasedFiltering::~MergeSelectorScoreBasedFiltering() {
 }
 
 vector<pair<int, int>> MergeSelectorScoreBasedFiltering::get_remaining_candidates(
@@ -48,7 +57,7 @@ pair<int, int> MergeSelectorScoreBasedFiltering::select_merge(
     for (const shared_ptr<MergeScoringFunction> &scoring_function :
          merge_scoring_functions) {
         vector<double> scores = scoring_function->compute_scores(
-            fts, merge_candidates);
+            fts, merge_candidates, *pool);
         merge_candidates = get_remaining_candidates(merge_candidates, scores);
         if (merge_candidates.size() == 1) {
             break;
@@ -77,6 +86,7 @@ string MergeSelectorScoreBasedFiltering::name() const {
 }
 
 void MergeSelectorScoreBasedFiltering::dump_specific_options() const {
+    utils::g_log << "Number of threads: " << pool->get_num_threads() << endl;
     for (const shared_ptr<MergeScoringFunction> &scoring_function
          : merge_scoring_functions) {
         scoring_function->dump_options();
@@ -112,6 +122,12 @@ static shared_ptr<MergeSelector>_parse(options::OptionParser &parser) {
     parser.add_list_option<shared_ptr<MergeScoringFunction>>(
         "scoring_functions",
         "The list of scoring functions used to compute scores for candidates.");
+    parser.add_option<int>(
+        "threads",
+        "number of threads used to compute the scores of the merge "
+        "candidates. The selected merge does not depend on this number.",
+        "1",
+        options::Bounds("1", "infinity"));
 
     options::Options opts = parser.parse();
     if (parser.dry_run())
@@ -12,9 +12,15 @@ namespace options {
 class Options;
 }
 
+namespace thread_pool {
+class ThreadPool;
+}
+
 namespace merge_and_shrink {
 class MergeSelectorScoreBasedFiltering : public MergeSelector {
     std::vector<std::shared_ptr<MergeScoringFunction>> merge_scoring_functions;
+    // Used by the scoring functions to score the candidates concurrently.
+    std::unique_ptr<thread_pool::ThreadPool> pool;
 
     std::vector<std::pair<int, int>> get_remaining_candidates(
         const std::vector<std::pair<int, int>> &merge_candidates,
@@ -24,7 +30,7 @@ protected:
     virtual void dump_specific_options() const override;
 public:
     explicit MergeSelectorScoreBasedFiltering(const options::Options &options);
-    virtual ~MergeSelectorScoreBasedFiltering() override = default;
+    virtual ~MergeSelectorScoreBasedFiltering() override;
     virtual std::pair<int, int> select_merge(
         const FactoredTransitionSystem &fts,
         const std::vector<int> &indices_subset = std::vector<int>()) const override;
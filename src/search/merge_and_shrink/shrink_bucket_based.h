@@ -56,6 +56,9 @@ public:
         const TransitionSystem &ts,
         const Distances &distances,
         int target_size) const override;
+    virtual bool uses_random_numbers() const override {
+        return true;
+    }
     static void add_options_to_parser(options::OptionParser &parser);
 };
 }
@@ -38,6 +38,13 @@ public:
         int target_size) const = 0;
     virtual bool requires_init_distances() const = 0;
     virtual bool requires_goal_distances() const = 0;
+    /*
+      Strategies that use random numbers may not compute equivalence
+      relations concurrently, and their results depend on the call order.
+    */
+    virtual bool uses_random_numbers() const {
+        return false;
+    }
 
     void dump_options() const;
     std::string get_name() const;
@@ -20,6 +20,17 @@ OutputType get_output_type(const std::string &type) {
     }
 }
 
+void AbstractNetwork::evaluate_successor(
+    const State &state, StateID, OperatorID) {
+    evaluate(state);
+}
+
+void AbstractNetwork::evaluate_successors(
+    const vector<State> &states, const vector<StateID> &,
+    const vector<OperatorID> &) {
+    evaluate(states);
+}
+
 bool AbstractNetwork::is_heuristic() {
     return false;
 }
@@ -98,6 +109,12 @@ std::vector<float> &AbstractNetwork::get_operator_preferences() {
     utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
 }
 
+vector<vector<float>> &AbstractNetwork::get_operator_preferences_batch() {
+    cerr << "Network does not support preferred operator preferences." << endl
+         << "Terminating." << endl;
+    utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+}
+
 static PluginTypePlugin<AbstractNetwork> _type_plugin(
 "AbstractNetwork",
 // TODO: Replace empty string by synopsis for the wiki page.
@@ -46,7 +46,19 @@ public:
      * @param states
      */
     virtual void evaluate(const std::vector<State> &states) = 0;
-
+    /**
+     * Evaluate states whose parents and creating operators may be known
+     * (otherwise StateID::no_state and OperatorID::no_operator). Networks
+     * which can derive the evaluation of a successor from the evaluation of
+     * its parent override these methods. The results have to be the same as
+     * those of evaluate, which is called by default.
+     */
+    virtual void evaluate_successor(
+        const State &state, StateID parent_id, OperatorID op_id);
+    virtual void evaluate_successors(
+        const std::vector<State> &states,
+        const std::vector<StateID> &parent_ids,
+        const std::vector<OperatorID> &op_ids);
 
     virtual bool is_heuristic();
     void verify_heuristic();
@@ -63,6 +75,7 @@ public:
     virtual ordered_set::OrderedSet<OperatorID> &get_preferred();
     virtual std::vector<ordered_set::OrderedSet<OperatorID>> &get_preferreds();
     virtual std::vector<float> &get_operator_preferences();
+    virtual std::vector<std::vector<float>> &get_operator_preferences_batch();
 };
 
 
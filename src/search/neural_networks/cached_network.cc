@@ -0,0 +1,241 @@
+#include "cached_network.h"
+
+#include "../plugin.h"
+
+#include "../utils/logging.h"
+
+#include <cassert>
+
+using namespace std;
+namespace neural_networks {
+CachedNetwork::CachedNetwork(const Options &opts)
+    : AbstractNetwork(),
+      network(opts.get<shared_ptr<AbstractNetwork>>("network")),
+      max_entries(opts.get<int>("size")),
+      include_goal(opts.get<bool>("include_goal")) {
+}
+
+CachedNetwork::~CachedNetwork() {
+    print_statistics();
+}
+
+void CachedNetwork::initialize() {
+    network->initialize();
+}
+
+uint64_t CachedNetwork::compute_key(const State &state) const {
+    state.unpack();
+    utils::HashState hash_state;
+    utils::feed(hash_state, state.get_unpacked_values());
+    if (include_goal) {
+        for (FactProxy goal : state.get_task().get_goals()) {
+            utils::feed(hash_state, goal.get_pair().var);
+            utils::feed(hash_state, goal.get_pair().value);
+        }
+    }
+    return hash_state.get_hash64();
+}
+
+int CachedNetwork::lookup(uint64_t key) {
+    ++num_lookups;
+    if (num_lookups == next_report) {
+        print_statistics();
+        next_report *= 2;
+    }
+    auto iter = key_to_entry.find(key);
+    if (iter == key_to_entry.end()) {
+        return -1;
+    }
+    ++num_hits;
+    entries[iter->second].referenced = true;
+    return iter->second;
+}
+
+int CachedNetwork::insert(uint64_t key) {
+    auto iter = key_to_entry.find(key);
+    if (iter != key_to_entry.end()) {
+        return iter->second;
+    }
+    int index;
+    if (entries.size() < max_entries) {
+        index = entries.size();
+        entries.emplace_back();
+    } else {
+        // Give every referenced entry a second chance.
+        while (entries[clock_hand].referenced) {
+            entries[clock_hand].referenced = false;
+            clock_hand = (clock_hand + 1) % entries.size();
+        }
+        index = clock_hand;
+        clock_hand = (clock_hand + 1) % entries.size();
+        key_to_entry.erase(entries[index].key);
+    }
+    entries[index].key = key;
+    entries[index].referenced = false;
+    key_to_entry[key] = index;
+    return index;
+}
+
+void CachedNetwork::clear_output() {
+    last_h = Heuristic::NO_VALUE;
+    last_h_batch.clear();
+    last_h_confidence = Heuristic::DEAD_END;
+    last_h_confidence_batch.clear();
+    last_preferred.clear();
+    last_preferred_batch.clear();
+}
+
+void CachedNetwork::push_output(const Entry &entry) {
+    last_h = entry.heuristic;
+    last_h_batch.push_back(last_h);
+    last_h_confidence = entry.confidence;
+    last_h_confidence_batch.push_back(last_h_confidence);
+    last_preferred.clear();
+    for (OperatorID op_id : entry.preferred) {
+        last_preferred.insert(op_id);
+    }
+    last_preferred_batch.push_back(last_preferred);
+}
+
+void CachedNetwork::evaluate(const State &state) {
+    clear_output();
+    uint64_t key = compute_key(state);
+    int index = lookup(key);
+    if (index == -1) {
+        network->evaluate(state);
+        index = insert(key);
+        Entry &entry = entries[index];
+        entry.heuristic = network->is_heuristic() ?
+            network->get_heuristic() : Heuristic::NO_VALUE;
+        entry.confidence = network->is_heuristic_confidence() ?
+            network->get_heuristic_confidence() :
+            static_cast<double>(Heuristic::DEAD_END);
+        entry.preferred = network->is_preferred() ?
+            network->get_preferred().get_as_vector() : vector<OperatorID>();
+    }
+    push_output(entries[index]);
+}
+
+void CachedNetwork::evaluate(const vector<State> &states) {
+    clear_output();
+    vector<uint64_t> keys;
+    keys.reserve(states.size());
+    vector<State> missing_states;
+    vector<size_t> missing_positions;
+    for (size_t idx = 0; idx < states.size(); ++idx) {
+        keys.push_back(compute_key(states[idx]));
+        int index = lookup(keys.back());
+        if (index == -1) {
+            missing_states.push_back(states[idx]);
+            missing_positions.push_back(idx);
+            // Placeholder, the output is set below.
+            push_output(Entry());
+        } else {
+            push_output(entries[index]);
+        }
+    }
+    if (missing_states.empty()) {
+        return;
+    }
+
+    // Inserting evicts entries, thus, the outputs of the hits are copied first.
+    network->evaluate(missing_states);
+    for (size_t idx = 0; idx < missing_positions.size(); ++idx) {
+        size_t position = missing_positions[idx];
+        Entry &entry = entries[insert(keys[position])];
+        entry.heuristic = network->is_heuristic() ?
+            network->get_heuristics()[idx] : Heuristic::NO_VALUE;
+        entry.confidence = network->is_heuristic_confidence() ?
+            network->get_heuristic_confidences()[idx] :
+            static_cast<double>(Heuristic::DEAD_END);
+        entry.preferred = network->is_preferred() ?
+            network->get_preferreds()[idx].get_as_vector() :
+            vector<OperatorID>();
+        last_h_batch[position] = entry.heuristic;
+        last_h_confidence_batch[position] = entry.confidence;
+        last_preferred_batch[position].clear();
+        for (OperatorID op_id : entry.preferred) {
+            last_preferred_batch[position].insert(op_id);
+        }
+    }
+    last_h = last_h_batch.back();
+    last_h_confidence = last_h_confidence_batch.back();
+    last_preferred = last_preferred_batch.back();
+}
+
+void CachedNetwork::print_statistics() const {
+    utils::g_log << "Network cache: " << num_lookups << " lookups, "
+                 << num_hits << " hits ("
+                 << (num_lookups ? 100.0 * num_hits / num_lookups : 0.0)
+                 << "%), " << entries.size() << " entries" << endl;
+}
+
+bool CachedNetwork::is_heuristic() {
+    return network->is_heuristic();
+}
+
+int CachedNetwork::get_heuristic() {
+    return last_h;
+}
+
+const vector<int> &CachedNetwork::get_heuristics() {
+    return last_h_batch;
+}
+
+bool CachedNetwork::is_heuristic_confidence() {
+    return network->is_heuristic_confidence();
+}
+
+double CachedNetwork::get_heuristic_confidence() {
+    return last_h_confidence;
+}
+
+const vector<double> &CachedNetwork::get_heuristic_confidences() {
+    return last_h_confidence_batch;
+}
+
+bool CachedNetwork::is_preferred() {
+    return network->is_preferred();
+}
+
+ordered_set::OrderedSet<OperatorID> &CachedNetwork::get_preferred() {
+    return last_preferred;
+}
+
+vector<ordered_set::OrderedSet<OperatorID>> &CachedNetwork::get_preferreds() {
+    return last_preferred_batch;
+}
+}
+
+static shared_ptr<neural_networks::AbstractNetwork> _parse(OptionParser &parser) {
+    parser.document_synopsis(
+        "Cached Network",
+        "Caches the heuristic values, confidences, and preferred operators "
+        "of another network for a bounded number of states. The cache is "
+        "keyed by a fingerprint of the state and shared by all searches "
+        "which use this network object (e.g. all sampled tasks of a sampling "
+        "run as long as the network is not reloaded). Other network outputs "
+        "(e.g. operator preferences) are not available.");
+    parser.add_option<shared_ptr<neural_networks::AbstractNetwork>>(
+        "network", "Network whose outputs are cached.");
+    parser.add_option<int>(
+        "size",
+        "Maximum number of cached states.",
+        "1000000",
+        Bounds("1", "infinity"));
+    parser.add_option<bool>(
+        "include_goal",
+        "Use the goal of the task in addition to the state as key. Enable "
+        "this for networks which get the goal as input.",
+        "false");
+    Options opts = parser.parse();
+
+    shared_ptr<neural_networks::CachedNetwork> network;
+    if (!parser.dry_run()) {
+        network = make_shared<neural_networks::CachedNetwork>(opts);
+    }
+
+    return network;
+}
+
+static Plugin<neural_networks::AbstractNetwork> _plugin("cached_network", _parse);
@@ -0,0 +1,86 @@
+#ifndef NEURAL_NETWORKS_CACHED_NETWORK_H
+#define NEURAL_NETWORKS_CACHED_NETWORK_H
+
+#include "abstract_network.h"
+
+#include "../heuristic.h"
+#include "../option_parser.h"
+
+#include "../utils/hash.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace neural_networks {
+/**
+ * Caches the heuristic values, confidences, and preferred operators another
+ * network computes for a bounded number of states. Other than the
+ * heuristic cache of the evaluators, the cache is keyed by a 64-bit
+ * fingerprint of the state values (and optionally the goal) and not by the
+ * state id. Thus, it is shared by all searches using the same network object,
+ * e.g. across all tasks of a sampling run. If the network is reloaded, the
+ * cache is reloaded with it and starts empty.
+ *
+ * If the cache is full, an entry is replaced with the CLOCK algorithm (an
+ * approximation of least recently used).
+ */
+class CachedNetwork : public AbstractNetwork {
+    struct Entry {
+        std::uint64_t key;
+        bool referenced;
+        int heuristic;
+        double confidence;
+        std::vector<OperatorID> preferred;
+    };
+
+    const std::shared_ptr<AbstractNetwork> network;
+    const size_t max_entries;
+    const bool include_goal;
+
+    std::vector<Entry> entries;
+    utils::HashMap<std::uint64_t, int> key_to_entry;
+    size_t clock_hand = 0;
+
+    long long num_lookups = 0;
+    long long num_hits = 0;
+    long long next_report = 1 << 20;
+
+    int last_h = Heuristic::NO_VALUE;
+    std::vector<int> last_h_batch;
+    double last_h_confidence = Heuristic::DEAD_END;
+    std::vector<double> last_h_confidence_batch;
+    ordered_set::OrderedSet<OperatorID> last_preferred;
+    std::vector<ordered_set::OrderedSet<OperatorID>> last_preferred_batch;
+
+    std::uint64_t compute_key(const State &state) const;
+    // Return the index of the entry for the key or -1 if it is not cached.
+    int lookup(std::uint64_t key);
+    int insert(std::uint64_t key);
+    void clear_output();
+    void push_output(const Entry &entry);
+    void print_statistics() const;
+
+    virtual void initialize() override;
+    virtual void evaluate(const State &state) override;
+    virtual void evaluate(const std::vector<State> &states) override;
+
+public:
+    explicit CachedNetwork(const Options &opts);
+    CachedNetwork(const CachedNetwork &orig) = delete;
+    virtual ~CachedNetwork() override;
+
+    virtual bool is_heuristic() override;
+    virtual int get_heuristic() override;
+    virtual const std::vector<int> &get_heuristics() override;
+
+    virtual bool is_heuristic_confidence() override;
+    virtual double get_heuristic_confidence() override;
+    virtual const std::vector<double> &get_heuristic_confidences() override;
+
+    virtual bool is_preferred() override;
+    virtual ordered_set::OrderedSet<OperatorID> &get_preferred() override;
+    virtual std::vector<ordered_set::OrderedSet<OperatorID>> &get_preferreds() override;
+};
+}
+#endif /* NEURAL_NETWORKS_CACHED_NETWORK_H */
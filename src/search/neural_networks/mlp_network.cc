@@ -0,0 +1,493 @@
+#include "mlp_network.h"
+
+#include "../plugin.h"
+#include "../state_registry.h"
+
+#include "../utils/collections.h"
+#include "../utils/system.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+namespace neural_networks {
+/*
+  Multiversioning lets the loader choose the widest vector instructions the
+  CPU supports without compiling the whole planner for a specific CPU.
+*/
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) && defined(__linux__)
+#define MLP_KERNEL __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+#define MLP_KERNEL
+#endif
+
+// Stride of the rows of all weight and activation matrices (in floats).
+static const int SIMD_WIDTH = 16;
+// Number of states whose activations are computed together.
+static const int BLOCK_SIZE = 8;
+// Number of parents whose first layer sums are kept.
+static const size_t MAX_PARENT_SUMS = 8;
+
+// y += a * x
+MLP_KERNEL
+static void axpy(float *__restrict y, const float *__restrict x, float a, int n) {
+    for (int i = 0; i < n; ++i) {
+        y[i] += a * x[i];
+    }
+}
+
+// y += x
+MLP_KERNEL
+static void add(int32_t *__restrict y, const int32_t *__restrict x, int n) {
+    for (int i = 0; i < n; ++i) {
+        y[i] += x[i];
+    }
+}
+
+// y -= x
+MLP_KERNEL
+static void subtract(int32_t *__restrict y, const int32_t *__restrict x, int n) {
+    for (int i = 0; i < n; ++i) {
+        y[i] -= x[i];
+    }
+}
+
+// y = b + unit * x
+MLP_KERNEL
+static void from_fixed_point(
+    float *__restrict y, const float *__restrict b,
+    const int32_t *__restrict x, float unit, int n) {
+    for (int i = 0; i < n; ++i) {
+        y[i] = b[i] + unit * x[i];
+    }
+}
+
+static void activate(float *values, int n, Activation activation) {
+    switch (activation) {
+    case Activation::LINEAR:
+        break;
+    case Activation::RELU:
+        for (int i = 0; i < n; ++i) {
+            values[i] = max(values[i], 0.0f);
+        }
+        break;
+    case Activation::SIGMOID:
+        for (int i = 0; i < n; ++i) {
+            values[i] = 1.0f / (1.0f + exp(-values[i]));
+        }
+        break;
+    case Activation::TANH:
+        for (int i = 0; i < n; ++i) {
+            values[i] = tanh(values[i]);
+        }
+        break;
+    }
+}
+
+static Activation get_activation(const string &name) {
+    if (name == "linear") {
+        return Activation::LINEAR;
+    } else if (name == "relu") {
+        return Activation::RELU;
+    } else if (name == "sigmoid") {
+        return Activation::SIGMOID;
+    } else if (name == "tanh") {
+        return Activation::TANH;
+    }
+    cerr << "Unknown activation function: " << name << endl;
+    utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+}
+
+MLPNetwork::MLPNetwork(const Options &opts)
+    : AbstractNetwork(),
+      task(opts.get<shared_ptr<AbstractTask>>("transform")),
+      task_proxy(*task),
+      path(opts.get<string>("path")),
+      heuristic_shift(opts.get<int>("shift")),
+      heuristic_multiplier(opts.get<int>("multiplier")),
+      relevant_facts(get_fact_mapping(task.get(), opts.get_list<string>("facts"))),
+      default_input_values(get_default_inputs(opts.get_list<string>("defaults"))),
+      incremental(opts.get<bool>("incremental")) {
+    check_facts_and_default_inputs(relevant_facts, default_input_values);
+}
+
+void MLPNetwork::load(const string &path) {
+    ifstream file(path);
+    if (!file) {
+        cerr << "Model file does not exists: " << path << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+    }
+    stringstream content;
+    string line;
+    while (getline(file, line)) {
+        content << line.substr(0, line.find('#')) << '\n';
+    }
+
+    auto fail = [&path](const string &msg) {
+        cerr << "Invalid model file " << path << ": " << msg << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+    };
+    string keyword;
+    int num_inputs;
+    if (!(content >> keyword >> num_inputs) || keyword != "inputs" ||
+        num_inputs <= 0) {
+        fail("expected 'inputs <number of inputs>'");
+    }
+    while (content >> keyword) {
+        if (keyword != "layer") {
+            fail("expected 'layer', got '" + keyword + "'");
+        }
+        Layer layer;
+        string activation;
+        layer.num_inputs = layers.empty() ? num_inputs : layers.back().num_outputs;
+        if (!(content >> layer.num_outputs >> activation) ||
+            layer.num_outputs <= 0) {
+            fail("expected 'layer <number of outputs> <activation>'");
+        }
+        layer.activation = get_activation(activation);
+        layer.stride =
+            (layer.num_outputs + SIMD_WIDTH - 1) / SIMD_WIDTH * SIMD_WIDTH;
+        layer.weights.assign(layer.num_inputs * layer.stride, 0);
+        layer.biases.assign(layer.stride, 0);
+        for (int i = 0; i < layer.num_inputs; ++i) {
+            for (int j = 0; j < layer.num_outputs; ++j) {
+                if (!(content >> layer.weights[i * layer.stride + j])) {
+                    fail("not enough weights");
+                }
+            }
+        }
+        for (int j = 0; j < layer.num_outputs; ++j) {
+            if (!(content >> layer.biases[j])) {
+                fail("not enough biases");
+            }
+        }
+        layers.push_back(move(layer));
+    }
+    if (layers.empty()) {
+        fail("the network has no layers");
+    }
+    if (num_inputs != static_cast<int>(relevant_facts.size())) {
+        fail("the network has " + to_string(num_inputs) +
+             " inputs, but " + to_string(relevant_facts.size()) +
+             " facts are fed into it");
+    }
+}
+
+void MLPNetwork::initialize() {
+    if (is_initialized) {
+        return;
+    }
+    AbstractNetwork::initialize();
+    load(path);
+
+    Layer &first_layer = layers.front();
+    fact_to_input.resize(task_proxy.get_variables().size());
+    for (VariableProxy var : task_proxy.get_variables()) {
+        fact_to_input[var.get_id()].assign(var.get_domain_size(), -1);
+    }
+    for (size_t idx = 0; idx < relevant_facts.size(); ++idx) {
+        const FactPair &fp = relevant_facts[idx];
+        if (fp == FactPair::no_fact) {
+            // Inputs for facts missing in the task are constant.
+            axpy(first_layer.biases.data(),
+                 &first_layer.weights[idx * first_layer.stride],
+                 default_input_values[idx], first_layer.stride);
+        } else if (fact_to_input[fp.var][fp.value] != -1) {
+            cerr << "Fact given multiple times as network input: "
+                 << task->get_fact_name(fp) << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+        } else {
+            fact_to_input[fp.var][fp.value] = idx;
+        }
+    }
+    quantize_first_layer();
+    if (incremental) {
+        OperatorsProxy operators = task_proxy.get_operators();
+        operator_effect_vars.resize(operators.size());
+        for (OperatorProxy op : operators) {
+            vector<int> &vars = operator_effect_vars[op.get_id()];
+            for (EffectProxy effect : op.get_effects()) {
+                vars.push_back(effect.get_fact().get_variable().get_id());
+            }
+            utils::sort_unique(vars);
+        }
+        for (VariableProxy var : task_proxy.get_variables()) {
+            if (var.is_derived()) {
+                derived_vars.push_back(var.get_id());
+            }
+        }
+    }
+    int max_stride = 0;
+    for (const Layer &layer : layers) {
+        max_stride = max(max_stride, layer.stride);
+    }
+    activations.resize(BLOCK_SIZE * max_stride);
+    next_activations.resize(BLOCK_SIZE * max_stride);
+    sums.resize(first_layer.stride);
+    is_initialized = true;
+}
+
+/*
+  Choose the unit of the fixed point numbers as a power of two such that
+  the first layer sum of every state fits into 31 bits.
+*/
+void MLPNetwork::quantize_first_layer() {
+    const Layer &first_layer = layers.front();
+    int stride = first_layer.stride;
+    double max_sum = 0;
+    for (int j = 0; j < first_layer.num_outputs; ++j) {
+        double sum = 0;
+        for (const vector<int> &inputs : fact_to_input) {
+            float max_weight = 0;
+            for (int input : inputs) {
+                if (input != -1) {
+                    max_weight = max(
+                        max_weight, abs(first_layer.weights[input * stride + j]));
+                }
+            }
+            sum += max_weight;
+        }
+        max_sum = max(max_sum, sum);
+    }
+    int exponent = 0;
+    if (max_sum > 0) {
+        exponent = static_cast<int>(floor(log2(ldexp(1.0, 30) / max_sum)));
+        exponent = min(max(exponent, -100), 100);
+    }
+    double scale = ldexp(1.0, exponent);
+    fixed_point_unit = static_cast<float>(ldexp(1.0, -exponent));
+    fixed_point_weights.resize(first_layer.weights.size());
+    for (size_t i = 0; i < first_layer.weights.size(); ++i) {
+        fixed_point_weights[i] =
+            static_cast<int32_t>(llround(first_layer.weights[i] * scale));
+    }
+}
+
+void MLPNetwork::add_input(int var, int value, int32_t *out) const {
+    int input = fact_to_input[var][value];
+    if (input != -1) {
+        int stride = layers.front().stride;
+        add(out, &fixed_point_weights[input * stride], stride);
+    }
+}
+
+void MLPNetwork::subtract_input(int var, int value, int32_t *out) const {
+    int input = fact_to_input[var][value];
+    if (input != -1) {
+        int stride = layers.front().stride;
+        subtract(out, &fixed_point_weights[input * stride], stride);
+    }
+}
+
+void MLPNetwork::compute_sums(const vector<int> &values, int32_t *out) const {
+    fill(out, out + layers.front().stride, 0);
+    for (size_t var = 0; var < values.size(); ++var) {
+        add_input(var, values[var], out);
+    }
+}
+
+const MLPNetwork::ParentSums &MLPNetwork::get_parent_sums(
+    const State &state, StateID parent_id) {
+    const StateRegistry *registry = state.get_registry();
+    State parent_state = registry->lookup_state(parent_id);
+    size_t buffer_size =
+        registry->get_state_size_in_bytes() / sizeof(PackedStateBin);
+    const PackedStateBin *buffer = parent_state.get_buffer();
+    for (const ParentSums &parent : parent_sums) {
+        if (parent.registry == registry && parent.id == parent_id &&
+            parent.buffer.size() == buffer_size &&
+            memcmp(parent.buffer.data(), buffer,
+                   buffer_size * sizeof(PackedStateBin)) == 0) {
+            return parent;
+        }
+    }
+    if (parent_sums.size() < MAX_PARENT_SUMS) {
+        parent_sums.emplace_back();
+    }
+    ParentSums &parent = parent_sums[next_parent_sums];
+    next_parent_sums = (next_parent_sums + 1) % MAX_PARENT_SUMS;
+    parent.registry = registry;
+    parent.id = parent_id;
+    parent.buffer.assign(buffer, buffer + buffer_size);
+    parent_state.unpack();
+    parent.values = parent_state.get_unpacked_values();
+    parent.sums.resize(layers.front().stride);
+    compute_sums(parent.values, parent.sums.data());
+    return parent;
+}
+
+void MLPNetwork::compute_successor_sums(
+    const State &state, StateID parent_id, OperatorID op_id, int32_t *out) {
+    state.unpack();
+    const vector<int> &values = state.get_unpacked_values();
+    if (!incremental || parent_id == StateID::no_state ||
+        op_id == OperatorID::no_operator || !state.get_registry()) {
+        compute_sums(values, out);
+        return;
+    }
+    assert(utils::in_bounds(op_id.get_index(), operator_effect_vars));
+    const ParentSums &parent = get_parent_sums(state, parent_id);
+    copy(parent.sums.begin(), parent.sums.end(), out);
+    for (const vector<int> *vars :
+         {&operator_effect_vars[op_id.get_index()], &derived_vars}) {
+        for (int var : *vars) {
+            int old_value = parent.values[var];
+            if (old_value != values[var]) {
+                subtract_input(var, old_value, out);
+                add_input(var, values[var], out);
+            }
+        }
+    }
+}
+
+void MLPNetwork::evaluate_block(
+    const State *states, const StateID *parent_ids, const OperatorID *op_ids,
+    int num_states) {
+    assert(num_states <= BLOCK_SIZE);
+    // First layer: only sum up the weights of the true facts.
+    const Layer &first_layer = layers.front();
+    for (int b = 0; b < num_states; ++b) {
+        compute_successor_sums(
+            states[b], parent_ids ? parent_ids[b] : StateID::no_state,
+            op_ids ? op_ids[b] : OperatorID::no_operator, sums.data());
+        float *out = &activations[b * first_layer.stride];
+        from_fixed_point(out, first_layer.biases.data(), sums.data(),
+                         fixed_point_unit, first_layer.stride);
+        activate(out, first_layer.num_outputs, first_layer.activation);
+    }
+
+    /*
+      Dense layers: every row of the weight matrix is loaded once per block
+      and applied to all states of the block.
+    */
+    for (size_t l = 1; l < layers.size(); ++l) {
+        const Layer &prev = layers[l - 1];
+        const Layer &layer = layers[l];
+        for (int b = 0; b < num_states; ++b) {
+            copy(layer.biases.begin(), layer.biases.end(),
+                 &next_activations[b * layer.stride]);
+        }
+        for (int i = 0; i < layer.num_inputs; ++i) {
+            const float *row = &layer.weights[i * layer.stride];
+            for (int b = 0; b < num_states; ++b) {
+                float x = activations[b * prev.stride + i];
+                if (x != 0) {
+                    axpy(&next_activations[b * layer.stride], row, x,
+                         layer.stride);
+                }
+            }
+        }
+        for (int b = 0; b < num_states; ++b) {
+            activate(&next_activations[b * layer.stride], layer.num_outputs,
+                     layer.activation);
+        }
+        swap(activations, next_activations);
+    }
+
+    const Layer &last_layer = layers.back();
+    for (int b = 0; b < num_states; ++b) {
+        last_h = (activations[b * last_layer.stride] + heuristic_shift) *
+            heuristic_multiplier;
+        last_h_batch.push_back(last_h);
+    }
+}
+
+void MLPNetwork::evaluate(const State &state) {
+    evaluate_successor(state, StateID::no_state, OperatorID::no_operator);
+}
+
+void MLPNetwork::evaluate(const vector<State> &states) {
+    evaluate_successors(states, {}, {});
+}
+
+void MLPNetwork::evaluate_successor(
+    const State &state, StateID parent_id, OperatorID op_id) {
+    last_h_batch.clear();
+    evaluate_block(&state, &parent_id, &op_id, 1);
+}
+
+void MLPNetwork::evaluate_successors(
+    const vector<State> &states, const vector<StateID> &parent_ids,
+    const vector<OperatorID> &op_ids) {
+    assert(parent_ids.empty() || parent_ids.size() == states.size());
+    assert(op_ids.size() == parent_ids.size());
+    last_h = Heuristic::NO_VALUE;
+    last_h_batch.clear();
+    for (size_t start = 0; start < states.size(); start += BLOCK_SIZE) {
+        int num_states = min(states.size() - start,
+                             static_cast<size_t>(BLOCK_SIZE));
+        evaluate_block(
+            &states[start], parent_ids.empty() ? nullptr : &parent_ids[start],
+            op_ids.empty() ? nullptr : &op_ids[start], num_states);
+    }
+}
+
+bool MLPNetwork::is_heuristic() {
+    return true;
+}
+
+int MLPNetwork::get_heuristic() {
+    return last_h;
+}
+
+const vector<int> &MLPNetwork::get_heuristics() {
+    return last_h_batch;
+}
+}
+
+static shared_ptr<neural_networks::AbstractNetwork> _parse(OptionParser &parser) {
+    parser.document_synopsis(
+        "MLP Network",
+        "Evaluates a fully connected feed forward network on the Boolean fact "
+        "vector of a state without any external library. The first output "
+        "of the network is the heuristic value. See mlp_network.h for the "
+        "format of the model file.");
+    parser.add_option<string>("path", "Path to the model file.");
+    parser.add_option<shared_ptr<AbstractTask>>(
+        "transform",
+        "Optional task transformation for the network."
+        " Currently, adapt_costs(), sampling_transform(), and no_transform() are "
+        "available.",
+        "no_transform()");
+    parser.add_option<int>(
+        "shift",
+        "shift the predicted heuristic value (useful, if the model"
+        "output is expected to be negative up to a certain bound.", "0");
+    parser.add_option<int>(
+        "multiplier",
+        "Multiply the predicted (and shifted) heuristic value (useful, if "
+        "the model predicts small float values, but heuristics have to be "
+        "integers", "1");
+    parser.add_list_option<string>(
+        "facts",
+        "if the SAS facts after translation can differ from the facts"
+        "during training (e.g. some are pruned or their order changed),"
+        "provide here the order of facts during training.",
+        "[]");
+    parser.add_list_option<string>(
+        "defaults",
+        "Default values for the facts given in option 'facts'",
+        "[]");
+    parser.add_option<bool>(
+        "incremental",
+        "Derive the first layer of a successor from the first layer of its "
+        "parent by only updating the variables affected by the operator "
+        "(if the search passes the parent along). The heuristic values are "
+        "the same as without incremental evaluation.",
+        "true");
+    Options opts = parser.parse();
+
+    shared_ptr<neural_networks::MLPNetwork> network;
+    if (!parser.dry_run()) {
+        network = make_shared<neural_networks::MLPNetwork>(opts);
+    }
+
+    return network;
+}
+
+static Plugin<neural_networks::AbstractNetwork> _plugin("mlp_network", _parse);
@@ -0,0 +1,145 @@
+#ifndef NEURAL_NETWORKS_MLP_NETWORK_H
+#define NEURAL_NETWORKS_MLP_NETWORK_H
+
+#include "abstract_network.h"
+
+#include "../heuristic.h"
+#include "../option_parser.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace neural_networks {
+enum class Activation {
+    LINEAR,
+    RELU,
+    SIGMOID,
+    TANH
+};
+
+/**
+ * Fully connected feed forward network which is evaluated without any
+ * external library. The input is the Boolean fact vector of a state (as for
+ * the TorchStateNetwork) and the first output of the last layer is the
+ * heuristic value.
+ *
+ * The weights are loaded from a text file with the following
+ * whitespace-separated content ('#' starts a comment until the end of the
+ * line):
+ *
+ *   inputs <number of inputs>
+ *   layer <number of outputs> <linear|relu|sigmoid|tanh>
+ *   <weights> <biases>
+ *   layer ...
+ *
+ * The weights of a layer are given input by input, i.e. all weights
+ * outgoing from the first input, then all outgoing from the second input,
+ * ... (this is the transposed weight matrix of torch.nn.Linear).
+ *
+ * As the input is a Boolean vector, the first layer only sums up the weights
+ * of the true facts (at most one per variable). The constant inputs of
+ * facts which do not exist in the task are folded into the biases while
+ * loading. The weights of the first layer are summed up as fixed point
+ * numbers, so the sum does not depend on the order of the additions.
+ *
+ * If incremental evaluation is enabled and the search passes the parent and
+ * the creating operator of a state (see EvaluationContext::set_transition),
+ * the first layer sum of the state is derived from the sum of its parent by
+ * only exchanging the weights of the variables the operator affects (and of
+ * the derived variables). The sums of the last few parents are kept, as the
+ * successors of a parent are evaluated after each other. Due to the fixed
+ * point arithmetic, the heuristic values are exactly the same as without
+ * incremental evaluation.
+ */
+class MLPNetwork : public AbstractNetwork {
+    struct Layer {
+        int num_inputs;
+        int num_outputs;
+        // num_outputs rounded up to a multiple of the SIMD width.
+        int stride;
+        Activation activation;
+        // num_inputs rows of length stride.
+        std::vector<float> weights;
+        std::vector<float> biases;
+    };
+
+    struct ParentSums {
+        const StateRegistry *registry;
+        StateID id;
+        // Packed state to detect reused IDs of a new registry.
+        std::vector<PackedStateBin> buffer;
+        std::vector<int> values;
+        std::vector<int32_t> sums;
+
+        ParentSums()
+            : registry(nullptr), id(StateID::no_state) {
+        }
+    };
+
+    const std::shared_ptr<AbstractTask> task;
+    TaskProxy task_proxy;
+    const std::string path;
+    const int heuristic_shift;
+    const int heuristic_multiplier;
+    const std::vector<FactPair> relevant_facts;
+    const std::vector<int> default_input_values;
+    const bool incremental;
+
+    std::vector<Layer> layers;
+    // Index of the network input for every fact or -1, if not an input.
+    std::vector<std::vector<int>> fact_to_input;
+    // First layer weights in fixed point (same layout as Layer::weights).
+    std::vector<int32_t> fixed_point_weights;
+    // Value of the unit of the fixed point numbers.
+    float fixed_point_unit;
+    // Variables affected by each operator and derived variables.
+    std::vector<std::vector<int>> operator_effect_vars;
+    std::vector<int> derived_vars;
+    bool is_initialized = false;
+
+    // Activations of the current block of states (one row per state).
+    std::vector<float> activations;
+    std::vector<float> next_activations;
+    std::vector<int32_t> sums;
+
+    // First layer sums of recently used parents (used as a ring buffer).
+    std::vector<ParentSums> parent_sums;
+    size_t next_parent_sums = 0;
+
+    int last_h = Heuristic::NO_VALUE;
+    std::vector<int> last_h_batch;
+
+    void load(const std::string &path);
+    void quantize_first_layer();
+    void add_input(int var, int value, int32_t *out) const;
+    void subtract_input(int var, int value, int32_t *out) const;
+    void compute_sums(const std::vector<int> &values, int32_t *out) const;
+    const ParentSums &get_parent_sums(const State &state, StateID parent_id);
+    void compute_successor_sums(
+        const State &state, StateID parent_id, OperatorID op_id, int32_t *out);
+    void evaluate_block(
+        const State *states, const StateID *parent_ids,
+        const OperatorID *op_ids, int num_states);
+
+    virtual void initialize() override;
+    virtual void evaluate(const State &state) override;
+    virtual void evaluate(const std::vector<State> &states) override;
+    virtual void evaluate_successor(
+        const State &state, StateID parent_id, OperatorID op_id) override;
+    virtual void evaluate_successors(
+        const std::vector<State> &states,
+        const std::vector<StateID> &parent_ids,
+        const std::vector<OperatorID> &op_ids) override;
+
+public:
+    explicit MLPNetwork(const Options &opts);
+    MLPNetwork(const MLPNetwork &orig) = delete;
+    virtual ~MLPNetwork() override = default;
+
+    virtual bool is_heuristic() override;
+    virtual int get_heuristic() override;
+    virtual const std::vector<int> &get_heuristics() override;
+};
+}
+#endif /* NEURAL_NETWORKS_MLP_NETWORK_H */
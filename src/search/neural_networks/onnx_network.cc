@@ -0,0 +1,347 @@
+#include "onnx_network.h"
+
+#include "../plugin.h"
+
+#include "../utils/memory.h"
+#include "../utils/system.h"
+
+#include <cassert>
+#include <cstdio>
+#include <iostream>
+
+using namespace std;
+namespace neural_networks {
+static Ort::Env &get_environment() {
+    static Ort::Env environment(ORT_LOGGING_LEVEL_WARNING, "fast-downward");
+    return environment;
+}
+
+static string get_output_name(const Options &opts, const string &key) {
+    string name = opts.get<string>(key);
+    return name == "none" ? "" : name;
+}
+
+static int get_output_index(
+    const vector<string> &output_names, const string &name) {
+    if (name.empty()) {
+        return -1;
+    }
+    for (size_t idx = 0; idx < output_names.size(); ++idx) {
+        if (output_names[idx] == name) {
+            return static_cast<int>(idx);
+        }
+    }
+    return -1;
+}
+
+OnnxNetwork::OnnxNetwork(const Options &opts)
+    : AbstractNetwork(),
+      task(opts.get<shared_ptr<AbstractTask>>("transform")),
+      task_proxy(*task),
+      path(opts.get<string>("path")),
+      intra_op_threads(opts.get<int>("threads")),
+      heuristic_output(get_output_name(opts, "heuristic_output")),
+      confidence_output(get_output_name(opts, "confidence_output")),
+      policy_output(get_output_name(opts, "policy_output")),
+      heuristic_shift(opts.get<int>("shift")),
+      heuristic_multiplier(opts.get<int>("multiplier")),
+      relevant_facts(get_fact_mapping(task.get(), opts.get_list<string>("facts"))),
+      default_input_values(get_default_inputs(opts.get_list<string>("defaults"))) {
+    check_facts_and_default_inputs(relevant_facts, default_input_values);
+    if (FILE *file = fopen(path.c_str(), "r")) {
+        fclose(file);
+    } else {
+        cerr << "Model file does not exists: " << path << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+    }
+    if (heuristic_output.empty() && confidence_output.empty() &&
+        policy_output.empty()) {
+        cerr << "The ONNX network requires at least one of heuristic_output, "
+                "confidence_output, and policy_output." << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+    }
+    // The network predicts a preference for EVERY operator.
+    for (OperatorProxy op : task_proxy.get_operators()) {
+        all_operators.insert(OperatorID(op.get_id()));
+    }
+}
+
+void OnnxNetwork::initialize() {
+    if (session) {
+        return;
+    }
+    AbstractNetwork::initialize();
+    Ort::SessionOptions session_options;
+    session_options.SetIntraOpNumThreads(intra_op_threads);
+    session_options.SetInterOpNumThreads(1);
+    session_options.SetExecutionMode(ExecutionMode::ORT_SEQUENTIAL);
+    session_options.SetGraphOptimizationLevel(
+        GraphOptimizationLevel::ORT_ENABLE_ALL);
+    try {
+        session = utils::make_unique_ptr<Ort::Session>(
+            get_environment(), path.c_str(), session_options);
+    } catch (const Ort::Exception &e) {
+        cerr << "Could not load ONNX model " << path << ": " << e.what()
+             << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+    }
+
+    Ort::AllocatorWithDefaultOptions allocator;
+    if (session->GetInputCount() != 1) {
+        cerr << "The ONNX network has to have exactly one input, but has "
+             << session->GetInputCount() << "." << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+    }
+    input_name = session->GetInputNameAllocated(0, allocator).get();
+
+    for (const string &name : {heuristic_output, confidence_output,
+                               policy_output}) {
+        if (name.empty() ||
+            get_output_index(output_names, name) != -1) {
+            continue;
+        }
+        bool found = false;
+        for (size_t idx = 0; idx < session->GetOutputCount(); ++idx) {
+            if (session->GetOutputNameAllocated(idx, allocator).get() == name) {
+                found = true;
+                break;
+            }
+        }
+        if (!found) {
+            cerr << "The ONNX network has no output named " << name << "."
+                 << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+        }
+        output_names.push_back(name);
+    }
+    heuristic_output_index = get_output_index(output_names, heuristic_output);
+    confidence_output_index = get_output_index(output_names, confidence_output);
+    policy_output_index = get_output_index(output_names, policy_output);
+}
+
+void OnnxNetwork::fill_input(const State &state, int batch_index) {
+    state.unpack();
+    const vector<int> &values = state.get_unpacked_values();
+    float *row = input_values.data() + batch_index * relevant_facts.size();
+    for (size_t idx = 0; idx < relevant_facts.size(); ++idx) {
+        const FactPair &fp = relevant_facts[idx];
+        if (fp == FactPair::no_fact) {
+            row[idx] = default_input_values[idx];
+        } else {
+            row[idx] = values[fp.var] == fp.value;
+        }
+    }
+}
+
+void OnnxNetwork::run(int batch_size) {
+    static const Ort::MemoryInfo memory_info =
+        Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+    const int64_t input_shape[] = {
+        batch_size, static_cast<int64_t>(relevant_facts.size())};
+    Ort::Value input = Ort::Value::CreateTensor<float>(
+        memory_info, input_values.data(),
+        batch_size * relevant_facts.size(), input_shape, 2);
+
+    const char *input_names[] = {input_name.c_str()};
+    vector<const char *> output_name_pointers;
+    for (const string &name : output_names) {
+        output_name_pointers.push_back(name.c_str());
+    }
+    vector<Ort::Value> outputs;
+    try {
+        outputs = session->Run(
+            Ort::RunOptions{nullptr}, input_names, &input, 1,
+            output_name_pointers.data(), output_name_pointers.size());
+    } catch (const Ort::Exception &e) {
+        cerr << "Evaluation of ONNX network failed: " << e.what() << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+    }
+
+    /* Every output has one row per state. Only the first column of the
+       heuristic and confidence outputs is used. */
+    auto get_row_size = [&outputs, batch_size](int output_index) {
+        size_t size = outputs[output_index].GetTensorTypeAndShapeInfo()
+            .GetElementCount();
+        assert(size % batch_size == 0);
+        return size / batch_size;
+    };
+    if (heuristic_output_index != -1) {
+        const float *data =
+            outputs[heuristic_output_index].GetTensorData<float>();
+        size_t row_size = get_row_size(heuristic_output_index);
+        for (int i = 0; i < batch_size; ++i) {
+            last_h = (data[i * row_size] + heuristic_shift) *
+                heuristic_multiplier;
+            last_h_batch.push_back(last_h);
+        }
+    }
+    if (confidence_output_index != -1) {
+        const float *data =
+            outputs[confidence_output_index].GetTensorData<float>();
+        size_t row_size = get_row_size(confidence_output_index);
+        for (int i = 0; i < batch_size; ++i) {
+            last_h_confidence = data[i * row_size];
+            last_h_confidence_batch.push_back(last_h_confidence);
+        }
+    }
+    if (policy_output_index != -1) {
+        const float *data =
+            outputs[policy_output_index].GetTensorData<float>();
+        size_t row_size = get_row_size(policy_output_index);
+        if (row_size != static_cast<size_t>(all_operators.size())) {
+            cerr << "The policy output of the ONNX network has " << row_size
+                 << " columns, but the task has " << all_operators.size()
+                 << " operators." << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+        }
+        for (int i = 0; i < batch_size; ++i) {
+            last_preferences_batch.emplace_back(
+                data + i * row_size, data + (i + 1) * row_size);
+            all_operators_batch.push_back(all_operators);
+        }
+        last_preferences = last_preferences_batch.back();
+    }
+}
+
+void OnnxNetwork::clear_output() {
+    last_h = Heuristic::NO_VALUE;
+    last_h_batch.clear();
+    last_h_confidence = Heuristic::DEAD_END;
+    last_h_confidence_batch.clear();
+    all_operators_batch.clear();
+    last_preferences.clear();
+    last_preferences_batch.clear();
+}
+
+void OnnxNetwork::evaluate(const State &state) {
+    clear_output();
+    input_values.resize(relevant_facts.size());
+    fill_input(state, 0);
+    run(1);
+}
+
+void OnnxNetwork::evaluate(const vector<State> &states) {
+    clear_output();
+    if (states.empty()) {
+        return;
+    }
+    input_values.resize(states.size() * relevant_facts.size());
+    for (size_t idx = 0; idx < states.size(); ++idx) {
+        fill_input(states[idx], idx);
+    }
+    run(states.size());
+}
+
+bool OnnxNetwork::is_heuristic() {
+    return !heuristic_output.empty();
+}
+
+int OnnxNetwork::get_heuristic() {
+    return last_h;
+}
+
+const vector<int> &OnnxNetwork::get_heuristics() {
+    return last_h_batch;
+}
+
+bool OnnxNetwork::is_heuristic_confidence() {
+    return !confidence_output.empty();
+}
+
+double OnnxNetwork::get_heuristic_confidence() {
+    return last_h_confidence;
+}
+
+const vector<double> &OnnxNetwork::get_heuristic_confidences() {
+    return last_h_confidence_batch;
+}
+
+bool OnnxNetwork::is_preferred() {
+    return !policy_output.empty();
+}
+
+ordered_set::OrderedSet<OperatorID> &OnnxNetwork::get_preferred() {
+    return all_operators;
+}
+
+vector<ordered_set::OrderedSet<OperatorID>> &OnnxNetwork::get_preferreds() {
+    return all_operators_batch;
+}
+
+vector<float> &OnnxNetwork::get_operator_preferences() {
+    return last_preferences;
+}
+
+vector<vector<float>> &OnnxNetwork::get_operator_preferences_batch() {
+    return last_preferences_batch;
+}
+}
+
+static shared_ptr<neural_networks::AbstractNetwork> _parse(OptionParser &parser) {
+    parser.document_synopsis(
+        "ONNX Network",
+        "Takes a trained model in the ONNX format and evaluates it with the "
+        "CPU execution provider of ONNX Runtime. The model has to have a "
+        "single float input of shape [batch size, number of facts]. Its "
+        "outputs are interpreted as heuristic values, heuristic confidences, "
+        "and/or operator preferences.");
+    parser.add_option<string>("path", "Path to the ONNX model file.");
+    parser.add_option<shared_ptr<AbstractTask>>(
+        "transform",
+        "Optional task transformation for the network."
+        " Currently, adapt_costs(), sampling_transform(), and no_transform() are "
+        "available.",
+        "no_transform()");
+    parser.add_option<int>(
+        "threads",
+        "Number of threads ONNX Runtime uses to evaluate a single operator "
+        "of the network. For small networks, a single thread has the lowest "
+        "latency.",
+        "1",
+        Bounds("1", "infinity"));
+    parser.add_option<string>(
+        "heuristic_output",
+        "Name of the output whose first column is the heuristic value or "
+        "none, if the network does not predict heuristic values.",
+        "none");
+    parser.add_option<string>(
+        "confidence_output",
+        "Name of the output whose first column is the confidence of the "
+        "heuristic value or none, if the network does not predict "
+        "confidences.",
+        "none");
+    parser.add_option<string>(
+        "policy_output",
+        "Name of the output which contains a preference for every operator "
+        "of the task or none, if the network is no policy.",
+        "none");
+    parser.add_option<int>(
+        "shift",
+        "shift the predicted heuristic value (useful, if the model"
+        "output is expected to be negative up to a certain bound.", "0");
+    parser.add_option<int>(
+        "multiplier",
+        "Multiply the predicted (and shifted) heuristic value (useful, if "
+        "the model predicts small float values, but heuristics have to be "
+        "integers", "1");
+    parser.add_list_option<string>(
+        "facts",
+        "if the SAS facts after translation can differ from the facts"
+        "during training (e.g. some are pruned or their order changed),"
+        "provide here the order of facts during training.",
+        "[]");
+    parser.add_list_option<string>(
+        "defaults",
+        "Default values for the facts given in option 'facts'",
+        "[]");
+    Options opts = parser.parse();
+
+    shared_ptr<neural_networks::OnnxNetwork> network;
+    if (!parser.dry_run()) {
+        network = make_shared<neural_networks::OnnxNetwork>(opts);
+    }
+
+    return network;
+}
+
+static Plugin<neural_networks::AbstractNetwork> _plugin("onnx_network", _parse);
@@ -0,0 +1,90 @@
+#ifndef NEURAL_NETWORKS_ONNX_NETWORK_H
+#define NEURAL_NETWORKS_ONNX_NETWORK_H
+
+#include "abstract_network.h"
+
+#include "../heuristic.h"
+#include "../option_parser.h"
+
+#include <onnxruntime_cxx_api.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace neural_networks {
+/**
+ * Network evaluated with the CPU execution provider of ONNX Runtime. The
+ * network has a single float input of shape {batch size, number of facts}
+ * which is filled like the input of the TorchStateNetwork. Its outputs are
+ * selected by name and interpreted as heuristic value, heuristic confidence
+ * and/or operator preferences (one column per operator). All networks of the
+ * planner share one ONNX Runtime environment, thus, only the first network
+ * pays for initializing the runtime.
+ */
+class OnnxNetwork : public AbstractNetwork {
+protected:
+    const std::shared_ptr<AbstractTask> task;
+    TaskProxy task_proxy;
+
+    /** Path to the stored model */
+    const std::string path;
+    /** Number of threads ONNX Runtime may use within one operator */
+    const int intra_op_threads;
+
+    const std::string heuristic_output;
+    const std::string confidence_output;
+    const std::string policy_output;
+    const int heuristic_shift;
+    const int heuristic_multiplier;
+    const std::vector<FactPair> relevant_facts;
+    const std::vector<int> default_input_values;
+
+    std::unique_ptr<Ort::Session> session;
+    std::string input_name;
+    /** Names of the requested outputs in the order of output_names */
+    std::vector<std::string> output_names;
+    int heuristic_output_index = -1;
+    int confidence_output_index = -1;
+    int policy_output_index = -1;
+    /** Reused input buffer of shape {batch size, number of facts} */
+    std::vector<float> input_values;
+
+    int last_h = Heuristic::NO_VALUE;
+    std::vector<int> last_h_batch;
+    double last_h_confidence = Heuristic::DEAD_END;
+    std::vector<double> last_h_confidence_batch;
+    ordered_set::OrderedSet<OperatorID> all_operators;
+    std::vector<ordered_set::OrderedSet<OperatorID>> all_operators_batch;
+    std::vector<float> last_preferences;
+    std::vector<std::vector<float>> last_preferences_batch;
+
+    void fill_input(const State &state, int batch_index);
+    void run(int batch_size);
+    void clear_output();
+
+    virtual void initialize() override;
+    virtual void evaluate(const State &state) override;
+    virtual void evaluate(const std::vector<State> &states) override;
+
+public:
+    explicit OnnxNetwork(const Options &opts);
+    OnnxNetwork(const OnnxNetwork &orig) = delete;
+    virtual ~OnnxNetwork() override = default;
+
+    virtual bool is_heuristic() override;
+    virtual int get_heuristic() override;
+    virtual const std::vector<int> &get_heuristics() override;
+
+    virtual bool is_heuristic_confidence() override;
+    virtual double get_heuristic_confidence() override;
+    virtual const std::vector<double> &get_heuristic_confidences() override;
+
+    virtual bool is_preferred() override;
+    virtual ordered_set::OrderedSet<OperatorID> &get_preferred() override;
+    virtual std::vector<ordered_set::OrderedSet<OperatorID>> &get_preferreds() override;
+    virtual std::vector<float> &get_operator_preferences() override;
+    virtual std::vector<std::vector<float>> &get_operator_preferences_batch() override;
+};
+}
+#endif /* NEURAL_NETWORKS_ONNX_NETWORK_H */
@@ -1,6 +1,7 @@
 #include "torch_network.h"
 
 #include <algorithm>
+#include <cassert>
 
 using namespace std;
 namespace neural_networks {
@@ -37,6 +38,7 @@ void TorchNetwork::initialize() {
 
 void TorchNetwork::evaluate(const State &state) {
     clear_output();
+    torch::NoGradGuard no_grad;
     vector<torch::jit::IValue> inputs;
     auto sample = get_input_tensors(state);
     inputs.insert(inputs.end(), sample.begin(), sample.end());
@@ -44,26 +46,34 @@ void TorchNetwork::evaluate(const State &state) {
 }
 
 void TorchNetwork::evaluate(const vector<State> &states) {
-    cerr << "Evaluating batches of samples is currently not working for Torch."
-         << endl;
-    utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
-
     clear_output();
+    if (states.empty()) {
+        return;
+    }
+    torch::NoGradGuard no_grad;
+    /*
+      Every state provides one tensor of shape {1, ...} per input slot of the
+      network. Collect them per slot and concatenate them along the first
+      dimension, s.t. a single forward pass evaluates the whole batch.
+    */
     vector<vector<at::Tensor>> samples;
-    for (auto &state : states) {
+    for (const State &state : states) {
         vector<at::Tensor> sample = get_input_tensors(state);
         if (samples.empty()) {
-            for (size_t i = 0; i < sample.size(); ++i) {
-                samples.push_back(vector<at::Tensor>(state.size()));
+            samples.resize(sample.size());
+            for (vector<at::Tensor> &slot : samples) {
+                slot.reserve(states.size());
             }
         }
-        for (size_t idx = 0; idx < sample.size(); ++idx){
-            samples[idx].push_back(sample[idx]);
+        assert(sample.size() == samples.size());
+        for (size_t idx = 0; idx < sample.size(); ++idx) {
+            samples[idx].push_back(move(sample[idx]));
         }
     }
     vector<torch::jit::IValue> inputs;
-    for (const vector<at::Tensor> &input: samples) {
-        inputs.push_back(torch::cat(input));
+    inputs.reserve(samples.size());
+    for (const vector<at::Tensor> &slot : samples) {
+        inputs.push_back(torch::cat(slot));
     }
     parse_output(module.forward(inputs));
 }
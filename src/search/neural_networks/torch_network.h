@@ -33,9 +33,10 @@ protected:
      */
     virtual std::vector<at::Tensor> get_input_tensors(const State &state) = 0;
     /**
-     * Parse the raw output of the network and process it.
-     * @param count Number of predictions of the network to extract (
-     * by default all)
+     * Parse the raw output of the network and process it. The output
+     * contains one row per evaluated state (in the order in which the states
+     * were given to evaluate).
+     * @param output raw output of the forward pass
      */
     virtual void parse_output(const torch::jit::IValue &output) = 0;
     virtual void clear_output() = 0;
@@ -35,14 +35,24 @@ namespace neural_networks {
     void TorchPolicyNetwork::parse_output(const torch::IValue &output) {
         at::Tensor tensor = output.toTensor();
         auto accessor = tensor.accessor<float, 2>();
-        for(int j = 0; j < accessor.size(1); j++) {
-            last_preferences.push_back(accessor[0][j]);
+        last_preferences_batch.reserve(accessor.size(0));
+        for (int i = 0; i < accessor.size(0); i++) {
+            vector<float> preferences;
+            preferences.reserve(accessor.size(1));
+            for (int j = 0; j < accessor.size(1); j++) {
+                preferences.push_back(accessor[i][j]);
+            }
+            assert(preferences.size() == (size_t) last_preferred.size());
+            last_preferences_batch.push_back(move(preferences));
+        }
+        if (!last_preferences_batch.empty()) {
+            last_preferences = last_preferences_batch.back();
         }
-        assert(last_preferences.size() == (size_t) last_preferred.size());
     }
 
     void TorchPolicyNetwork::clear_output() {
         last_preferences.clear();
+        last_preferences_batch.clear();
     }
 
     bool TorchPolicyNetwork::is_preferred() {
@@ -56,6 +66,10 @@ namespace neural_networks {
     std::vector<float> &TorchPolicyNetwork::get_operator_preferences() {
         return last_preferences;
     }
+
+    std::vector<std::vector<float>> &TorchPolicyNetwork::get_operator_preferences_batch() {
+        return last_preferences_batch;
+    }
 }
 
 static shared_ptr<neural_networks::AbstractNetwork> _parse(OptionParser &parser) {
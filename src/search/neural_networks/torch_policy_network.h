@@ -10,6 +10,7 @@ namespace neural_networks {
 
         ordered_set::OrderedSet<OperatorID> last_preferred;
         std::vector<float> last_preferences;
+        std::vector<std::vector<float>> last_preferences_batch;
 
         virtual std::vector<at::Tensor> get_input_tensors(const State &state) override;
         virtual void parse_output(const torch::jit::IValue &output) override;
@@ -20,6 +21,7 @@ namespace neural_networks {
         virtual bool is_preferred() override;
         virtual ordered_set::OrderedSet<OperatorID> &get_preferred() override;
         virtual std::vector<float> &get_operator_preferences() override;
+        virtual std::vector<std::vector<float>> &get_operator_preferences_batch() override;
     };
 
 }
@@ -0,0 +1,463 @@
+#include "bucket_open_list.h"
+
+#include "../evaluator.h"
+#include "../open_list.h"
+#include "../option_parser.h"
+#include "../plugin.h"
+
+#include "../utils/memory.h"
+#include "../utils/system.h"
+
+#include <cassert>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+namespace bucket_open_list {
+/*
+  FIFO queue which keeps its memory when it runs empty, so that a bucket
+  which is filled and emptied repeatedly only allocates once.
+*/
+template<class Value>
+class Fifo {
+    vector<Value> values;
+    size_t head;
+public:
+    Fifo() : head(0) {
+    }
+
+    void push(const Value &value) {
+        values.push_back(value);
+    }
+
+    Value pop() {
+        assert(!empty());
+        Value value = values[head++];
+        if (head == values.size())
+            clear();
+        return value;
+    }
+
+    bool empty() const {
+        return head == values.size();
+    }
+
+    void clear() {
+        values.clear();
+        head = 0;
+    }
+};
+
+/*
+  Dense array of FIFO buckets indexed by non-negative keys. No bucket below
+  min_key contains an element, so removing the minimum only has to scan
+  forward from the last minimum.
+*/
+template<class Value>
+class BucketQueue {
+    vector<Fifo<Value>> buckets;
+    size_t min_key;
+    int size;
+public:
+    BucketQueue() : min_key(0), size(0) {
+    }
+
+    void push(int key, const Value &value) {
+        assert(key >= 0);
+        size_t index = key;
+        if (index >= buckets.size())
+            buckets.resize(index + 1);
+        buckets[index].push(value);
+        if (size == 0 || index < min_key)
+            min_key = index;
+        ++size;
+    }
+
+    Value pop_min() {
+        assert(size > 0);
+        while (buckets[min_key].empty())
+            ++min_key;
+        --size;
+        return buckets[min_key].pop();
+    }
+
+    bool empty() const {
+        return size == 0;
+    }
+
+    void clear() {
+        for (Fifo<Value> &bucket : buckets)
+            bucket.clear();
+        min_key = 0;
+        size = 0;
+    }
+};
+
+
+static int get_key(EvaluationContext &eval_context, Evaluator *evaluator) {
+    int key = eval_context.get_evaluator_value(evaluator);
+    if (key < 0) {
+        cerr << "Bucket-based open lists only support non-negative "
+             << "evaluator values, but " << evaluator->get_description()
+             << " returned " << key << "." << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+    }
+    return key;
+}
+
+
+template<class Entry>
+class BucketOpenList : public OpenList<Entry> {
+    /*
+      Buckets indexed by the value of the first evaluator. Each of them
+      holds a bucket queue indexed by the value of the tie-breaking
+      evaluator (only key 0 is used if there is none). Bucket queues are
+      never shrunk, so their memory is reused.
+    */
+    vector<BucketQueue<Entry>> buckets;
+    size_t min_key;
+    int size;
+
+    shared_ptr<Evaluator> evaluator;
+    shared_ptr<Evaluator> tiebreaking_evaluator;
+
+protected:
+    virtual void do_insertion(EvaluationContext &eval_context,
+                              const Entry &entry) override;
+
+public:
+    explicit BucketOpenList(const Options &opts);
+    virtual ~BucketOpenList() override = default;
+
+    virtual Entry remove_min() override;
+    virtual bool empty() const override;
+    virtual void clear() override;
+    virtual void get_path_dependent_evaluators(set<Evaluator *> &evals) override;
+    virtual bool is_dead_end(
+        EvaluationContext &eval_context) const override;
+    virtual bool is_reliable_dead_end(
+        EvaluationContext &eval_context) const override;
+};
+
+
+template<class Entry>
+BucketOpenList<Entry>::BucketOpenList(const Options &opts)
+    : OpenList<Entry>(opts.get<bool>("pref_only")),
+      min_key(0),
+      size(0) {
+    vector<shared_ptr<Evaluator>> evals =
+        opts.get_list<shared_ptr<Evaluator>>("evals");
+    evaluator = evals[0];
+    if (evals.size() == 2)
+        tiebreaking_evaluator = evals[1];
+}
+
+template<class Entry>
+void BucketOpenList<Entry>::do_insertion(
+    EvaluationContext &eval_context, const Entry &entry) {
+    size_t key = get_key(eval_context, evaluator.get());
+    int tiebreaking_key = 0;
+    if (tiebreaking_evaluator)
+        tiebreaking_key = get_key(eval_context, tiebreaking_evaluator.get());
+    if (key >= buckets.size())
+        buckets.resize(key + 1);
+    buckets[key].push(tiebreaking_key, entry);
+    if (size == 0 || key < min_key)
+        min_key = key;
+    ++size;
+}
+
+template<class Entry>
+Entry BucketOpenList<Entry>::remove_min() {
+    assert(size > 0);
+    while (buckets[min_key].empty())
+        ++min_key;
+    --size;
+    return buckets[min_key].pop_min();
+}
+
+template<class Entry>
+bool BucketOpenList<Entry>::empty() const {
+    return size == 0;
+}
+
+template<class Entry>
+void BucketOpenList<Entry>::clear() {
+    for (BucketQueue<Entry> &bucket : buckets)
+        bucket.clear();
+    min_key = 0;
+    size = 0;
+}
+
+template<class Entry>
+void BucketOpenList<Entry>::get_path_dependent_evaluators(
+    set<Evaluator *> &evals) {
+    evaluator->get_path_dependent_evaluators(evals);
+    if (tiebreaking_evaluator)
+        tiebreaking_evaluator->get_path_dependent_evaluators(evals);
+}
+
+template<class Entry>
+bool BucketOpenList<Entry>::is_dead_end(
+    EvaluationContext &eval_context) const {
+    // Infinite values cannot be stored in a bucket.
+    return eval_context.is_evaluator_value_infinite(evaluator.get()) ||
+           (tiebreaking_evaluator &&
+            eval_context.is_evaluator_value_infinite(
+                tiebreaking_evaluator.get()));
+}
+
+template<class Entry>
+bool BucketOpenList<Entry>::is_reliable_dead_end(
+    EvaluationContext &eval_context) const {
+    if (eval_context.is_evaluator_value_infinite(evaluator.get()) &&
+        evaluator->dead_ends_are_reliable())
+        return true;
+    if (tiebreaking_evaluator &&
+        eval_context.is_evaluator_value_infinite(tiebreaking_evaluator.get()) &&
+        tiebreaking_evaluator->dead_ends_are_reliable())
+        return true;
+    return false;
+}
+
+
+/*
+  Radix heap: every element is stored in bucket i > 0 if the highest bit in
+  which its key differs from last_key is bit i - 1. Elements with key
+  last_key are stored in the FIFO "current". If current runs empty, the
+  smallest non-empty bucket is redistributed relative to its minimum key.
+  Since every element moves to a lower bucket, each element is moved at most
+  32 times. Elements with equal keys always share a bucket and keep their
+  insertion order, which gives FIFO tie-breaking.
+*/
+template<class Entry>
+class RadixHeapOpenList : public OpenList<Entry> {
+    typedef pair<int, Entry> Element;
+    static const int NUM_BUCKETS = 33;
+
+    Fifo<Entry> current;
+    vector<vector<Element>> buckets;
+    int last_key;
+    int size;
+
+    shared_ptr<Evaluator> evaluator;
+
+    int get_bucket(int key) const;
+    void refill_current();
+
+protected:
+    virtual void do_insertion(EvaluationContext &eval_context,
+                              const Entry &entry) override;
+
+public:
+    explicit RadixHeapOpenList(const Options &opts);
+    virtual ~RadixHeapOpenList() override = default;
+
+    virtual Entry remove_min() override;
+    virtual bool empty() const override;
+    virtual void clear() override;
+    virtual void get_path_dependent_evaluators(set<Evaluator *> &evals) override;
+    virtual bool is_dead_end(
+        EvaluationContext &eval_context) const override;
+    virtual bool is_reliable_dead_end(
+        EvaluationContext &eval_context) const override;
+};
+
+
+template<class Entry>
+RadixHeapOpenList<Entry>::RadixHeapOpenList(const Options &opts)
+    : OpenList<Entry>(opts.get<bool>("pref_only")),
+      buckets(NUM_BUCKETS),
+      last_key(0),
+      size(0),
+      evaluator(opts.get<shared_ptr<Evaluator>>("eval")) {
+}
+
+template<class Entry>
+int RadixHeapOpenList<Entry>::get_bucket(int key) const {
+    assert(key > last_key);
+    unsigned int diff = static_cast<unsigned int>(key ^ last_key);
+    int bucket = 0;
+    while (diff) {
+        diff >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+template<class Entry>
+void RadixHeapOpenList<Entry>::refill_current() {
+    assert(current.empty());
+    int bucket = 1;
+    while (buckets[bucket].empty())
+        ++bucket;
+    vector<Element> &elements = buckets[bucket];
+    int min_key = elements[0].first;
+    for (const Element &element : elements)
+        min_key = min(min_key, element.first);
+    last_key = min_key;
+    for (const Element &element : elements) {
+        if (element.first == last_key)
+            current.push(element.second);
+        else
+            buckets[get_bucket(element.first)].push_back(element);
+    }
+    // Keep the capacity for later insertions.
+    elements.clear();
+}
+
+template<class Entry>
+void RadixHeapOpenList<Entry>::do_insertion(
+    EvaluationContext &eval_context, const Entry &entry) {
+    int key = get_key(eval_context, evaluator.get());
+    /*
+      Keys below last_key violate monotonicity. They are treated as if they
+      were equal to last_key, so they are removed next.
+    */
+    if (key <= last_key)
+        current.push(entry);
+    else
+        buckets[get_bucket(key)].emplace_back(key, entry);
+    ++size;
+}
+
+template<class Entry>
+Entry RadixHeapOpenList<Entry>::remove_min() {
+    assert(size > 0);
+    if (current.empty())
+        refill_current();
+    --size;
+    return current.pop();
+}
+
+template<class Entry>
+bool RadixHeapOpenList<Entry>::empty() const {
+    return size == 0;
+}
+
+template<class Entry>
+void RadixHeapOpenList<Entry>::clear() {
+    current.clear();
+    for (vector<Element> &bucket : buckets)
+        bucket.clear();
+    last_key = 0;
+    size = 0;
+}
+
+template<class Entry>
+void RadixHeapOpenList<Entry>::get_path_dependent_evaluators(
+    set<Evaluator *> &evals) {
+    evaluator->get_path_dependent_evaluators(evals);
+}
+
+template<class Entry>
+bool RadixHeapOpenList<Entry>::is_dead_end(
+    EvaluationContext &eval_context) const {
+    return eval_context.is_evaluator_value_infinite(evaluator.get());
+}
+
+template<class Entry>
+bool RadixHeapOpenList<Entry>::is_reliable_dead_end(
+    EvaluationContext &eval_context) const {
+    return is_dead_end(eval_context) && evaluator->dead_ends_are_reliable();
+}
+
+
+BucketOpenListFactory::BucketOpenListFactory(const Options &options)
+    : options(options) {
+}
+
+unique_ptr<StateOpenList>
+BucketOpenListFactory::create_state_open_list() {
+    return utils::make_unique_ptr<BucketOpenList<StateOpenListEntry>>(options);
+}
+
+unique_ptr<EdgeOpenList>
+BucketOpenListFactory::create_edge_open_list() {
+    return utils::make_unique_ptr<BucketOpenList<EdgeOpenListEntry>>(options);
+}
+
+RadixHeapOpenListFactory::RadixHeapOpenListFactory(const Options &options)
+    : options(options) {
+}
+
+unique_ptr<StateOpenList>
+RadixHeapOpenListFactory::create_state_open_list() {
+    return utils::make_unique_ptr<RadixHeapOpenList<StateOpenListEntry>>(options);
+}
+
+unique_ptr<EdgeOpenList>
+RadixHeapOpenListFactory::create_edge_open_list() {
+    return utils::make_unique_ptr<RadixHeapOpenList<EdgeOpenListEntry>>(options);
+}
+
+static shared_ptr<OpenListFactory> _parse_bucket(OptionParser &parser) {
+    parser.document_synopsis(
+        "Bucket open list",
+        "Open list for non-negative integer evaluator values with an "
+        "optional tie-breaking evaluator and FIFO tie-breaking otherwise.");
+    parser.document_note(
+        "Implementation Notes",
+        "Entries are stored in an array of buckets indexed by the value of "
+        "the first evaluator. If a second evaluator is given, each bucket is "
+        "again an array of buckets indexed by its value. Inserting an entry "
+        "takes constant time. Removing the minimum takes constant amortized "
+        "time if the minimum never decreases (as for f-values in A* with a "
+        "consistent heuristic) and otherwise time linear in the difference "
+        "of the keys. The memory needed is linear in the largest evaluator "
+        "value, so this open list is meant for small values (e.g., unit or "
+        "small action costs). States for which one of the evaluators is "
+        "infinite are pruned. Emptied buckets keep their memory.");
+    parser.add_list_option<shared_ptr<Evaluator>>(
+        "evals",
+        "evaluator and optional tie-breaking evaluator");
+    parser.add_option<bool>(
+        "pref_only",
+        "insert only nodes generated by preferred operators", "false");
+
+    Options opts = parser.parse();
+    if (parser.help_mode())
+        return nullptr;
+
+    opts.verify_list_non_empty<shared_ptr<Evaluator>>("evals");
+    if (opts.get_list<shared_ptr<Evaluator>>("evals").size() > 2)
+        parser.error("bucket open list supports at most two evaluators");
+    if (parser.dry_run())
+        return nullptr;
+    else
+        return make_shared<BucketOpenListFactory>(opts);
+}
+
+static shared_ptr<OpenListFactory> _parse_radix_heap(OptionParser &parser) {
+    parser.document_synopsis(
+        "Radix heap open list",
+        "Open list for monotone non-negative integer evaluator values, i.e., "
+        "values that are never smaller than the value of the last removed "
+        "entry, with FIFO tie-breaking.");
+    parser.document_note(
+        "Implementation Notes",
+        "Entries are stored in 33 buckets according to the highest bit in "
+        "which their value differs from the last removed value. Inserting "
+        "an entry takes constant time and removing the minimum takes "
+        "O(log C) amortized time, where C is the largest value. In contrast "
+        "to the bucket open list, memory does not depend on the magnitude of "
+        "the values. Entries whose value is smaller than the last removed "
+        "value are removed next, so the order is only exact for monotone "
+        "values, such as f-values in A* with a consistent heuristic.");
+    parser.add_option<shared_ptr<Evaluator>>("eval", "evaluator");
+    parser.add_option<bool>(
+        "pref_only",
+        "insert only nodes generated by preferred operators", "false");
+
+    Options opts = parser.parse();
+    if (parser.dry_run())
+        return nullptr;
+    else
+        return make_shared<RadixHeapOpenListFactory>(opts);
+}
+
+static Plugin<OpenListFactory> _plugin_bucket("bucket", _parse_bucket);
+static Plugin<OpenListFactory> _plugin_radix_heap(
+    "radix_heap", _parse_radix_heap);
+}
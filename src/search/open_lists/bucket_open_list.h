@@ -0,0 +1,44 @@
+#ifndef OPEN_LISTS_BUCKET_OPEN_LIST_H
+#define OPEN_LISTS_BUCKET_OPEN_LIST_H
+
+#include "../open_list_factory.h"
+#include "../option_parser_util.h"
+
+
+/*
+  Open lists for small non-negative integer keys with FIFO tie-breaking.
+
+  BucketOpenList stores a dense array of buckets indexed by the key of one
+  evaluator and optionally, within each bucket, a second dense array indexed
+  by the key of a tie-breaking evaluator.
+
+  RadixHeapOpenList is a radix heap (Ahuja et al., 1990) for monotone keys,
+  i.e., keys that are never smaller than the last removed key (for example,
+  f-values of A* with a consistent heuristic).
+
+  Both open lists keep the memory of emptied buckets for later insertions.
+*/
+
+namespace bucket_open_list {
+class BucketOpenListFactory : public OpenListFactory {
+    Options options;
+public:
+    explicit BucketOpenListFactory(const Options &options);
+    virtual ~BucketOpenListFactory() override = default;
+
+    virtual std::unique_ptr<StateOpenList> create_state_open_list() override;
+    virtual std::unique_ptr<EdgeOpenList> create_edge_open_list() override;
+};
+
+class RadixHeapOpenListFactory : public OpenListFactory {
+    Options options;
+public:
+    explicit RadixHeapOpenListFactory(const Options &options);
+    virtual ~RadixHeapOpenListFactory() override = default;
+
+    virtual std::unique_ptr<StateOpenList> create_state_open_list() override;
+    virtual std::unique_ptr<EdgeOpenList> create_edge_open_list() override;
+};
+}
+
+#endif
@@ -23,6 +23,8 @@ public:
         if (!redefine && predefined.count(key)) {
             throw OptionParserError(key + " is already used in a predefinition.");
         }
+        // Replace an existing definition of the key.
+        predefined.erase(key);
         predefined.emplace(key, std::make_pair(std::type_index(typeid(T)), object));
     }
 
@@ -10,35 +10,208 @@
 using namespace std;
 
 namespace pdbs {
+/*
+  As for the MLP network, the loader chooses the widest vector instructions
+  the CPU supports for the row additions.
+*/
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) && defined(__linux__)
+#define PDB_KERNEL __attribute__((target_clones("avx2", "default")))
+#else
+#define PDB_KERNEL
+#endif
+
+/*
+  The dense matrix is used if at least one in DENSE_MATRIX_DENSITY entries
+  is non-zero. Vectorized row additions are then cheaper than the scattered
+  additions of the non-zero entries.
+*/
+static const int DENSE_MATRIX_DENSITY = 8;
+
+// indices += value * row
+PDB_KERNEL
+static void add_scaled_row(
+    int *__restrict indices, const int *__restrict row, int value, int n) {
+    for (int i = 0; i < n; ++i) {
+        indices[i] += value * row[i];
+    }
+}
+
+template<DistanceFormat Format>
+static bool look_up_distances_in_format(
+    const vector<const uint8_t *> &table_data, int *values) {
+    bool is_dead_end = false;
+    int num_pdbs = table_data.size();
+    for (int pdb_id = 0; pdb_id < num_pdbs; ++pdb_id) {
+        int h = DistanceTable::decode<Format>(
+            table_data[pdb_id], values[pdb_id]);
+        is_dead_end |= (h == numeric_limits<int>::max());
+        values[pdb_id] = h;
+    }
+    return is_dead_end;
+}
+
 CanonicalPDBs::CanonicalPDBs(
     const shared_ptr<PDBCollection> &pdbs,
     const shared_ptr<vector<PatternClique>> &pattern_cliques)
-    : pdbs(pdbs), pattern_cliques(pattern_cliques) {
+    : pdbs(pdbs), pattern_cliques(pattern_cliques),
+      has_common_format(true), common_format(DistanceFormat::INT32) {
     assert(pdbs);
     assert(pattern_cliques);
-}
 
-int CanonicalPDBs::get_value(const State &state) const {
-    // If we have an empty collection, then pattern_cliques = { \emptyset }.
-    assert(!pattern_cliques->empty());
-    int max_h = 0;
-    vector<int> h_values;
-    h_values.reserve(pdbs->size());
-    state.unpack();
+    int num_variables = 0;
     for (const shared_ptr<PatternDatabase> &pdb : *pdbs) {
-        int h = pdb->get_value(state.get_unpacked_values());
-        if (h == numeric_limits<int>::max()) {
-            return numeric_limits<int>::max();
+        const Pattern &pattern = pdb->get_pattern();
+        if (!pattern.empty()) {
+            num_variables = max(num_variables, pattern.back() + 1);
         }
-        h_values.push_back(h);
     }
+    int num_pdbs = pdbs->size();
+    vector<vector<pair<int, int>>> entries_by_variable(num_variables);
+    size_t num_entries = 0;
+    for (int pdb_id = 0; pdb_id < num_pdbs; ++pdb_id) {
+        const PatternDatabase &pdb = *(*pdbs)[pdb_id];
+        const Pattern &pattern = pdb.get_pattern();
+        const vector<size_t> &hash_multipliers = pdb.get_hash_multipliers();
+        for (size_t i = 0; i < pattern.size(); ++i) {
+            // All indices of a PDB are below numeric_limits<int>::max().
+            entries_by_variable[pattern[i]].emplace_back(
+                pdb_id, static_cast<int>(hash_multipliers[i]));
+        }
+        num_entries += pattern.size();
+    }
+    for (int var = 0; var < num_variables; ++var) {
+        if (!entries_by_variable[var].empty()) {
+            relevant_variables.push_back(var);
+        }
+    }
+
+    size_t num_dense_entries = relevant_variables.size() * num_pdbs;
+    is_dense = num_entries * DENSE_MATRIX_DENSITY >= num_dense_entries;
+    if (is_dense) {
+        dense_multipliers.resize(num_dense_entries, 0);
+        for (size_t i = 0; i < relevant_variables.size(); ++i) {
+            int *row = &dense_multipliers[i * num_pdbs];
+            for (const pair<int, int> &entry :
+                 entries_by_variable[relevant_variables[i]]) {
+                row[entry.first] = entry.second;
+            }
+        }
+    } else {
+        for (int var : relevant_variables) {
+            variable_entries_start.push_back(entry_pdb_ids.size());
+            for (const pair<int, int> &entry : entries_by_variable[var]) {
+                entry_pdb_ids.push_back(entry.first);
+                entry_multipliers.push_back(entry.second);
+            }
+        }
+        variable_entries_start.push_back(entry_pdb_ids.size());
+    }
+
+    for (const shared_ptr<PatternDatabase> &pdb : *pdbs) {
+        const DistanceTable &table = pdb->get_distance_table();
+        if (table_data.empty()) {
+            common_format = table.get_format();
+        } else if (table.get_format() != common_format) {
+            has_common_format = false;
+        }
+        table_data.push_back(table.get_data());
+    }
+
     for (const PatternClique &clique : *pattern_cliques) {
+        clique_start.push_back(clique_pdb_ids.size());
+        clique_pdb_ids.insert(clique_pdb_ids.end(), clique.begin(), clique.end());
+    }
+    clique_start.push_back(clique_pdb_ids.size());
+}
+
+void CanonicalPDBs::compute_indices(
+    const vector<int> &state, int *indices) const {
+    int num_pdbs = pdbs->size();
+    if (is_dense) {
+        const int *row = dense_multipliers.data();
+        for (int var : relevant_variables) {
+            int value = state[var];
+            if (value != 0) {
+                add_scaled_row(indices, row, value, num_pdbs);
+            }
+            row += num_pdbs;
+        }
+    } else {
+        for (size_t i = 0; i < relevant_variables.size(); ++i) {
+            int value = state[relevant_variables[i]];
+            int end = variable_entries_start[i + 1];
+            for (int entry = variable_entries_start[i]; entry < end; ++entry) {
+                indices[entry_pdb_ids[entry]] += entry_multipliers[entry] * value;
+            }
+        }
+    }
+}
+
+bool CanonicalPDBs::look_up_distances(int *values) const {
+    if (has_common_format) {
+        switch (common_format) {
+        case DistanceFormat::INT32:
+            return look_up_distances_in_format<DistanceFormat::INT32>(
+                table_data, values);
+        case DistanceFormat::UINT8:
+            return look_up_distances_in_format<DistanceFormat::UINT8>(
+                table_data, values);
+        case DistanceFormat::UINT4:
+            return look_up_distances_in_format<DistanceFormat::UINT4>(
+                table_data, values);
+        }
+    }
+    bool is_dead_end = false;
+    int num_pdbs = pdbs->size();
+    for (int pdb_id = 0; pdb_id < num_pdbs; ++pdb_id) {
+        int h = (*pdbs)[pdb_id]->get_value_for_index(values[pdb_id]);
+        is_dead_end |= (h == numeric_limits<int>::max());
+        values[pdb_id] = h;
+    }
+    return is_dead_end;
+}
+
+int CanonicalPDBs::compute_value(
+    const vector<int> &state, vector<int> &buffer) const {
+    // If we have an empty collection, then pattern_cliques = { \emptyset }.
+    assert(!pattern_cliques->empty());
+    buffer.assign(pdbs->size(), 0);
+
+    // Abstract state indices of all PDBs.
+    compute_indices(state, buffer.data());
+
+    if (look_up_distances(buffer.data())) {
+        return numeric_limits<int>::max();
+    }
+
+    const int *h_values = buffer.data();
+    int max_h = 0;
+    int num_cliques = clique_start.size() - 1;
+    for (int clique_id = 0; clique_id < num_cliques; ++clique_id) {
         int clique_h = 0;
-        for (PatternID pdb_index : clique) {
-            clique_h += h_values[pdb_index];
+        int end = clique_start[clique_id + 1];
+        for (int i = clique_start[clique_id]; i < end; ++i) {
+            clique_h += h_values[clique_pdb_ids[i]];
         }
         max_h = max(max_h, clique_h);
     }
     return max_h;
 }
+
+int CanonicalPDBs::get_value(const State &state) const {
+    state.unpack();
+    vector<int> buffer;
+    return compute_value(state.get_unpacked_values(), buffer);
+}
+
+void CanonicalPDBs::get_values(
+    const vector<State> &states, vector<int> &values) const {
+    values.clear();
+    values.reserve(states.size());
+    vector<int> buffer;
+    for (const State &state : states) {
+        state.unpack();
+        values.push_back(compute_value(state.get_unpacked_values(), buffer));
+    }
+}
 }
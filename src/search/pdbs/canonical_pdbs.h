@@ -1,17 +1,66 @@
 #ifndef PDBS_CANONICAL_PDBS_H
 #define PDBS_CANONICAL_PDBS_H
 
+#include "distance_table.h"
 #include "types.h"
 
+#include <cstdint>
 #include <memory>
+#include <vector>
 
 class State;
 
 namespace pdbs {
+/*
+  Evaluates all PDBs of the collection together. The abstract state indices
+  of all PDBs are computed in one pass over the variables of the state from
+  a (variable -> PDB) matrix of hash multipliers. Afterwards, the distances
+  are looked up and the maximum over the sums of the pattern cliques is
+  computed from flat arrays.
+
+  If the patterns cover enough of the relevant variables, the matrix is
+  stored densely: the row of a variable holds the multipliers of all PDBs
+  (0 for PDBs without the variable), so adding a row to the indices is a
+  contiguous loop over the PDBs which the compiler vectorizes. Otherwise,
+  only the non-zero entries are stored.
+*/
 class CanonicalPDBs {
     std::shared_ptr<PDBCollection> pdbs;
     std::shared_ptr<std::vector<PatternClique>> pattern_cliques;
 
+    // Variables that occur in some pattern.
+    std::vector<int> relevant_variables;
+
+    bool is_dense;
+    // Dense matrix: one row of pdbs->size() entries per relevant variable.
+    std::vector<int> dense_multipliers;
+    /*
+      Sparse matrix: the entries of relevant_variables[i] are the positions
+      variable_entries_start[i] to variable_entries_start[i + 1] - 1 of
+      entry_pdb_ids and entry_multipliers.
+    */
+    std::vector<int> variable_entries_start;
+    std::vector<int> entry_pdb_ids;
+    std::vector<int> entry_multipliers;
+
+    // Distance tables of the PDBs and their format if they all share one.
+    std::vector<const std::uint8_t *> table_data;
+    bool has_common_format;
+    DistanceFormat common_format;
+
+    // Flattened pattern cliques, in the same way as the sparse matrix.
+    std::vector<int> clique_start;
+    std::vector<PatternID> clique_pdb_ids;
+
+    void compute_indices(const std::vector<int> &state, int *indices) const;
+    // Replace the indices by the distances. Returns true for dead ends.
+    bool look_up_distances(int *values) const;
+    /*
+      Compute the heuristic value for the given unpacked state. buffer is
+      used for the indices and distances of the PDBs.
+    */
+    int compute_value(
+        const std::vector<int> &state, std::vector<int> &buffer) const;
 public:
     CanonicalPDBs(
         const std::shared_ptr<PDBCollection> &pdbs,
@@ -19,6 +68,9 @@ public:
     ~CanonicalPDBs() = default;
 
     int get_value(const State &state) const;
+    // Compute the values of several states at once, reusing the buffers.
+    void get_values(
+        const std::vector<State> &states, std::vector<int> &values) const;
 };
 }
 
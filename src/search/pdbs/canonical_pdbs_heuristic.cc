@@ -1,5 +1,6 @@
 #include "canonical_pdbs_heuristic.h"
 
+#include "distance_table.h"
 #include "dominance_pruning.h"
 #include "pattern_generator.h"
 #include "utils.h"
@@ -25,6 +26,8 @@ CanonicalPDBs get_canonical_pdbs_from_options(
     utils::g_log << "Initializing canonical PDB heuristic..." << endl;
     PatternCollectionInformation pattern_collection_info =
         pattern_generator->generate(task);
+    pattern_collection_info.set_distance_table_options(
+        get_distance_table_options(opts));
     shared_ptr<PatternCollection> patterns =
         pattern_collection_info.get_patterns();
     /*
@@ -77,6 +80,21 @@ int CanonicalPDBsHeuristic::compute_heuristic(const State &ancestor_state) {
     }
 }
 
+void CanonicalPDBsHeuristic::compute_heuristics(
+    const vector<State> &ancestor_states, vector<int> &heuristics) {
+    vector<State> states;
+    states.reserve(ancestor_states.size());
+    for (const State &ancestor_state : ancestor_states) {
+        states.push_back(convert_ancestor_state(ancestor_state));
+    }
+    canonical_pdbs.get_values(states, heuristics);
+    for (int &h : heuristics) {
+        if (h == numeric_limits<int>::max()) {
+            h = DEAD_END;
+        }
+    }
+}
+
 void add_canonical_pdbs_options_to_parser(options::OptionParser &parser) {
     parser.add_option<double>(
         "max_time_dominance_pruning",
@@ -111,6 +129,7 @@ static shared_ptr<Heuristic> _parse(OptionParser &parser) {
         "systematic(1)");
 
     add_canonical_pdbs_options_to_parser(parser);
+    add_distance_table_options_to_parser(parser);
 
     Heuristic::add_options_to_parser(parser);
 
@@ -16,6 +16,9 @@ class CanonicalPDBsHeuristic : public Heuristic {
 
 protected:
     virtual int compute_heuristic(const State &ancestor_state) override;
+    virtual void compute_heuristics(
+        const std::vector<State> &ancestor_states,
+        std::vector<int> &heuristics) override;
 
 public:
     explicit CanonicalPDBsHeuristic(const options::Options &opts);
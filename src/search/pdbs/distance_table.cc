@@ -0,0 +1,209 @@
+#include "distance_table.h"
+
+#include "../option_parser.h"
+
+#include "../utils/binary_io.h"
+#include "../utils/memory.h"
+#include "../utils/system.h"
+
+#include <algorithm>
+#include <cassert>
+#include <fstream>
+
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace pdbs {
+static const uint64_t MAGIC = 0x3142544244504446ULL; // "FDPDBTB1"
+// Magic, key, format and number of entries. Keeps the entries aligned.
+static const size_t HEADER_SIZE = 4 * sizeof(uint64_t);
+
+static size_t compute_num_bytes(DistanceFormat format, size_t num_entries) {
+    switch (format) {
+    case DistanceFormat::INT32:
+        return 4 * num_entries;
+    case DistanceFormat::UINT8:
+        return num_entries;
+    case DistanceFormat::UINT4:
+        return (num_entries + 1) / 2;
+    }
+    ABORT("Unknown distance format.");
+}
+
+static int compute_infinity_code(DistanceFormat format) {
+    switch (format) {
+    case DistanceFormat::INT32:
+        return numeric_limits<int>::max();
+    case DistanceFormat::UINT8:
+        return 0xFF;
+    case DistanceFormat::UINT4:
+        return 0xF;
+    }
+    ABORT("Unknown distance format.");
+}
+
+class DistanceTable::MappedFile {
+    void *address;
+    size_t length;
+public:
+    MappedFile(void *address, size_t length)
+        : address(address), length(length) {
+    }
+
+    ~MappedFile() {
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+        munmap(address, length);
+#endif
+    }
+
+    const uint8_t *get_data() const {
+        return static_cast<const uint8_t *>(address);
+    }
+};
+
+DistanceTable::DistanceTable()
+    : DistanceTable(DistanceFormat::INT32, 0) {
+}
+
+DistanceTable::DistanceTable(DistanceFormat format, size_t num_entries)
+    : format(format),
+      num_entries(num_entries),
+      infinity_code(compute_infinity_code(format)),
+      data(nullptr) {
+}
+
+DistanceTable::DistanceTable(vector<int> &&distances, DistanceFormat format)
+    : DistanceTable(format, distances.size()) {
+    if (format == DistanceFormat::INT32) {
+        owned_data = move(distances);
+    } else {
+        owned_data.resize((get_num_bytes() + sizeof(int) - 1) / sizeof(int), 0);
+        uint8_t *bytes = reinterpret_cast<uint8_t *>(owned_data.data());
+        for (size_t i = 0; i < num_entries; ++i) {
+            int distance = distances[i];
+            int code;
+            if (distance == numeric_limits<int>::max()) {
+                code = infinity_code;
+            } else {
+                code = min(distance, infinity_code - 1);
+            }
+            if (format == DistanceFormat::UINT8) {
+                bytes[i] = code;
+            } else {
+                bytes[i / 2] |= code << (4 * (i % 2));
+            }
+        }
+        vector<int>().swap(distances);
+    }
+    data = reinterpret_cast<const uint8_t *>(owned_data.data());
+}
+
+DistanceTable::DistanceTable(DistanceTable &&other) = default;
+
+DistanceTable::~DistanceTable() {
+}
+
+DistanceTable &DistanceTable::operator=(DistanceTable &&other) = default;
+
+size_t DistanceTable::get_num_bytes() const {
+    return compute_num_bytes(format, num_entries);
+}
+
+bool DistanceTable::save(const string &filename, uint64_t key) const {
+    return utils::write_file_atomically(
+        filename,
+        [&](utils::BinaryWriter &writer) {
+            writer.write<uint64_t>(MAGIC);
+            writer.write<uint64_t>(key);
+            writer.write<uint64_t>(static_cast<uint64_t>(format));
+            writer.write<uint64_t>(num_entries);
+            writer.write_bytes(data, get_num_bytes());
+        });
+}
+
+unique_ptr<DistanceTable> DistanceTable::load(
+    const string &filename, uint64_t key,
+    DistanceFormat format, size_t num_entries) {
+    unique_ptr<DistanceTable> table(new DistanceTable(format, num_entries));
+    size_t file_size = HEADER_SIZE + table->get_num_bytes();
+    uint64_t expected_header[] = {
+        MAGIC, key, static_cast<uint64_t>(format), num_entries};
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd == -1) {
+        return nullptr;
+    }
+    struct stat file_status;
+    if (fstat(fd, &file_status) != 0 ||
+        static_cast<size_t>(file_status.st_size) != file_size) {
+        close(fd);
+        return nullptr;
+    }
+    void *address = mmap(nullptr, file_size, PROT_READ, MAP_SHARED, fd, 0);
+    // The mapping stays valid after closing the file.
+    close(fd);
+    if (address == MAP_FAILED) {
+        return nullptr;
+    }
+    table->mapped_file = utils::make_unique_ptr<MappedFile>(address, file_size);
+    const uint8_t *file_data = table->mapped_file->get_data();
+    if (memcmp(file_data, expected_header, HEADER_SIZE) != 0) {
+        return nullptr;
+    }
+    table->data = file_data + HEADER_SIZE;
+#else
+    ifstream file(filename, ios::binary);
+    if (!file) {
+        return nullptr;
+    }
+    uint64_t header[4];
+    file.read(reinterpret_cast<char *>(header), HEADER_SIZE);
+    if (!file || memcmp(header, expected_header, HEADER_SIZE) != 0) {
+        return nullptr;
+    }
+    size_t num_bytes = table->get_num_bytes();
+    table->owned_data.resize((num_bytes + sizeof(int) - 1) / sizeof(int));
+    file.read(reinterpret_cast<char *>(table->owned_data.data()), num_bytes);
+    if (static_cast<size_t>(file.gcount()) != num_bytes ||
+        file.peek() != char_traits<char>::eof()) {
+        return nullptr;
+    }
+    table->data = reinterpret_cast<const uint8_t *>(table->owned_data.data());
+#endif
+    return table;
+}
+
+void add_distance_table_options_to_parser(options::OptionParser &parser) {
+    parser.add_enum_option<DistanceFormat>(
+        "distance_format",
+        {"INT32", "UINT8", "UINT4"},
+        "number of bits per entry of the PDB tables. With UINT8 and UINT4, "
+        "distances above 254 and 14 are saturated to these values, so the "
+        "tables need a quarter or an eighth of the memory at the price of "
+        "lower estimates for large distances.",
+        "INT32",
+        {"4 bytes per entry, exact distances",
+         "1 byte per entry",
+         "2 entries per byte"});
+    parser.add_option<string>(
+        "pdb_cache",
+        "directory in which the PDB tables are stored. A PDB whose abstract "
+        "task (pattern, operators, operator costs and goal) and distance "
+        "format match a stored table is loaded (memory-mapped) instead of "
+        "computed. Use 'none' to compute all PDBs.",
+        "none");
+}
+
+DistanceTableOptions get_distance_table_options(const options::Options &opts) {
+    DistanceTableOptions table_options;
+    table_options.format = opts.get<DistanceFormat>("distance_format");
+    table_options.cache_directory = opts.get<string>("pdb_cache");
+    return table_options;
+}
+}
@@ -0,0 +1,140 @@
+#ifndef PDBS_DISTANCE_TABLE_H
+#define PDBS_DISTANCE_TABLE_H
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace options {
+class OptionParser;
+class Options;
+}
+
+namespace pdbs {
+enum class DistanceFormat {
+    INT32,
+    UINT8,
+    UINT4
+};
+
+struct DistanceTableOptions {
+    DistanceFormat format;
+    // Directory of the on-disk PDB cache or "none".
+    std::string cache_directory;
+
+    DistanceTableOptions()
+        : format(DistanceFormat::INT32),
+          cache_directory("none") {
+    }
+
+    bool uses_cache() const {
+        return cache_directory != "none";
+    }
+};
+
+/*
+  The distances of a PDB, stored with 32, 8 or 4 bits per entry. In the
+  compact formats, the largest code represents dead ends and finite
+  distances that do not fit are saturated to the largest finite code. This
+  only lowers distances and keeps the heuristic admissible and consistent.
+
+  Tables can be saved to a file and loaded from it. On Linux and macOS, a
+  loaded table is memory-mapped, so it is only paged in as far as it is used
+  and shared between processes which load the same file.
+*/
+class DistanceTable {
+    class MappedFile;
+
+    DistanceFormat format;
+    std::size_t num_entries;
+    int infinity_code;
+    // Owned entries; compact formats use it as byte storage.
+    std::vector<int> owned_data;
+    std::unique_ptr<MappedFile> mapped_file;
+    const std::uint8_t *data;
+
+    DistanceTable(DistanceFormat format, std::size_t num_entries);
+public:
+    DistanceTable();
+    // Takes over the distances (dead ends are numeric_limits<int>::max()).
+    DistanceTable(std::vector<int> &&distances, DistanceFormat format);
+    DistanceTable(DistanceTable &&other);
+    ~DistanceTable();
+    DistanceTable &operator=(DistanceTable &&other);
+
+    /*
+      Decode the entry with the given index of a table with the given format.
+      Callers which look up many entries of tables with the same format can
+      choose the format once instead of for every entry.
+    */
+    template<DistanceFormat Format>
+    static int decode(const std::uint8_t *data, std::size_t index) {
+        if (Format == DistanceFormat::INT32) {
+            std::int32_t distance;
+            std::memcpy(&distance, data + 4 * index, sizeof(distance));
+            return distance;
+        }
+        int code;
+        int infinity;
+        if (Format == DistanceFormat::UINT8) {
+            code = data[index];
+            infinity = 0xFF;
+        } else {
+            code = (data[index / 2] >> (4 * (index % 2))) & 0xF;
+            infinity = 0xF;
+        }
+        return code == infinity ? std::numeric_limits<int>::max() : code;
+    }
+
+    int get(std::size_t index) const {
+        switch (format) {
+        case DistanceFormat::INT32:
+            return decode<DistanceFormat::INT32>(data, index);
+        case DistanceFormat::UINT8:
+            return decode<DistanceFormat::UINT8>(data, index);
+        default:
+            return decode<DistanceFormat::UINT4>(data, index);
+        }
+    }
+
+    // The encoded entries (see decode).
+    const std::uint8_t *get_data() const {
+        return data;
+    }
+
+    std::size_t size() const {
+        return num_entries;
+    }
+
+    DistanceFormat get_format() const {
+        return format;
+    }
+
+    // Number of bytes used for the entries.
+    std::size_t get_num_bytes() const;
+
+    /*
+      Write the table and the key which identifies it to the given file.
+      Returns false if the file could not be written.
+    */
+    bool save(const std::string &filename, std::uint64_t key) const;
+
+    /*
+      Load a table from the given file. Returns nullptr if the file does not
+      exist or if its key, format or size do not match.
+    */
+    static std::unique_ptr<DistanceTable> load(
+        const std::string &filename, std::uint64_t key,
+        DistanceFormat format, std::size_t num_entries);
+};
+
+extern void add_distance_table_options_to_parser(
+    options::OptionParser &parser);
+extern DistanceTableOptions get_distance_table_options(
+    const options::Options &opts);
+}
+
+#endif
@@ -1,14 +1,17 @@
 #include "incremental_canonical_pdbs.h"
 
-#include "canonical_pdbs.h"
 #include "pattern_database.h"
 
+#include "../utils/memory.h"
+
 using namespace std;
 
 namespace pdbs {
 IncrementalCanonicalPDBs::IncrementalCanonicalPDBs(
-    const TaskProxy &task_proxy, const PatternCollection &intitial_patterns)
+    const TaskProxy &task_proxy, const PatternCollection &intitial_patterns,
+    const DistanceTableOptions &table_options)
     : task_proxy(task_proxy),
+      table_options(table_options),
       patterns(make_shared<PatternCollection>(intitial_patterns.begin(),
                                               intitial_patterns.end())),
       pattern_databases(make_shared<PDBCollection>()),
@@ -22,7 +25,9 @@ IncrementalCanonicalPDBs::IncrementalCanonicalPDBs(
 }
 
 void IncrementalCanonicalPDBs::add_pdb_for_pattern(const Pattern &pattern) {
-    pattern_databases->push_back(make_shared<PatternDatabase>(task_proxy, pattern));
+    pattern_databases->push_back(make_shared<PatternDatabase>(
+                                     task_proxy, pattern, false, vector<int>(),
+                                     table_options));
     size += pattern_databases->back()->get_size();
 }
 
@@ -36,6 +41,8 @@ void IncrementalCanonicalPDBs::add_pdb(const shared_ptr<PatternDatabase> &pdb) {
 void IncrementalCanonicalPDBs::recompute_pattern_cliques() {
     pattern_cliques = compute_pattern_cliques(*patterns,
                                               are_additive);
+    canonical_pdbs = utils::make_unique_ptr<CanonicalPDBs>(
+        pattern_databases, pattern_cliques);
 }
 
 vector<PatternClique> IncrementalCanonicalPDBs::get_pattern_cliques(
@@ -45,8 +52,7 @@ vector<PatternClique> IncrementalCanonicalPDBs::get_pattern_cliques(
 }
 
 int IncrementalCanonicalPDBs::get_value(const State &state) const {
-    CanonicalPDBs canonical_pdbs(pattern_databases, pattern_cliques);
-    return canonical_pdbs.get_value(state);
+    return canonical_pdbs->get_value(state);
 }
 
 bool IncrementalCanonicalPDBs::is_dead_end(const State &state) const {
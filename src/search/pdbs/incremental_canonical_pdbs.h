@@ -2,6 +2,8 @@
 #define PDBS_INCREMENTAL_CANONICAL_PDBS_H
 
 #include "pattern_cliques.h"
+#include "canonical_pdbs.h"
+#include "distance_table.h"
 #include "pattern_collection_information.h"
 #include "types.h"
 
@@ -12,10 +14,13 @@
 namespace pdbs {
 class IncrementalCanonicalPDBs {
     TaskProxy task_proxy;
+    DistanceTableOptions table_options;
 
     std::shared_ptr<PatternCollection> patterns;
     std::shared_ptr<PDBCollection> pattern_databases;
     std::shared_ptr<std::vector<PatternClique>> pattern_cliques;
+    // Evaluates the current collection; rebuilt with the pattern cliques.
+    std::unique_ptr<CanonicalPDBs> canonical_pdbs;
 
     // A pair of variables is additive if no operator has an effect on both.
     VariableAdditivity are_additive;
@@ -29,7 +34,8 @@ class IncrementalCanonicalPDBs {
     void recompute_pattern_cliques();
 public:
     IncrementalCanonicalPDBs(const TaskProxy &task_proxy,
-                             const PatternCollection &intitial_patterns);
+                             const PatternCollection &intitial_patterns,
+                             const DistanceTableOptions &table_options);
     virtual ~IncrementalCanonicalPDBs() = default;
 
     // Adds a new PDB to the collection and recomputes pattern_cliques.
@@ -8,10 +8,12 @@
 #include "../plugin.h"
 #include "../task_proxy.h"
 
+#include "../algorithms/thread_pool.h"
 #include "../task_utils/causal_graph.h"
 #include "../utils/logging.h"
 #include "../utils/markup.h"
 #include "../utils/math.h"
+#include "../utils/memory.h"
 #include "../utils/rng.h"
 #include "../utils/rng_options.h"
 #include "../utils/timer.h"
@@ -32,9 +34,13 @@ PatternCollectionGeneratorGenetic::PatternCollectionGeneratorGenetic(
       num_episodes(opts.get<int>("num_episodes")),
       mutation_probability(opts.get<double>("mutation_probability")),
       disjoint_patterns(opts.get<bool>("disjoint")),
+      num_threads(opts.get<int>("threads")),
       rng(utils::parse_rng_from_options(opts)) {
 }
 
+PatternCollectionGeneratorGenetic::~PatternCollectionGeneratorGenetic() {
+}
+
 void PatternCollectionGeneratorGenetic::select(
     const vector<double> &fitness_values) {
     vector<double> cumulative_fitness;
@@ -196,7 +202,8 @@ void PatternCollectionGeneratorGenetic::evaluate(vector<double> &fitness_values)
         } else {
             /* Generate the pattern collection heuristic and get its fitness
                value. */
-            ZeroOnePDBs zero_one_pdbs(task_proxy, *pattern_collection);
+            ZeroOnePDBs zero_one_pdbs(
+                task_proxy, *pattern_collection, *pool, DistanceTableOptions());
             fitness = zero_one_pdbs.compute_approx_mean_finite_h();
             // Update the best heuristic found so far.
             if (fitness > best_fitness) {
@@ -278,11 +285,14 @@ PatternCollectionInformation PatternCollectionGeneratorGenetic::generate(
     utils::Timer timer;
     utils::g_log << "Generating patterns using the genetic generator..." << endl;
     task = task_;
+    pool = utils::make_unique_ptr<thread_pool::ThreadPool>(num_threads);
     genetic_algorithm();
+    pool = nullptr;
 
     TaskProxy task_proxy(*task);
     assert(best_patterns);
     PatternCollectionInformation pci(task_proxy, best_patterns);
+    pci.set_num_threads(num_threads);
     dump_pattern_collection_generation_statistics(
         "Genetic generator", timer(), pci);
     return pci;
@@ -371,6 +381,11 @@ static shared_ptr<PatternCollectionGenerator> _parse(OptionParser &parser) {
         "consider a pattern collection invalid (giving it very low "
         "fitness) if its patterns are not disjoint",
         "false");
+    parser.add_option<int>(
+        "threads",
+        "number of threads used to compute the PDBs of a pattern collection",
+        "1",
+        Bounds("1", "infinity"));
 
     utils::add_rng_options(parser);
 
@@ -13,6 +13,10 @@ namespace options {
 class Options;
 }
 
+namespace thread_pool {
+class ThreadPool;
+}
+
 namespace utils {
 class RandomNumberGenerator;
 }
@@ -33,9 +37,12 @@ class PatternCollectionGeneratorGenetic : public PatternCollectionGenerator {
     /* Specifies whether patterns in each pattern collection need to be disjoint
        or not. */
     const bool disjoint_patterns;
+    const int num_threads;
     std::shared_ptr<utils::RandomNumberGenerator> rng;
 
     std::shared_ptr<AbstractTask> task;
+    // Computes the PDBs of a collection in parallel (only during generate).
+    std::unique_ptr<thread_pool::ThreadPool> pool;
 
     // All current pattern collections.
     std::vector<std::vector<std::vector<bool>>> pattern_collections;
@@ -114,6 +121,7 @@ class PatternCollectionGeneratorGenetic : public PatternCollectionGenerator {
     void genetic_algorithm();
 public:
     explicit PatternCollectionGeneratorGenetic(const options::Options &opts);
+    virtual ~PatternCollectionGeneratorGenetic() override;
 
     virtual PatternCollectionInformation generate(
         const std::shared_ptr<AbstractTask> &task) override;
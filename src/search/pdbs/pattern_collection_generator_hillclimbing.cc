@@ -9,6 +9,7 @@
 #include "../option_parser.h"
 #include "../plugin.h"
 
+#include "../algorithms/thread_pool.h"
 #include "../task_utils/causal_graph.h"
 #include "../task_utils/sampling.h"
 #include "../task_utils/task_properties.h"
@@ -23,6 +24,7 @@
 #include "../utils/timer.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <iostream>
 #include <limits>
@@ -118,11 +120,16 @@ PatternCollectionGeneratorHillclimbing::PatternCollectionGeneratorHillclimbing(c
       num_samples(opts.get<int>("num_samples")),
       min_improvement(opts.get<int>("min_improvement")),
       max_time(opts.get<double>("max_time")),
+      num_threads(opts.get<int>("threads")),
+      table_options(get_distance_table_options(opts)),
       rng(utils::parse_rng_from_options(opts)),
       num_rejected(0),
       hill_climbing_timer(0) {
 }
 
+PatternCollectionGeneratorHillclimbing::~PatternCollectionGeneratorHillclimbing() {
+}
+
 int PatternCollectionGeneratorHillclimbing::generate_candidate_pdbs(
     const TaskProxy &task_proxy,
     const vector<vector<int>> &relevant_neighbours,
@@ -131,7 +138,7 @@ int PatternCollectionGeneratorHillclimbing::generate_candidate_pdbs(
     PDBCollection &candidate_pdbs) {
     const Pattern &pattern = pdb.get_pattern();
     int pdb_size = pdb.get_size();
-    int max_pdb_size = 0;
+    PatternCollection new_patterns;
     for (int pattern_var : pattern) {
         assert(utils::in_bounds(pattern_var, relevant_neighbours));
         const vector<int> &connected_vars = relevant_neighbours[pattern_var];
@@ -158,16 +165,20 @@ int PatternCollectionGeneratorHillclimbing::generate_candidate_pdbs(
                       surpass the size limit.
                     */
                     generated_patterns.insert(new_pattern);
-                    candidate_pdbs.push_back(
-                        make_shared<PatternDatabase>(task_proxy, new_pattern));
-                    max_pdb_size = max(max_pdb_size,
-                                       candidate_pdbs.back()->get_size());
+                    new_patterns.push_back(move(new_pattern));
                 }
             } else {
                 ++num_rejected;
             }
         }
     }
+
+    int max_pdb_size = 0;
+    for (shared_ptr<PatternDatabase> &new_pdb :
+         compute_pdbs(task_proxy, new_patterns, *pool, table_options)) {
+        max_pdb_size = max(max_pdb_size, new_pdb->get_size());
+        candidate_pdbs.push_back(move(new_pdb));
+    }
     return max_pdb_size;
 }
 
@@ -201,53 +212,61 @@ pair<int, int> PatternCollectionGeneratorHillclimbing::find_best_improving_pdb(
       We require that a pattern must have an improvement of at least one in
       order to be taken into account.
     */
-    int improvement = 0;
-    int best_pdb_index = -1;
-
-    // Iterate over all candidates and search for the best improving pattern/pdb
-    for (size_t i = 0; i < candidate_pdbs.size(); ++i) {
-        if (hill_climbing_timer->is_expired())
-            throw HillClimbingTimeout();
-
-        const shared_ptr<PatternDatabase> &pdb = candidate_pdbs[i];
-        if (!pdb) {
-            /* candidate pattern is too large or has already been added to
-               the canonical heuristic. */
-            continue;
-        }
+    for (shared_ptr<PatternDatabase> &pdb : candidate_pdbs) {
         /*
           If a candidate's size added to the current collection's size exceeds
-          the maximum collection size, then forget the pdb.
+          the maximum collection size, then forget the pdb. Candidates which
+          are too large or have already been added to the canonical heuristic
+          are null pointers.
         */
-        int combined_size = current_pdbs->get_size() + pdb->get_size();
-        if (combined_size > collection_max_size) {
-            candidate_pdbs[i] = nullptr;
-            continue;
+        if (pdb && current_pdbs->get_size() + pdb->get_size() > collection_max_size) {
+            pdb = nullptr;
         }
+    }
 
-        /*
-          Calculate the "counting approximation" for all sample states: count
-          the number of samples for which the current pattern collection
-          heuristic would be improved if the new pattern was included into it.
-        */
-        /*
-          TODO: The original implementation by Haslum et al. uses m/t as a
-          statistical confidence interval to stop the A*-search (which they use,
-          see above) earlier.
-        */
-        int count = 0;
-        vector<PatternClique> pattern_cliques =
-            current_pdbs->get_pattern_cliques(pdb->get_pattern());
-        for (int sample_id = 0; sample_id < num_samples; ++sample_id) {
-            const State &sample = samples[sample_id];
-            assert(utils::in_bounds(sample_id, samples_h_values));
-            int h_collection = samples_h_values[sample_id];
-            if (is_heuristic_improved(
-                    *pdb, sample, h_collection,
-                    *current_pdbs->get_pattern_databases(), pattern_cliques)) {
-                ++count;
-            }
-        }
+    /*
+      Calculate the "counting approximation" for all sample states: count
+      the number of samples for which the current pattern collection
+      heuristic would be improved if the new pattern was included into it.
+    */
+    /*
+      TODO: The original implementation by Haslum et al. uses m/t as a
+      statistical confidence interval to stop the A*-search (which they use,
+      see above) earlier.
+    */
+    vector<int> counts(candidate_pdbs.size(), 0);
+    atomic<bool> timeout(false);
+    pool->run(candidate_pdbs.size(), [&](int i) {
+                  const shared_ptr<PatternDatabase> &pdb = candidate_pdbs[i];
+                  if (!pdb || timeout) {
+                      return;
+                  }
+                  if (hill_climbing_timer->is_expired()) {
+                      timeout = true;
+                      return;
+                  }
+                  vector<PatternClique> pattern_cliques =
+                      current_pdbs->get_pattern_cliques(pdb->get_pattern());
+                  for (int sample_id = 0; sample_id < num_samples; ++sample_id) {
+                      const State &sample = samples[sample_id];
+                      assert(utils::in_bounds(sample_id, samples_h_values));
+                      int h_collection = samples_h_values[sample_id];
+                      if (is_heuristic_improved(
+                              *pdb, sample, h_collection,
+                              *current_pdbs->get_pattern_databases(), pattern_cliques)) {
+                          ++counts[i];
+                      }
+                  }
+              });
+    if (timeout) {
+        throw HillClimbingTimeout();
+    }
+
+    // Iterate over all candidates and search for the best improving pattern/pdb
+    int improvement = 0;
+    int best_pdb_index = -1;
+    for (size_t i = 0; i < candidate_pdbs.size(); ++i) {
+        int count = counts[i];
         if (count > improvement) {
             improvement = count;
             best_pdb_index = i;
@@ -303,6 +322,7 @@ bool PatternCollectionGeneratorHillclimbing::is_heuristic_improved(
 void PatternCollectionGeneratorHillclimbing::hill_climbing(
     const TaskProxy &task_proxy) {
     hill_climbing_timer = new utils::CountdownTimer(max_time);
+    pool = utils::make_unique_ptr<thread_pool::ThreadPool>(num_threads);
 
     utils::g_log << "Average operator cost: "
                  << task_properties::get_average_operator_cost(task_proxy) << endl;
@@ -355,9 +375,10 @@ void PatternCollectionGeneratorHillclimbing::hill_climbing(
             samples.clear();
             samples_h_values.clear();
             sample_states(sampler, init_h, samples);
-            for (const State &sample : samples) {
-                samples_h_values.push_back(current_pdbs->get_value(sample));
-            }
+            samples_h_values.resize(samples.size());
+            pool->run(samples.size(), [&](int i) {
+                          samples_h_values[i] = current_pdbs->get_value(samples[i]);
+                      });
 
             pair<int, int> improvement_and_index =
                 find_best_improving_pdb(samples, samples_h_values, candidate_pdbs);
@@ -406,6 +427,7 @@ void PatternCollectionGeneratorHillclimbing::hill_climbing(
 
     delete hill_climbing_timer;
     hill_climbing_timer = nullptr;
+    pool = nullptr;
 }
 
 PatternCollectionInformation PatternCollectionGeneratorHillclimbing::generate(
@@ -421,7 +443,7 @@ PatternCollectionInformation PatternCollectionGeneratorHillclimbing::generate(
         initial_pattern_collection.emplace_back(1, goal_var_id);
     }
     current_pdbs = utils::make_unique_ptr<IncrementalCanonicalPDBs>(
-        task_proxy, initial_pattern_collection);
+        task_proxy, initial_pattern_collection, table_options);
     utils::g_log << "Done calculating initial pattern collection: " << timer << endl;
 
     State initial_state = task_proxy.get_initial_state();
@@ -468,6 +490,14 @@ void add_hillclimbing_options(OptionParser &parser) {
         "spent for pruning dominated patterns.",
         "infinity",
         Bounds("0.0", "infinity"));
+    parser.add_option<int>(
+        "threads",
+        "number of threads used to compute the candidate PDBs and to "
+        "evaluate them on the samples. The resulting pattern collection "
+        "does not depend on the number of threads.",
+        "1",
+        Bounds("1", "infinity"));
+    add_distance_table_options_to_parser(parser);
     utils::add_rng_options(parser);
 }
 
@@ -618,6 +648,9 @@ static shared_ptr<Heuristic> _parse_ipdb(OptionParser &parser) {
         "patterns", pgh);
     heuristic_opts.set<double>(
         "max_time_dominance_pruning", opts.get<double>("max_time_dominance_pruning"));
+    heuristic_opts.set<DistanceFormat>(
+        "distance_format", opts.get<DistanceFormat>("distance_format"));
+    heuristic_opts.set<string>("pdb_cache", opts.get<string>("pdb_cache"));
 
     return make_shared<CanonicalPDBsHeuristic>(heuristic_opts);
 }
@@ -1,6 +1,7 @@
 #ifndef PDBS_PATTERN_COLLECTION_GENERATOR_HILLCLIMBING_H
 #define PDBS_PATTERN_COLLECTION_GENERATOR_HILLCLIMBING_H
 
+#include "distance_table.h"
 #include "pattern_generator.h"
 #include "types.h"
 
@@ -24,6 +25,10 @@ namespace sampling {
 class RandomWalkSampler;
 }
 
+namespace thread_pool {
+class ThreadPool;
+}
+
 namespace pdbs {
 class CanonicalPDBsHeuristic;
 class IncrementalCanonicalPDBs;
@@ -39,9 +44,13 @@ class PatternCollectionGeneratorHillclimbing : public PatternCollectionGenerator
     // minimal improvement required for hill climbing to continue search
     const int min_improvement;
     const double max_time;
+    const int num_threads;
+    const DistanceTableOptions table_options;
     std::shared_ptr<utils::RandomNumberGenerator> rng;
 
     std::unique_ptr<IncrementalCanonicalPDBs> current_pdbs;
+    // Builds and evaluates the candidate PDBs (only during hill climbing).
+    std::unique_ptr<thread_pool::ThreadPool> pool;
 
     // for stats only
     int num_rejected;
@@ -52,7 +61,8 @@ class PatternCollectionGeneratorHillclimbing : public PatternCollectionGenerator
       relevant variable are considered as candidate patterns. If the candidate
       pattern has not been previously considered (not contained in
       generated_patterns) and if building a PDB for it does not surpass the
-      size limit, then the PDB is built and added to candidate_pdbs.
+      size limit, then the PDB is built and added to candidate_pdbs. The new
+      PDBs are built in parallel and added in a fixed order.
 
       The method returns the size of the largest PDB added to candidate_pdbs.
     */
@@ -81,7 +91,8 @@ class PatternCollectionGeneratorHillclimbing : public PatternCollectionGenerator
     /*
       Searches for the best improving pdb in candidate_pdbs according to the
       counting approximation and the given samples. Returns the improvement and
-      the index of the best pdb in candidate_pdbs.
+      the index of the best pdb in candidate_pdbs. The candidates are
+      evaluated in parallel, ties are broken in favour of the smallest index.
     */
     std::pair<int, int> find_best_improving_pdb(
         const std::vector<State> &samples,
@@ -127,7 +138,7 @@ class PatternCollectionGeneratorHillclimbing : public PatternCollectionGenerator
 
 public:
     explicit PatternCollectionGeneratorHillclimbing(const options::Options &opts);
-    virtual ~PatternCollectionGeneratorHillclimbing() = default;
+    virtual ~PatternCollectionGeneratorHillclimbing() override;
 
     /*
       Runs the hill climbing algorithm. Note that the
@@ -50,7 +50,8 @@ static void compute_union_pattern(
 PatternCollectionGeneratorSystematic::PatternCollectionGeneratorSystematic(
     const Options &opts)
     : max_pattern_size(opts.get<int>("pattern_max_size")),
-      only_interesting_patterns(opts.get<bool>("only_interesting_patterns")) {
+      only_interesting_patterns(opts.get<bool>("only_interesting_patterns")),
+      num_threads(opts.get<int>("threads")) {
 }
 
 void PatternCollectionGeneratorSystematic::compute_eff_pre_neighbors(
@@ -274,6 +275,7 @@ PatternCollectionInformation PatternCollectionGeneratorSystematic::generate(
         build_patterns_naive(task_proxy);
     }
     PatternCollectionInformation pci(task_proxy, patterns);
+    pci.set_num_threads(num_threads);
     /* Do not dump the collection since it can be very large for
        pattern_max_size >= 3. */
     dump_pattern_collection_generation_statistics(
@@ -306,6 +308,11 @@ static shared_ptr<PatternCollectionGenerator> _parse(OptionParser &parser) {
         "Only consider the union of two disjoint patterns if the union has "
         "more information than the individual patterns.",
         "true");
+    parser.add_option<int>(
+        "threads",
+        "number of threads used to compute the PDBs of the collection",
+        "1",
+        Bounds("1", "infinity"));
 
     Options opts = parser.parse();
     if (parser.dry_run())
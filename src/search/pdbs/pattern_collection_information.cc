@@ -2,8 +2,10 @@
 
 #include "pattern_database.h"
 #include "pattern_cliques.h"
+#include "utils.h"
 #include "validation.h"
 
+#include "../algorithms/thread_pool.h"
 #include "../utils/logging.h"
 #include "../utils/timer.h"
 
@@ -21,7 +23,8 @@ PatternCollectionInformation::PatternCollectionInformation(
     : task_proxy(task_proxy),
       patterns(patterns),
       pdbs(nullptr),
-      pattern_cliques(nullptr) {
+      pattern_cliques(nullptr),
+      num_threads(1) {
     assert(patterns);
     validate_and_normalize_patterns(task_proxy, *patterns);
 }
@@ -57,13 +60,14 @@ void PatternCollectionInformation::create_pdbs_if_missing() {
     assert(patterns);
     if (!pdbs) {
         utils::Timer timer;
-        utils::g_log << "Computing PDBs for pattern collection..." << endl;
-        pdbs = make_shared<PDBCollection>();
-        for (const Pattern &pattern : *patterns) {
-            shared_ptr<PatternDatabase> pdb =
-                make_shared<PatternDatabase>(task_proxy, pattern);
-            pdbs->push_back(pdb);
+        utils::g_log << "Computing PDBs for pattern collection";
+        if (num_threads > 1) {
+            utils::g_log << " with " << num_threads << " threads";
         }
+        utils::g_log << "..." << endl;
+        thread_pool::ThreadPool pool(num_threads);
+        pdbs = make_shared<PDBCollection>(
+            compute_pdbs(task_proxy, *patterns, pool, table_options));
         utils::g_log << "Done computing PDBs for pattern collection: " << timer << endl;
     }
 }
@@ -90,6 +94,16 @@ void PatternCollectionInformation::set_pattern_cliques(
     assert(information_is_valid());
 }
 
+void PatternCollectionInformation::set_num_threads(int num_threads_) {
+    assert(num_threads_ >= 1);
+    num_threads = num_threads_;
+}
+
+void PatternCollectionInformation::set_distance_table_options(
+    const DistanceTableOptions &table_options_) {
+    table_options = table_options_;
+}
+
 shared_ptr<PatternCollection> PatternCollectionInformation::get_patterns() const {
     assert(patterns);
     return patterns;
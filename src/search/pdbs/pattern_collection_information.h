@@ -1,6 +1,7 @@
 #ifndef PDBS_PATTERN_COLLECTION_INFORMATION_H
 #define PDBS_PATTERN_COLLECTION_INFORMATION_H
 
+#include "distance_table.h"
 #include "types.h"
 
 #include "../task_proxy.h"
@@ -25,6 +26,8 @@ class PatternCollectionInformation {
     std::shared_ptr<PatternCollection> patterns;
     std::shared_ptr<PDBCollection> pdbs;
     std::shared_ptr<std::vector<PatternClique>> pattern_cliques;
+    int num_threads;
+    DistanceTableOptions table_options;
 
     void create_pdbs_if_missing();
     void create_pattern_cliques_if_missing();
@@ -39,11 +42,18 @@ public:
     void set_pdbs(const std::shared_ptr<PDBCollection> &pdbs);
     void set_pattern_cliques(
         const std::shared_ptr<std::vector<PatternClique>> &pattern_cliques);
+    void set_num_threads(int num_threads);
+    // Only affects PDBs which have not been set or computed yet.
+    void set_distance_table_options(const DistanceTableOptions &table_options);
 
     TaskProxy get_task_proxy() const {
         return task_proxy;
     }
 
+    int get_num_threads() const {
+        return num_threads;
+    }
+
     std::shared_ptr<PatternCollection> get_patterns() const;
     std::shared_ptr<PDBCollection> get_pdbs();
     std::shared_ptr<std::vector<PatternClique>> get_pattern_cliques();
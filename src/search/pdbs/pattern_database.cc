@@ -5,6 +5,7 @@
 #include "../algorithms/priority_queues.h"
 #include "../task_utils/task_properties.h"
 #include "../utils/collections.h"
+#include "../utils/hash.h"
 #include "../utils/logging.h"
 #include "../utils/math.h"
 #include "../utils/timer.h"
@@ -14,6 +15,7 @@
 #include <cstdlib>
 #include <iostream>
 #include <limits>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -70,7 +72,8 @@ PatternDatabase::PatternDatabase(
     const TaskProxy &task_proxy,
     const Pattern &pattern,
     bool dump,
-    const vector<int> &operator_costs)
+    const vector<int> &operator_costs,
+    const DistanceTableOptions &table_options)
     : pattern(pattern) {
     task_properties::verify_no_axioms(task_proxy);
     task_properties::verify_no_conditional_effects(task_proxy);
@@ -93,7 +96,7 @@ PatternDatabase::PatternDatabase(
             utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
         }
     }
-    create_pdb(task_proxy, operator_costs);
+    create_pdb(task_proxy, operator_costs, table_options);
     if (dump)
         utils::g_log << "PDB construction time: " << timer << endl;
 }
@@ -187,8 +190,122 @@ void PatternDatabase::build_abstract_operators(
                  variables, operators);
 }
 
+/*
+  Maximal operator cost for which compute_distances_with_buckets is used. It
+  keeps max_cost + 1 buckets, so this bounds the time spent on empty buckets.
+*/
+static const int MAX_COST_FOR_BUCKETS = 1000;
+
+/*
+  All abstract operators have the same positive cost, so the distances of
+  the states grow with the order in which the states are discovered. Every
+  state enters the queue at most once.
+*/
+static void compute_distances_breadth_first(
+    const MatchTree &match_tree,
+    const vector<AbstractOperator> &operators,
+    vector<size_t> &&goal_states,
+    vector<int> &distances) {
+    int cost = operators.front().get_cost();
+    vector<size_t> queue = move(goal_states);
+    vector<int> applicable_operator_ids;
+    for (size_t next = 0; next < queue.size(); ++next) {
+        size_t state_index = queue[next];
+        int successor_distance = distances[state_index] + cost;
+        applicable_operator_ids.clear();
+        match_tree.get_applicable_operator_ids(state_index, applicable_operator_ids);
+        for (int op_id : applicable_operator_ids) {
+            size_t predecessor = state_index + operators[op_id].get_hash_effect();
+            if (distances[predecessor] == numeric_limits<int>::max()) {
+                distances[predecessor] = successor_distance;
+                queue.push_back(predecessor);
+            }
+        }
+    }
+}
+
+/*
+  Dial's algorithm: states with distance d are kept in bucket d % (max_cost
+  + 1). All states in the queue have a distance between d and d + max_cost,
+  so the buckets never mix distances. Operators of cost 0 add states to the
+  bucket that is currently processed.
+*/
+static void compute_distances_with_buckets(
+    const MatchTree &match_tree,
+    const vector<AbstractOperator> &operators,
+    int max_cost,
+    vector<size_t> &&goal_states,
+    vector<int> &distances) {
+    int num_buckets = max_cost + 1;
+    vector<vector<size_t>> buckets(num_buckets);
+    size_t num_queued = goal_states.size();
+    buckets[0] = move(goal_states);
+    vector<int> applicable_operator_ids;
+    for (int distance = 0; num_queued > 0; ++distance) {
+        vector<size_t> &bucket = buckets[distance % num_buckets];
+        while (!bucket.empty()) {
+            size_t state_index = bucket.back();
+            bucket.pop_back();
+            --num_queued;
+            if (distances[state_index] < distance) {
+                continue;
+            }
+            assert(distances[state_index] == distance);
+            applicable_operator_ids.clear();
+            match_tree.get_applicable_operator_ids(
+                state_index, applicable_operator_ids);
+            for (int op_id : applicable_operator_ids) {
+                const AbstractOperator &op = operators[op_id];
+                size_t predecessor = state_index + op.get_hash_effect();
+                int alternative_cost = distance + op.get_cost();
+                if (alternative_cost < distances[predecessor]) {
+                    distances[predecessor] = alternative_cost;
+                    buckets[alternative_cost % num_buckets].push_back(predecessor);
+                    ++num_queued;
+                }
+            }
+        }
+    }
+}
+
+static void compute_distances_dijkstra(
+    const MatchTree &match_tree,
+    const vector<AbstractOperator> &operators,
+    const vector<size_t> &goal_states,
+    vector<int> &distances) {
+    // first implicit entry: priority, second entry: index for an abstract state
+    priority_queues::AdaptiveQueue<size_t> pq;
+    for (size_t state_index : goal_states) {
+        pq.push(0, state_index);
+    }
+
+    vector<int> applicable_operator_ids;
+    while (!pq.empty()) {
+        pair<int, size_t> node = pq.pop();
+        int distance = node.first;
+        size_t state_index = node.second;
+        if (distance > distances[state_index]) {
+            continue;
+        }
+
+        // regress abstract_state
+        applicable_operator_ids.clear();
+        match_tree.get_applicable_operator_ids(state_index, applicable_operator_ids);
+        for (int op_id : applicable_operator_ids) {
+            const AbstractOperator &op = operators[op_id];
+            size_t predecessor = state_index + op.get_hash_effect();
+            int alternative_cost = distances[state_index] + op.get_cost();
+            if (alternative_cost < distances[predecessor]) {
+                distances[predecessor] = alternative_cost;
+                pq.push(alternative_cost, predecessor);
+            }
+        }
+    }
+}
+
 void PatternDatabase::create_pdb(
-    const TaskProxy &task_proxy, const vector<int> &operator_costs) {
+    const TaskProxy &task_proxy, const vector<int> &operator_costs,
+    const DistanceTableOptions &table_options) {
     VariablesProxy variables = task_proxy.get_variables();
     vector<int> variable_to_index(variables.size(), -1);
     for (size_t i = 0; i < pattern.size(); ++i) {
@@ -208,13 +325,6 @@ void PatternDatabase::create_pdb(
             op, op_cost, variable_to_index, variables, operators);
     }
 
-    // build the match tree
-    MatchTree match_tree(task_proxy, pattern, hash_multipliers);
-    for (size_t op_id = 0; op_id < operators.size(); ++op_id) {
-        const AbstractOperator &op = operators[op_id];
-        match_tree.insert(op_id, op.get_regression_preconditions());
-    }
-
     // compute abstract goal var-val pairs
     vector<FactPair> abstract_goals;
     for (FactProxy goal : task_proxy.get_goals()) {
@@ -225,59 +335,123 @@ void PatternDatabase::create_pdb(
         }
     }
 
-    distances.reserve(num_states);
-    // first implicit entry: priority, second entry: index for an abstract state
-    priority_queues::AdaptiveQueue<size_t> pq;
-
-    // initialize queue
-    for (size_t state_index = 0; state_index < num_states; ++state_index) {
-        if (is_goal_state(state_index, abstract_goals, variables)) {
-            pq.push(0, state_index);
-            distances.push_back(0);
-        } else {
-            distances.push_back(numeric_limits<int>::max());
+    uint64_t cache_key = 0;
+    string cache_filename;
+    if (table_options.uses_cache()) {
+        cache_key = compute_cache_key(
+            operators, abstract_goals, variables, table_options.format);
+        ostringstream filename;
+        filename << table_options.cache_directory << "/pdb-" << hex
+                 << cache_key << ".bin";
+        cache_filename = filename.str();
+        unique_ptr<DistanceTable> cached_distances = DistanceTable::load(
+            cache_filename, cache_key, table_options.format, num_states);
+        if (cached_distances) {
+            distances = move(*cached_distances);
+            return;
         }
     }
 
-    // Dijkstra loop
-    while (!pq.empty()) {
-        pair<int, size_t> node = pq.pop();
-        int distance = node.first;
-        size_t state_index = node.second;
-        if (distance > distances[state_index]) {
-            continue;
-        }
+    // build the match tree
+    MatchTree match_tree(task_proxy, pattern, hash_multipliers);
+    for (size_t op_id = 0; op_id < operators.size(); ++op_id) {
+        const AbstractOperator &op = operators[op_id];
+        match_tree.insert(op_id, op.get_regression_preconditions());
+    }
 
-        // regress abstract_state
-        vector<int> applicable_operator_ids;
-        match_tree.get_applicable_operator_ids(state_index, applicable_operator_ids);
-        for (int op_id : applicable_operator_ids) {
-            const AbstractOperator &op = operators[op_id];
-            size_t predecessor = state_index + op.get_hash_effect();
-            int alternative_cost = distances[state_index] + op.get_cost();
-            if (alternative_cost < distances[predecessor]) {
-                distances[predecessor] = alternative_cost;
-                pq.push(alternative_cost, predecessor);
-            }
-        }
+    vector<int> exact_distances(num_states, numeric_limits<int>::max());
+    vector<size_t> goal_states =
+        compute_goal_state_indices(abstract_goals, variables);
+    for (size_t state_index : goal_states) {
+        exact_distances[state_index] = 0;
+    }
+
+    int min_cost = numeric_limits<int>::max();
+    int max_cost = 0;
+    for (const AbstractOperator &op : operators) {
+        min_cost = min(min_cost, op.get_cost());
+        max_cost = max(max_cost, op.get_cost());
+    }
+    if (operators.empty()) {
+        // Only the goal states have a finite distance.
+    } else if (min_cost == max_cost && min_cost > 0) {
+        compute_distances_breadth_first(
+            match_tree, operators, move(goal_states), exact_distances);
+    } else if (max_cost <= MAX_COST_FOR_BUCKETS) {
+        compute_distances_with_buckets(
+            match_tree, operators, max_cost, move(goal_states),
+            exact_distances);
+    } else {
+        compute_distances_dijkstra(
+            match_tree, operators, goal_states, exact_distances);
+    }
+
+    distances = DistanceTable(move(exact_distances), table_options.format);
+    if (table_options.uses_cache() &&
+        !distances.save(cache_filename, cache_key)) {
+        // Several threads may build PDBs, so write the warning at once.
+        cerr << "Warning: could not write PDB cache file " + cache_filename + "\n";
+    }
+}
+
+uint64_t PatternDatabase::compute_cache_key(
+    const vector<AbstractOperator> &operators,
+    const vector<FactPair> &abstract_goals,
+    const VariablesProxy &variables,
+    DistanceFormat format) const {
+    utils::HashState hash_state;
+    utils::feed(hash_state, static_cast<int>(format));
+    for (int var_id : pattern) {
+        utils::feed(hash_state, variables[var_id].get_domain_size());
+    }
+    utils::feed(hash_state, abstract_goals);
+    utils::feed(hash_state, static_cast<uint64_t>(operators.size()));
+    for (const AbstractOperator &op : operators) {
+        utils::feed(hash_state, op.get_cost());
+        utils::feed(hash_state, static_cast<uint64_t>(op.get_hash_effect()));
+        utils::feed(hash_state, op.get_regression_preconditions());
     }
+    return hash_state.get_hash64();
 }
 
-bool PatternDatabase::is_goal_state(
-    const size_t state_index,
+vector<size_t> PatternDatabase::compute_goal_state_indices(
     const vector<FactPair> &abstract_goals,
     const VariablesProxy &variables) const {
+    vector<int> goal_values(pattern.size(), -1);
     for (const FactPair &abstract_goal : abstract_goals) {
-        int pattern_var_id = abstract_goal.var;
-        int var_id = pattern[pattern_var_id];
-        VariableProxy var = variables[var_id];
-        int temp = state_index / hash_multipliers[pattern_var_id];
-        int val = temp % var.get_domain_size();
-        if (val != abstract_goal.value) {
-            return false;
+        goal_values[abstract_goal.var] = abstract_goal.value;
+    }
+    size_t index = 0;
+    vector<int> free_pattern_vars;
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        if (goal_values[i] == -1) {
+            free_pattern_vars.push_back(i);
+        } else {
+            index += hash_multipliers[i] * goal_values[i];
+        }
+    }
+
+    // Count through the values of the free variables (mixed radix).
+    vector<size_t> goal_states;
+    vector<int> values(free_pattern_vars.size(), 0);
+    while (true) {
+        goal_states.push_back(index);
+        size_t pos = 0;
+        for (; pos < free_pattern_vars.size(); ++pos) {
+            int pattern_var_id = free_pattern_vars[pos];
+            int domain_size = variables[pattern[pattern_var_id]].get_domain_size();
+            if (++values[pos] < domain_size) {
+                index += hash_multipliers[pattern_var_id];
+                break;
+            }
+            index -= (domain_size - 1) * hash_multipliers[pattern_var_id];
+            values[pos] = 0;
+        }
+        if (pos == free_pattern_vars.size()) {
+            break;
         }
     }
-    return true;
+    return goal_states;
 }
 
 size_t PatternDatabase::hash_index(const vector<int> &state) const {
@@ -289,15 +463,16 @@ size_t PatternDatabase::hash_index(const vector<int> &state) const {
 }
 
 int PatternDatabase::get_value(const vector<int> &state) const {
-    return distances[hash_index(state)];
+    return distances.get(hash_index(state));
 }
 
 double PatternDatabase::compute_mean_finite_h() const {
     double sum = 0;
     int size = 0;
     for (size_t i = 0; i < distances.size(); ++i) {
-        if (distances[i] != numeric_limits<int>::max()) {
-            sum += distances[i];
+        int distance = distances.get(i);
+        if (distance != numeric_limits<int>::max()) {
+            sum += distance;
             ++size;
         }
     }
@@ -1,6 +1,7 @@
 #ifndef PDBS_PATTERN_DATABASE_H
 #define PDBS_PATTERN_DATABASE_H
 
+#include "distance_table.h"
 #include "types.h"
 
 #include "../task_proxy.h"
@@ -80,7 +81,7 @@ class PatternDatabase {
       final h-values for abstract-states.
       dead-ends are represented by numeric_limits<int>::max()
     */
-    std::vector<int> distances;
+    DistanceTable distances;
 
     // multipliers for each variable for perfect hash function
     std::vector<std::size_t> hash_multipliers;
@@ -115,23 +116,36 @@ class PatternDatabase {
 
     /*
       Computes all abstract operators, builds the match tree (successor
-      generator) and then does a Dijkstra regression search to compute
-      all final h-values (stored in distances). operator_costs can
+      generator) and then does a regression search to compute all final
+      h-values (stored in distances). The search is a breadth-first search
+      if all abstract operators have the same positive cost, uses a bucket
+      queue for small integer costs and a Dijkstra search otherwise. operator_costs can
       specify individual operator costs for each operator for action
       cost partitioning. If left empty, default operator costs are used.
+      If table_options specify a cache directory, the distances are loaded
+      from the cache if possible and stored in it otherwise.
     */
     void create_pdb(
         const TaskProxy &task_proxy,
-        const std::vector<int> &operator_costs = std::vector<int>());
+        const std::vector<int> &operator_costs,
+        const DistanceTableOptions &table_options);
 
     /*
-      For a given abstract state (given as index), the according values
-      for each variable in the state are computed and compared with the
-      given pairs of goal variables and values. Returns true iff the
-      state is a goal state.
+      Identifies the abstract task (and thus the distances) by the domain
+      sizes of the pattern variables, the abstract operators and goals.
     */
-    bool is_goal_state(
-        std::size_t state_index,
+    std::uint64_t compute_cache_key(
+        const std::vector<AbstractOperator> &operators,
+        const std::vector<FactPair> &abstract_goals,
+        const VariablesProxy &variables,
+        DistanceFormat format) const;
+
+    /*
+      Returns the indices of all abstract goal states. They are enumerated
+      by fixing the goal variables and counting through the values of the
+      other pattern variables, so no state index needs to be decoded.
+    */
+    std::vector<std::size_t> compute_goal_state_indices(
         const std::vector<FactPair> &abstract_goals,
         const VariablesProxy &variables) const;
 
@@ -151,16 +165,36 @@ public:
        operator_costs: Can specify individual operator costs for each
        operator. This is useful for action cost partitioning. If left
        empty, default operator costs are used.
+       table_options:  Format of the distance table and PDB cache.
     */
     PatternDatabase(
         const TaskProxy &task_proxy,
         const Pattern &pattern,
         bool dump = false,
-        const std::vector<int> &operator_costs = std::vector<int>());
+        const std::vector<int> &operator_costs = std::vector<int>(),
+        const DistanceTableOptions &table_options = DistanceTableOptions());
     ~PatternDatabase() = default;
 
     int get_value(const std::vector<int> &state) const;
 
+    // Returns the distance of the abstract state with the given index.
+    int get_value_for_index(std::size_t index) const {
+        return distances.get(index);
+    }
+
+    const DistanceTable &get_distance_table() const {
+        return distances;
+    }
+
+    /*
+      Returns the multipliers of the perfect hash function, i.e., the index
+      of an abstract state is the sum of hash_multipliers[i] times the value
+      of the variable pattern[i].
+    */
+    const std::vector<std::size_t> &get_hash_multipliers() const {
+        return hash_multipliers;
+    }
+
     // Returns the pattern (i.e. all variables used) of the PDB
     const Pattern &get_pattern() const {
         return pattern;
@@ -171,6 +205,11 @@ public:
         return num_states;
     }
 
+    // Returns the number of bytes used by the distance table
+    std::size_t get_num_table_bytes() const {
+        return distances.get_num_bytes();
+    }
+
     /*
       Returns the average h-value over all states, where dead-ends are
       ignored (they neither increase the sum of all h-values nor the
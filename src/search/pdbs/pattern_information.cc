@@ -23,7 +23,8 @@ bool PatternInformation::information_is_valid() const {
 
 void PatternInformation::create_pdb_if_missing() {
     if (!pdb) {
-        pdb = make_shared<PatternDatabase>(task_proxy, pattern);
+        pdb = make_shared<PatternDatabase>(
+            task_proxy, pattern, false, vector<int>(), table_options);
     }
 }
 
@@ -32,6 +33,11 @@ void PatternInformation::set_pdb(const shared_ptr<PatternDatabase> &pdb_) {
     assert(information_is_valid());
 }
 
+void PatternInformation::set_distance_table_options(
+    const DistanceTableOptions &table_options_) {
+    table_options = table_options_;
+}
+
 const Pattern &PatternInformation::get_pattern() const {
     return pattern;
 }
@@ -1,6 +1,7 @@
 #ifndef PDBS_PATTERN_INFORMATION_H
 #define PDBS_PATTERN_INFORMATION_H
 
+#include "distance_table.h"
 #include "types.h"
 
 #include "../task_proxy.h"
@@ -23,6 +24,7 @@ class PatternInformation {
     TaskProxy task_proxy;
     Pattern pattern;
     std::shared_ptr<PatternDatabase> pdb;
+    DistanceTableOptions table_options;
 
     void create_pdb_if_missing();
 
@@ -31,6 +33,8 @@ public:
     PatternInformation(const TaskProxy &task_proxy, Pattern pattern);
 
     void set_pdb(const std::shared_ptr<PatternDatabase> &pdb);
+    // Only affects the PDB if it has not been set or computed yet.
+    void set_distance_table_options(const DistanceTableOptions &table_options);
 
     TaskProxy get_task_proxy() const {
         return task_proxy;
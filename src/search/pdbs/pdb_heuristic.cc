@@ -1,5 +1,6 @@
 #include "pdb_heuristic.h"
 
+#include "distance_table.h"
 #include "pattern_database.h"
 #include "pattern_generator.h"
 
@@ -17,6 +18,7 @@ shared_ptr<PatternDatabase> get_pdb_from_options(const shared_ptr<AbstractTask>
     shared_ptr<PatternGenerator> pattern_generator =
         opts.get<shared_ptr<PatternGenerator>>("pattern");
     PatternInformation pattern_info = pattern_generator->generate(task);
+    pattern_info.set_distance_table_options(get_distance_table_options(opts));
     return pattern_info.get_pdb();
 }
 
@@ -47,6 +49,7 @@ static shared_ptr<Heuristic> _parse(OptionParser &parser) {
         "pattern",
         "pattern generation method",
         "greedy()");
+    add_distance_table_options_to_parser(parser);
     Heuristic::add_options_to_parser(parser);
 
     Options opts = parser.parse();
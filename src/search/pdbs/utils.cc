@@ -4,10 +4,13 @@
 #include "pattern_database.h"
 #include "pattern_information.h"
 
+#include "../algorithms/thread_pool.h"
 #include "../utils/logging.h"
 
 #include "../task_proxy.h"
 
+#include <cassert>
+
 using namespace std;
 
 namespace pdbs {
@@ -28,6 +31,24 @@ int compute_total_pdb_size(
     return size;
 }
 
+PDBCollection compute_pdbs(
+    const TaskProxy &task_proxy,
+    const PatternCollection &patterns,
+    thread_pool::ThreadPool &pool,
+    const DistanceTableOptions &table_options,
+    const vector<vector<int>> &operator_costs) {
+    assert(operator_costs.empty() || operator_costs.size() == patterns.size());
+    const vector<int> default_costs;
+    PDBCollection pdbs(patterns.size());
+    pool.run(patterns.size(), [&](int i) {
+                 pdbs[i] = make_shared<PatternDatabase>(
+                     task_proxy, patterns[i], false,
+                     operator_costs.empty() ? default_costs : operator_costs[i],
+                     table_options);
+             });
+    return pdbs;
+}
+
 void dump_pattern_generation_statistics(
     const string &identifier,
     utils::Duration runtime,
@@ -1,15 +1,21 @@
 #ifndef PDBS_UTILS_H
 #define PDBS_UTILS_H
 
+#include "distance_table.h"
 #include "types.h"
 
 #include "../utils/timer.h"
 
 #include <memory>
 #include <string>
+#include <vector>
 
 class TaskProxy;
 
+namespace thread_pool {
+class ThreadPool;
+}
+
 namespace pdbs {
 class PatternCollectionInformation;
 class PatternInformation;
@@ -18,6 +24,18 @@ extern int compute_pdb_size(const TaskProxy &task_proxy, const Pattern &pattern)
 extern int compute_total_pdb_size(
     const TaskProxy &task_proxy, const PatternCollection &pattern_collection);
 
+/*
+  Compute the PDBs for the given patterns with the threads of the given
+  pool. If operator_costs is not empty, it contains the operator costs used
+  for each pattern. The result does not depend on the number of threads.
+*/
+extern PDBCollection compute_pdbs(
+    const TaskProxy &task_proxy,
+    const PatternCollection &patterns,
+    thread_pool::ThreadPool &pool,
+    const DistanceTableOptions &table_options,
+    const std::vector<std::vector<int>> &operator_costs = {});
+
 /*
   Dump the given pattern, the number of variables contained, the size of the
   corresponding PDB, and the runtime used for computing it. All output is
@@ -1,58 +1,89 @@
 #include "zero_one_pdbs.h"
 
 #include "pattern_database.h"
+#include "utils.h"
 
 #include "../task_proxy.h"
 
+#include "../algorithms/thread_pool.h"
 #include "../utils/logging.h"
 
+#include <algorithm>
 #include <iostream>
 #include <limits>
 #include <memory>
+#include <numeric>
 #include <vector>
 
 using namespace std;
 
 namespace pdbs {
-ZeroOnePDBs::ZeroOnePDBs(
-    const TaskProxy &task_proxy, const PatternCollection &patterns) {
+static bool is_operator_relevant(
+    const Pattern &pattern, const OperatorProxy &op) {
+    for (EffectProxy effect : op.get_effects()) {
+        int var_id = effect.get_fact().get_variable().get_id();
+        if (binary_search(pattern.begin(), pattern.end(), var_id)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static PDBCollection compute_zero_one_pdbs(
+    const TaskProxy &task_proxy, const PatternCollection &patterns,
+    thread_pool::ThreadPool &pool,
+    const DistanceTableOptions &table_options) {
     vector<int> remaining_operator_costs;
     OperatorsProxy operators = task_proxy.get_operators();
     remaining_operator_costs.reserve(operators.size());
     for (OperatorProxy op : operators)
         remaining_operator_costs.push_back(op.get_cost());
 
-    pattern_databases.reserve(patterns.size());
+    vector<vector<int>> operator_costs;
+    operator_costs.reserve(patterns.size());
     for (const Pattern &pattern : patterns) {
-        shared_ptr<PatternDatabase> pdb = make_shared<PatternDatabase>(
-            task_proxy, pattern, false, remaining_operator_costs);
+        operator_costs.push_back(remaining_operator_costs);
 
         /* Set cost of relevant operators to 0 for further iterations
            (action cost partitioning). */
         for (OperatorProxy op : operators) {
-            if (pdb->is_operator_relevant(op))
+            if (is_operator_relevant(pattern, op))
                 remaining_operator_costs[op.get_id()] = 0;
         }
-
-        pattern_databases.push_back(pdb);
     }
+
+    return compute_pdbs(
+        task_proxy, patterns, pool, table_options, operator_costs);
 }
 
+static shared_ptr<vector<PatternClique>> get_single_clique(int num_pdbs) {
+    PatternClique clique(num_pdbs);
+    iota(clique.begin(), clique.end(), 0);
+    return make_shared<vector<PatternClique>>(1, clique);
+}
+
+ZeroOnePDBs::ZeroOnePDBs(
+    const TaskProxy &task_proxy, const PatternCollection &patterns,
+    thread_pool::ThreadPool &pool,
+    const DistanceTableOptions &table_options)
+    : pattern_databases(
+          compute_zero_one_pdbs(task_proxy, patterns, pool, table_options)),
+      canonical_pdbs(
+          make_shared<PDBCollection>(pattern_databases),
+          get_single_clique(pattern_databases.size())) {
+}
 
 int ZeroOnePDBs::get_value(const State &state) const {
     /*
       Because we use cost partitioning, we can simply add up all
       heuristic values of all patterns in the pattern collection.
     */
-    state.unpack();
-    int h_val = 0;
-    for (const shared_ptr<PatternDatabase> &pdb : pattern_databases) {
-        int pdb_value = pdb->get_value(state.get_unpacked_values());
-        if (pdb_value == numeric_limits<int>::max())
-            return numeric_limits<int>::max();
-        h_val += pdb_value;
-    }
-    return h_val;
+    return canonical_pdbs.get_value(state);
+}
+
+void ZeroOnePDBs::get_values(
+    const vector<State> &states, vector<int> &values) const {
+    canonical_pdbs.get_values(states, values);
 }
 
 double ZeroOnePDBs::compute_approx_mean_finite_h() const {
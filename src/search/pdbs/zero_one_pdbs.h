@@ -1,19 +1,41 @@
 #ifndef PDBS_ZERO_ONE_PDBS_H
 #define PDBS_ZERO_ONE_PDBS_H
 
+#include "canonical_pdbs.h"
+#include "distance_table.h"
 #include "types.h"
 
+#include <vector>
+
 class State;
 class TaskProxy;
 
+namespace thread_pool {
+class ThreadPool;
+}
+
 namespace pdbs {
 class ZeroOnePDBs {
     PDBCollection pattern_databases;
+    /*
+      The PDBs are additive, so we evaluate them as canonical PDBs with a
+      single pattern clique containing all PDBs.
+    */
+    CanonicalPDBs canonical_pdbs;
 public:
-    ZeroOnePDBs(const TaskProxy &task_proxy, const PatternCollection &patterns);
+    /*
+      The operator costs of each PDB only depend on the preceding patterns,
+      so the PDBs are computed in parallel with the given thread pool.
+    */
+    ZeroOnePDBs(
+        const TaskProxy &task_proxy, const PatternCollection &patterns,
+        thread_pool::ThreadPool &pool,
+        const DistanceTableOptions &table_options);
     ~ZeroOnePDBs() = default;
 
     int get_value(const State &state) const;
+    void get_values(
+        const std::vector<State> &states, std::vector<int> &values) const;
     /*
       Returns the sum of all mean finite h-values of every PDB.
       This is an approximation of the real mean finite h-value of the Heuristic,
@@ -1,10 +1,13 @@
 #include "zero_one_pdbs_heuristic.h"
 
+#include "distance_table.h"
 #include "pattern_generator.h"
 
 #include "../option_parser.h"
 #include "../plugin.h"
 
+#include "../algorithms/thread_pool.h"
+
 using namespace std;
 
 namespace pdbs {
@@ -17,7 +20,9 @@ ZeroOnePDBs get_zero_one_pdbs_from_options(
     shared_ptr<PatternCollection> patterns =
         pattern_collection_info.get_patterns();
     TaskProxy task_proxy(*task);
-    return ZeroOnePDBs(task_proxy, *patterns);
+    thread_pool::ThreadPool pool(pattern_collection_info.get_num_threads());
+    return ZeroOnePDBs(
+        task_proxy, *patterns, pool, get_distance_table_options(opts));
 }
 
 ZeroOnePDBsHeuristic::ZeroOnePDBsHeuristic(
@@ -34,6 +39,21 @@ int ZeroOnePDBsHeuristic::compute_heuristic(const State &ancestor_state) {
     return h;
 }
 
+void ZeroOnePDBsHeuristic::compute_heuristics(
+    const vector<State> &ancestor_states, vector<int> &heuristics) {
+    vector<State> states;
+    states.reserve(ancestor_states.size());
+    for (const State &ancestor_state : ancestor_states) {
+        states.push_back(convert_ancestor_state(ancestor_state));
+    }
+    zero_one_pdbs.get_values(states, heuristics);
+    for (int &h : heuristics) {
+        if (h == numeric_limits<int>::max()) {
+            h = DEAD_END;
+        }
+    }
+}
+
 static shared_ptr<Heuristic> _parse(OptionParser &parser) {
     parser.document_synopsis(
         "Zero-One PDB",
@@ -58,6 +78,7 @@ static shared_ptr<Heuristic> _parse(OptionParser &parser) {
         "patterns",
         "pattern generation method",
         "systematic(1)");
+    add_distance_table_options_to_parser(parser);
     Heuristic::add_options_to_parser(parser);
 
     Options opts = parser.parse();
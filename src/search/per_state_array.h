@@ -27,6 +27,10 @@ public:
         return p[index];
     }
 
+    T *data() const {
+        return p;
+    }
+
     int size() const {
         return size_;
     }
@@ -46,20 +50,22 @@ public:
 template<class Element>
 class PerStateArray : public subscriber::Subscriber<StateRegistry> {
     const std::vector<Element> default_array;
+    using EntryArrayVector = segmented_vector::SegmentedArrayVector<
+        Element, segment_storage::SegmentAllocator<Element>>;
     using EntryArrayVectorMap = std::unordered_map<const StateRegistry *,
-                                                   segmented_vector::SegmentedArrayVector<Element> *>;
+                                                   EntryArrayVector *>;
     EntryArrayVectorMap entry_arrays_by_registry;
 
     mutable const StateRegistry *cached_registry;
-    mutable segmented_vector::SegmentedArrayVector<Element> *cached_entries;
+    mutable EntryArrayVector *cached_entries;
 
-    segmented_vector::SegmentedArrayVector<Element> *get_entries(const StateRegistry *registry) {
+    EntryArrayVector *get_entries(const StateRegistry *registry) {
         if (cached_registry != registry) {
             cached_registry = registry;
             auto it = entry_arrays_by_registry.find(registry);
             if (it == entry_arrays_by_registry.end()) {
-                cached_entries = new segmented_vector::SegmentedArrayVector<Element>(
-                    default_array.size());
+                cached_entries = new EntryArrayVector(
+                    default_array.size(), registry->get_segment_storage());
                 entry_arrays_by_registry[registry] = cached_entries;
                 registry->subscribe(this);
             } else {
@@ -70,7 +76,7 @@ class PerStateArray : public subscriber::Subscriber<StateRegistry> {
         return cached_entries;
     }
 
-    const segmented_vector::SegmentedArrayVector<Element> *get_entries(
+    const EntryArrayVector *get_entries(
         const StateRegistry *registry) const {
         if (cached_registry != registry) {
             const auto it = entry_arrays_by_registry.find(registry);
@@ -78,7 +84,7 @@ class PerStateArray : public subscriber::Subscriber<StateRegistry> {
                 return nullptr;
             } else {
                 cached_registry = registry;
-                cached_entries = const_cast<segmented_vector::SegmentedArrayVector<Element> *>(
+                cached_entries = const_cast<EntryArrayVector *>(
                     it->second);
             }
         }
@@ -109,7 +115,7 @@ public:
                       << "state." << std::endl;
             utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
         }
-        segmented_vector::SegmentedArrayVector<Element> *entries = get_entries(registry);
+        EntryArrayVector *entries = get_entries(registry);
         int state_id = state.get_id().value;
         assert(state.get_id() != StateID::no_state);
         size_t virtual_size = registry->size();
@@ -120,16 +126,26 @@ public:
         return ArrayView<Element>((*entries)[state_id], default_array.size());
     }
 
-    ArrayView<Element> operator[](const State &) const {
-        ABORT("PerStateArray::operator[] const not implemented. "
-              "See source code for more information.");
-        /*
-          This method is not implemented because it is currently not used and
-          would require quite a bit of boilerplate, introducing a ConstArrayView
-          class similar to ArrayView. If you need it, it should be easy to
-          implement based on PerStateInformation:operator[] const. This method
-          should return a ConstArrayView<Element>.
-        */
+    ArrayView<const Element> operator[](const State &state) const {
+        const StateRegistry *registry = state.get_registry();
+        if (!registry) {
+            std::cerr << "Tried to access per-state array with an unregistered "
+                      << "state." << std::endl;
+            utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+        }
+        const EntryArrayVector *entries = get_entries(registry);
+        int size = default_array.size();
+        if (!entries) {
+            return ArrayView<const Element>(default_array.data(), size);
+        }
+        int state_id = state.get_id().value;
+        assert(state.get_id() != StateID::no_state);
+        assert(utils::in_bounds(state_id, *registry));
+        int num_entries = entries->size();
+        if (state_id >= num_entries) {
+            return ArrayView<const Element>(default_array.data(), size);
+        }
+        return ArrayView<const Element>((*entries)[state_id], size);
     }
 
     virtual void notify_service_destroyed(const StateRegistry *registry) override {
@@ -37,8 +37,10 @@ int main(int argc, const char **argv) {
     // check for simple input errors, and then in normal mode.
     try {
         options::Registry registry(*options::RawRegistry::instance());
+        // The dry run must not leave its (empty) predefinitions behind.
+        options::Predefinitions dry_run_predefinitions;
+        parse_cmd_line(argc, argv, registry, dry_run_predefinitions, true, unit_cost);
         options::Predefinitions predefinitions;
-        parse_cmd_line(argc, argv, registry, predefinitions, true, unit_cost);
         engine = parse_cmd_line(argc, argv, registry, predefinitions, false, unit_cost);
     } catch (const ArgError &error) {
         error.print();
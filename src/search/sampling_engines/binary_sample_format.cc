@@ -0,0 +1,214 @@
+#include "binary_sample_format.h"
+
+#include "../task_proxy.h"
+
+#include "../utils/system.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+
+#ifdef USE_ZLIB
+#include <zlib.h>
+#endif
+
+using namespace std;
+
+namespace sampling_engine {
+static const string BINARY_SAMPLE_MAGIC_WORD = "FDBSAMPLES";
+
+static vector<int> get_packer_ranges(const AbstractTask &task) {
+    // One additional value per variable for unassigned/undefined values.
+    vector<int> ranges;
+    ranges.reserve(task.get_num_variables());
+    for (int var = 0; var < task.get_num_variables(); ++var) {
+        ranges.push_back(task.get_variable_domain_size(var) + 1);
+    }
+    return ranges;
+}
+
+BinarySampleFormat::BinarySampleFormat(
+    const AbstractTask &task, Compression compression)
+    : packer(get_packer_ranges(task)),
+      compression(compression) {
+    for (int var = 0; var < task.get_num_variables(); ++var) {
+        domain_sizes.push_back(task.get_variable_domain_size(var));
+        variable_names.push_back(task.get_variable_name(var));
+        fact_names.emplace_back();
+        for (int val = 0; val < domain_sizes.back(); ++val) {
+            fact_names.back().push_back(task.get_fact_name(FactPair(var, val)));
+        }
+    }
+#ifndef USE_ZLIB
+    if (compression == Compression::ZLIB) {
+        cerr << "zlib compression of samples requires the planner to be "
+                "compiled with zlib." << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+    }
+#endif
+}
+
+void BinarySampleFormat::push_varint(string &buffer, uint64_t value) {
+    while (value >= 0x80) {
+        buffer.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    buffer.push_back(static_cast<char>(value));
+}
+
+void BinarySampleFormat::push_signed_varint(string &buffer, int64_t value) {
+    // Zigzag encoding maps small negative numbers to small varints.
+    push_varint(buffer, (static_cast<uint64_t>(value) << 1) ^
+                static_cast<uint64_t>(value >> 63));
+}
+
+void BinarySampleFormat::push_string(string &buffer, const string &str) {
+    push_varint(buffer, str.size());
+    buffer.append(str);
+}
+
+void BinarySampleFormat::push_packed(
+    string &buffer, const vector<int> &values) const {
+    assert(values.size() == domain_sizes.size());
+    vector<int_packer::IntPacker::Bin> bins(packer.get_num_bins(), 0);
+    for (size_t var = 0; var < values.size(); ++var) {
+        packer.set(bins.data(), var, values[var]);
+    }
+    for (int_packer::IntPacker::Bin bin : bins) {
+        for (int byte = 0; byte < 4; ++byte) {
+            buffer.push_back(static_cast<char>((bin >> (8 * byte)) & 0xFF));
+        }
+    }
+}
+
+const vector<string> &BinarySampleFormat::get_sample_types() {
+    static const vector<string> sample_types = {
+        "init", "inter", "trajectory_init", "trajectory_inter", "visited"};
+    return sample_types;
+}
+
+string BinarySampleFormat::encode_meta(
+    size_t modification_hash, const string &sample_type) const {
+    const vector<string> &sample_types = get_sample_types();
+    auto iter = find(sample_types.begin(), sample_types.end(), sample_type);
+    assert(iter != sample_types.end());
+    string buffer;
+    buffer.push_back(static_cast<char>(iter - sample_types.begin()));
+    uint64_t hash = modification_hash;
+    for (int byte = 0; byte < 8; ++byte) {
+        buffer.push_back(static_cast<char>((hash >> (8 * byte)) & 0xFF));
+    }
+    return buffer;
+}
+
+string BinarySampleFormat::encode_state(const State &state) const {
+    state.unpack();
+    string buffer;
+    push_packed(buffer, state.get_unpacked_values());
+    return buffer;
+}
+
+string BinarySampleFormat::encode_goals(const GoalsProxy &goals) const {
+    vector<int> values(domain_sizes);
+    for (FactProxy goal : goals) {
+        FactPair fact = goal.get_pair();
+        values[fact.var] = fact.value;
+    }
+    string buffer;
+    push_packed(buffer, values);
+    return buffer;
+}
+
+void BinarySampleFormat::write_header(
+    ostream &out, int fields, const vector<string> &heuristic_names) const {
+    string header = BINARY_SAMPLE_MAGIC_WORD;
+    push_varint(header, VERSION);
+    push_varint(header, fields);
+    push_varint(header, compression);
+    push_varint(header, get_sample_types().size());
+    for (const string &sample_type : get_sample_types()) {
+        push_string(header, sample_type);
+    }
+    push_varint(header, heuristic_names.size());
+    for (const string &name : heuristic_names) {
+        push_string(header, name);
+    }
+    push_varint(header, packer.get_num_bins());
+    push_varint(header, domain_sizes.size());
+    for (size_t var = 0; var < domain_sizes.size(); ++var) {
+        push_string(header, variable_names[var]);
+        push_varint(header, domain_sizes[var]);
+        push_varint(header, packer.get_bin_index(var));
+        push_varint(header, packer.get_shift(var));
+        push_varint(header, packer.get_num_bits(var));
+        for (const string &fact_name : fact_names[var]) {
+            push_string(header, fact_name);
+        }
+    }
+    out.write(header.data(), header.size());
+}
+
+void BinarySampleFormat::write_block(
+    ostream &out, const string &raw, size_t num_samples) const {
+    string block_header;
+    push_varint(block_header, num_samples);
+    push_varint(block_header, raw.size());
+    if (compression == Compression::NONE) {
+        push_varint(block_header, raw.size());
+        out.write(block_header.data(), block_header.size());
+        out.write(raw.data(), raw.size());
+    } else {
+#ifdef USE_ZLIB
+        assert(compression == Compression::ZLIB);
+        uLongf compressed_size = compressBound(raw.size());
+        string compressed(compressed_size, '\0');
+        if (compress2(reinterpret_cast<Bytef *>(&compressed[0]),
+                      &compressed_size,
+                      reinterpret_cast<const Bytef *>(raw.data()),
+                      raw.size(), Z_DEFAULT_COMPRESSION) != Z_OK) {
+            cerr << "Compression of sample block failed." << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+        }
+        push_varint(block_header, compressed_size);
+        out.write(block_header.data(), block_header.size());
+        out.write(compressed.data(), compressed_size);
+#else
+        ABORT("Planner compiled without zlib.");
+#endif
+    }
+}
+
+void BinarySampleFormat::write(
+    ostream &out, const vector<string> &samples, int fields,
+    const vector<string> &heuristic_names) const {
+    const size_t block_size = 1 << 20;
+    write_header(out, fields, heuristic_names);
+    string raw;
+    size_t num_samples = 0;
+    for (const string &sample : samples) {
+        push_string(raw, sample);
+        ++num_samples;
+        if (raw.size() >= block_size) {
+            write_block(out, raw, num_samples);
+            raw.clear();
+            num_samples = 0;
+        }
+    }
+    if (num_samples > 0) {
+        write_block(out, raw, num_samples);
+    }
+    string end_marker;
+    push_varint(end_marker, 0);
+    out.write(end_marker.data(), end_marker.size());
+}
+
+BinarySampleFormat::Compression get_compression(const string &name) {
+    if (name == "none") {
+        return BinarySampleFormat::Compression::NONE;
+    } else if (name == "zlib") {
+        return BinarySampleFormat::Compression::ZLIB;
+    }
+    cerr << "Invalid sample compression: " << name << endl;
+    utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+}
+}
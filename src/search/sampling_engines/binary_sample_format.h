@@ -0,0 +1,102 @@
+#ifndef SEARCH_ENGINES_BINARY_SAMPLE_FORMAT_H
+#define SEARCH_ENGINES_BINARY_SAMPLE_FORMAT_H
+
+#include "../algorithms/int_packer.h"
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class AbstractTask;
+class GoalsProxy;
+class State;
+
+namespace sampling_engine {
+/*
+  Binary sample format. A sample file consists of one or more chunks (one per
+  write of the sample cache). Every chunk starts with a header followed by
+  blocks of samples and an end marker:
+
+    chunk  := "FDBSAMPLES" header block* varint(0)
+    header := varint(version) varint(fields) varint(compression)
+              list(sample_type_name) list(heuristic_name)
+              varint(num_bins) varint(num_variables) variable*
+    variable := string(name) varint(domain_size) varint(bin_index)
+                varint(shift) varint(num_bits) string(fact_name)*
+    block  := varint(num_samples) varint(raw_size) varint(stored_size) data
+
+  The data of a block are its samples (varint(length) sample)* and are
+  compressed if the compression in the header is not NONE. A sample
+  consists of the following parts, where the optional parts are present
+  if their flag is set in 'fields':
+
+    byte(sample_type) uint64(modification_hash) state [goal]
+    [byte(has_second_state) [state]] [varint(operator_id + 1)]
+    [byte(unsolved)] varint(num_heuristics) zigzag_varint(heuristic)*
+
+  The second state is the predecessor for samples of type "visited" and the
+  successor otherwise. States and goals are stored as num_bins
+  little-endian 32-bit bins. Each variable occupies the bits
+  [shift, shift + num_bits) of its bin. The value domain_size marks an
+  unassigned (goal) or undefined (partial state) variable.
+
+  All strings are stored as varint(length) followed by their characters.
+
+  misc/sampling/decode-binary-samples.py reads this format.
+*/
+class BinarySampleFormat {
+public:
+    enum Field {
+        GOAL = 1 << 0,
+        SECOND_STATE = 1 << 1,
+        ACTION = 1 << 2,
+        UNSOLVED = 1 << 3
+    };
+
+    enum Compression {
+        NONE = 0,
+        ZLIB = 1
+    };
+
+private:
+    static const int VERSION = 1;
+    std::vector<int> domain_sizes;
+    std::vector<std::string> variable_names;
+    std::vector<std::vector<std::string>> fact_names;
+    const int_packer::IntPacker packer;
+    const Compression compression;
+
+    void push_packed(std::string &buffer, const std::vector<int> &values) const;
+    void write_header(
+        std::ostream &out, int fields,
+        const std::vector<std::string> &heuristic_names) const;
+    void write_block(
+        std::ostream &out, const std::string &raw, size_t num_samples) const;
+
+public:
+    BinarySampleFormat(const AbstractTask &task, Compression compression);
+
+    static void push_varint(std::string &buffer, uint64_t value);
+    static void push_signed_varint(std::string &buffer, int64_t value);
+    static void push_string(std::string &buffer, const std::string &str);
+
+    /* Encode the sample type and the modification hash (the sample meta
+       data). The sample type has to be one of get_sample_types(). */
+    std::string encode_meta(
+        size_t modification_hash, const std::string &sample_type) const;
+    std::string encode_state(const State &state) const;
+    std::string encode_goals(const GoalsProxy &goals) const;
+
+    /* Write a chunk containing the given samples. Every sample has to be
+       encoded with the methods above. */
+    void write(
+        std::ostream &out, const std::vector<std::string> &samples,
+        int fields, const std::vector<std::string> &heuristic_names) const;
+
+    static const std::vector<std::string> &get_sample_types();
+};
+
+extern BinarySampleFormat::Compression get_compression(const std::string &name);
+}
+#endif
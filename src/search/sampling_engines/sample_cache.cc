@@ -4,8 +4,11 @@
 
 #include "../plan_manager.h"
 
+#include "../utils/binary_io.h"
+#include "../utils/memory.h"
 #include "../utils/system.h"
 
+#include <cstring>
 #include <fstream>
 #include <iostream>
 
@@ -13,6 +16,58 @@ using namespace std;
 
 namespace sampling_engine {
 
+DuplicateFilter::DuplicateFilter(int size_in_mb)
+    : bits((static_cast<uint64_t>(size_in_mb) << 20) / sizeof(uint64_t), 0),
+      num_bits(bits.size() * 64) {
+    assert(num_bits > 0);
+}
+
+static uint64_t fingerprint(const string &sample, uint32_t salt) {
+    utils::HashState hash_state;
+    hash_state.feed(salt);
+    utils::feed(hash_state, static_cast<uint64_t>(sample.size()));
+    size_t pos = 0;
+    for (; pos + sizeof(uint32_t) <= sample.size(); pos += sizeof(uint32_t)) {
+        uint32_t word;
+        memcpy(&word, sample.data() + pos, sizeof(word));
+        hash_state.feed(word);
+    }
+    uint32_t tail = 0;
+    memcpy(&tail, sample.data() + pos, sample.size() - pos);
+    hash_state.feed(tail);
+    return hash_state.get_hash64();
+}
+
+bool DuplicateFilter::insert(const string &sample) {
+    // Derive all bit positions from two hashes (Kirsch and Mitzenmacher).
+    uint64_t hash1 = fingerprint(sample, 0);
+    uint64_t hash2 = fingerprint(sample, 1) | 1;
+    bool is_new = false;
+    for (int i = 0; i < NUM_HASHES; ++i) {
+        uint64_t bit = (hash1 + i * hash2) % num_bits;
+        uint64_t mask = uint64_t(1) << (bit % 64);
+        uint64_t &word = bits[bit / 64];
+        if (!(word & mask)) {
+            word |= mask;
+            is_new = true;
+        }
+    }
+    return is_new;
+}
+
+void DuplicateFilter::save(utils::BinaryWriter &writer) const {
+    writer.write_vector(bits);
+}
+
+void DuplicateFilter::load(utils::BinaryReader &reader) {
+    vector<uint64_t> stored_bits = reader.read_vector<uint64_t>();
+    if (stored_bits.size() != bits.size()) {
+        cerr << "The stored duplicate filter has a different size." << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+    }
+    bits = move(stored_bits);
+}
+
 SampleCache::Iterator::Iterator(
         bool unique,
         std::vector<std::string>::iterator iter_vector,
@@ -54,8 +109,12 @@ utils::HashSet<std::string>::iterator SampleCache::Iterator::get_iter_set() {
     return iter_set;
 }
 
-SampleCache::SampleCache(bool unique_samples)
-    : unique_samples(unique_samples) {}
+SampleCache::SampleCache(bool unique_samples, int duplicate_filter_size)
+    : unique_samples(unique_samples),
+      duplicate_filter(duplicate_filter_size > 0 ?
+                       utils::make_unique_ptr<DuplicateFilter>(
+                           duplicate_filter_size) :
+                       nullptr) {}
 
 void SampleCache::erase(Iterator first, Iterator last) {
         if(unique_samples){
@@ -69,6 +128,50 @@ size_t SampleCache::size() const {
     return unique_samples ? unique_cache.size() : redundant_cache.size();
 }
 
+size_t SampleCache::get_num_filtered_duplicates() const {
+    return nb_filtered_duplicates;
+}
+
+void SampleCache::save(utils::BinaryWriter &writer) const {
+    writer.write<uint64_t>(nb_filtered_duplicates);
+    writer.write<uint64_t>(size());
+    if (unique_samples) {
+        for (const string &sample : unique_cache) {
+            writer.write_string(sample);
+        }
+    } else {
+        for (const string &sample : redundant_cache) {
+            writer.write_string(sample);
+        }
+    }
+    writer.write<bool>(duplicate_filter != nullptr);
+    if (duplicate_filter) {
+        duplicate_filter->save(writer);
+    }
+}
+
+void SampleCache::load(utils::BinaryReader &reader) {
+    nb_filtered_duplicates = reader.read<uint64_t>();
+    size_t num_samples = reader.read_size(sizeof(uint64_t));
+    unique_cache.clear();
+    redundant_cache.clear();
+    for (size_t i = 0; i < num_samples; ++i) {
+        if (unique_samples) {
+            unique_cache.insert(reader.read_string());
+        } else {
+            redundant_cache.push_back(reader.read_string());
+        }
+    }
+    if (reader.read<bool>() != (duplicate_filter != nullptr)) {
+        cerr << "The duplicate filter option differs from the checkpoint."
+             << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+    }
+    if (duplicate_filter) {
+        duplicate_filter->load(reader);
+    }
+}
+
 SampleCache::Iterator SampleCache::begin() {
     return Iterator(unique_samples, redundant_cache.begin(), unique_cache.begin());
 }
@@ -78,15 +181,77 @@ SampleCache::Iterator SampleCache::end() {
 }
 
 
+BackgroundSampleWriter::BackgroundSampleWriter(
+    const SamplingEngine &engine, size_t max_pending_jobs)
+    : engine(engine),
+      max_pending_jobs(max_pending_jobs),
+      thread(&BackgroundSampleWriter::run, this) {
+}
+
+BackgroundSampleWriter::~BackgroundSampleWriter() {
+    stop();
+}
+
+void BackgroundSampleWriter::run() {
+    unique_lock<mutex> lock(jobs_mutex);
+    while (true) {
+        jobs_changed.wait(lock, [this]() {return stopped || !jobs.empty();});
+        if (jobs.empty()) {
+            return;
+        }
+        /* Keep the job in the queue while writing it to bound the number
+           of samples in memory. */
+        Job &job = jobs.front();
+        lock.unlock();
+        ofstream outfile(job.filename, job.mode | ios::binary);
+        engine.write_samples(outfile, job.samples);
+        outfile.close();
+        if (outfile.fail()) {
+            cerr << "Could not write sample file: " << job.filename << endl;
+        }
+        lock.lock();
+        jobs.pop_front();
+        jobs_changed.notify_all();
+    }
+}
+
+void BackgroundSampleWriter::add(
+    const string &filename, ios::openmode mode, vector<string> &&samples) {
+    unique_lock<mutex> lock(jobs_mutex);
+    assert(!stopped);
+    jobs_changed.wait(
+        lock, [this]() {return jobs.size() < max_pending_jobs;});
+    jobs.push_back({filename, mode, move(samples)});
+    jobs_changed.notify_all();
+}
+
+void BackgroundSampleWriter::flush() {
+    unique_lock<mutex> lock(jobs_mutex);
+    jobs_changed.wait(lock, [this]() {return jobs.empty();});
+}
+
+void BackgroundSampleWriter::stop() {
+    {
+        lock_guard<mutex> lock(jobs_mutex);
+        stopped = true;
+    }
+    jobs_changed.notify_all();
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+
 SampleCacheManager::SampleCacheManager(
         SampleCache sample_cache, int max_size, bool iterate_sample_files,
         int max_sample_files, int index_sample_files,
-        SamplingEngine *engine)
-        : sample_cache(sample_cache),
+        bool background_writer, SamplingEngine *engine)
+        : sample_cache(move(sample_cache)),
           max_size(max_size),
           iterate_sample_files(iterate_sample_files),
           max_sample_files(max_sample_files),
           index_sample_files(index_sample_files),
+          background_writer(background_writer),
           engine(engine){
     if (max_size <= 0) {
         cerr << "The maximum cache size has be positive: "
@@ -109,19 +274,29 @@ void SampleCacheManager::write_to_disk() {
              sample_cache.size() - newly_written >= max_size) &&
            (max_sample_files == -1 || nb_files_written < max_sample_files)) {
 
-        ofstream outfile(
+        string filename =
                 engine->get_plan_manager().get_plan_filename() +
-                ((iterate_sample_files) ? to_string(index_sample_files++) : ""),
-                iterate_sample_files ? ios::trunc : ios::app);
-        outfile << engine->sample_file_header() << "\n";
+                ((iterate_sample_files) ? to_string(index_sample_files++) : "");
+        ios::openmode mode = iterate_sample_files ? ios::trunc : ios::app;
 
+        vector<string> samples;
         size_t nb_samples = 0;
         for (; iter != sample_cache.end() && nb_samples < max_size;
                ++iter, ++nb_samples) {
-            outfile << *iter << "\n";
+            samples.push_back(*iter);
         }
 
-        outfile.close();
+        if (background_writer) {
+            if (!writer) {
+                writer = utils::make_unique_ptr<BackgroundSampleWriter>(
+                    *engine, 2);
+            }
+            writer->add(filename, mode, move(samples));
+        } else {
+            ofstream outfile(filename, mode | ios::binary);
+            engine->write_samples(outfile, samples);
+            outfile.close();
+        }
         assert(is_finalized || nb_samples == max_size);
         newly_written += nb_samples;
         ++nb_files_written;
@@ -134,9 +309,34 @@ void SampleCacheManager::finalize() {
     assert (!is_finalized);
     is_finalized = true;
     write_to_disk();
+    if (writer) {
+        writer->stop();
+    }
+}
+
+void SampleCacheManager::save(utils::BinaryWriter &out) {
+    assert(!is_finalized);
+    if (writer) {
+        writer->flush();
+    }
+    out.write<int>(index_sample_files);
+    out.write<int>(nb_files_written);
+    out.write<int>(nb_samples_written);
+    sample_cache.save(out);
+}
+
+void SampleCacheManager::load(utils::BinaryReader &in) {
+    index_sample_files = in.read<int>();
+    nb_files_written = in.read<int>();
+    nb_samples_written = in.read<int>();
+    sample_cache.load(in);
 }
 
 size_t SampleCacheManager::size() const {
     return nb_samples_written + sample_cache.size();
 }
+
+size_t SampleCacheManager::get_num_filtered_duplicates() const {
+    return sample_cache.get_num_filtered_duplicates();
+}
 }
@@ -3,12 +3,46 @@
 
 #include "../utils/hash.h"
 
-#include <vector>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <ios>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
+
+namespace utils {
+class BinaryReader;
+class BinaryWriter;
+}
 
 namespace sampling_engine {
 class SamplingEngine;
 
+/*
+  Bloom filter over 128-bit fingerprints of samples. Its memory usage is
+  fixed, hence, it can detect duplicates among arbitrarily many samples
+  (e.g. across all writes of the sample cache). In exchange, a new sample is
+  wrongly considered a duplicate with a small probability which grows with
+  the number of samples inserted (about 1% for 10 bits per sample).
+*/
+class DuplicateFilter {
+    static const int NUM_HASHES = 7;
+    std::vector<std::uint64_t> bits;
+    const std::uint64_t num_bits;
+
+public:
+    explicit DuplicateFilter(int size_in_mb);
+
+    // Mark the sample as seen. Return false if it was (probably) seen before.
+    bool insert(const std::string &sample);
+
+    void save(utils::BinaryWriter &writer) const;
+    void load(utils::BinaryReader &reader);
+};
+
 class SampleCache {
 public:
     struct Iterator {
@@ -43,13 +77,25 @@ private:
     const bool unique_samples;
     std::vector<std::string> redundant_cache;
     std::unordered_set<std::string> unique_cache;
+    std::unique_ptr<DuplicateFilter> duplicate_filter;
+    size_t nb_filtered_duplicates = 0;
 
 public:
-    SampleCache(bool unique_samples);
+    SampleCache(bool unique_samples, int duplicate_filter_size);
 
     template<class AnyIterator>
     void insert(AnyIterator first, AnyIterator last) {
-        if (unique_samples) {
+        if (duplicate_filter) {
+            for (; first != last; ++first) {
+                if (!duplicate_filter->insert(*first)) {
+                    ++nb_filtered_duplicates;
+                } else if (unique_samples) {
+                    unique_cache.insert(*first);
+                } else {
+                    redundant_cache.push_back(*first);
+                }
+            }
+        } else if (unique_samples) {
             unique_cache.insert(first, last);
         } else {
             redundant_cache.insert(redundant_cache.end(), first, last);
@@ -59,6 +105,43 @@ public:
     Iterator begin();
     Iterator end();
     std::size_t size() const;
+    std::size_t get_num_filtered_duplicates() const;
+
+    // Store and restore the cached samples and the duplicate filter.
+    void save(utils::BinaryWriter &writer) const;
+    void load(utils::BinaryReader &reader);
+};
+
+/*
+  Writes sample files in a background thread. The number of pending files is
+  bounded, i.e. adding a file blocks while too many files are pending.
+*/
+class BackgroundSampleWriter {
+    struct Job {
+        std::string filename;
+        std::ios::openmode mode;
+        std::vector<std::string> samples;
+    };
+
+    const SamplingEngine &engine;
+    const size_t max_pending_jobs;
+    std::deque<Job> jobs;
+    bool stopped = false;
+    std::mutex jobs_mutex;
+    std::condition_variable jobs_changed;
+    std::thread thread;
+
+    void run();
+public:
+    BackgroundSampleWriter(const SamplingEngine &engine, size_t max_pending_jobs);
+    ~BackgroundSampleWriter();
+
+    void add(const std::string &filename, std::ios::openmode mode,
+             std::vector<std::string> &&samples);
+    // Wait until all pending files are written.
+    void flush();
+    // Write all pending files and stop the thread.
+    void stop();
 };
 
 class SampleCacheManager {
@@ -70,7 +153,9 @@ protected:
     const int max_sample_files;
 
     int index_sample_files;
+    const bool background_writer;
     sampling_engine::SamplingEngine *engine;
+    std::unique_ptr<BackgroundSampleWriter> writer;
     int nb_files_written = 0;
     int nb_samples_written = 0;
     bool is_finalized = false;
@@ -81,7 +166,7 @@ public:
             SampleCache sample_cache,
             int max_size, bool iterate_sample_files,
             int max_sample_files, int index_sample_files,
-            SamplingEngine *engine);
+            bool background_writer, SamplingEngine *engine);
     template<class AnyIterator>
     void insert(AnyIterator first, AnyIterator last) {
         assert (!is_finalized);
@@ -92,7 +177,15 @@ public:
     }
     void finalize();
     size_t size() const;
-
+    size_t get_num_filtered_duplicates() const;
+
+    /*
+      Store and restore the samples which are not yet written and the
+      counters of the written files. Saving waits until the background
+      writer has written all pending files.
+    */
+    void save(utils::BinaryWriter &out);
+    void load(utils::BinaryReader &in);
 };
 }
 #endif
@@ -3,14 +3,21 @@
 #include "../option_parser.h"
 
 #include "../sampling_techniques/technique_null.h"
+#include "../utils/binary_io.h"
+#include "../utils/countdown_timer.h"
+#include "../utils/memory.h"
+#include "../utils/rng.h"
+#include "../utils/rng_options.h"
 
 #include <cassert>
 #include <fstream>
 #include <iostream>
+#include <limits>
 #include <memory>
 #include <numeric>
 #include <set>
 #include <cstdio>
+#include <sstream>
 #include <string>
 
 
@@ -39,21 +46,73 @@ SamplingEngine::SamplingEngine(const options::Options &opts)
             opts.get_list<shared_ptr<sampling_technique::SamplingTechnique>>(
                 "techniques"))),
       current_technique(sampling_techniques.begin()),
-      sample_cache_manager(SampleCacheManager(
-              SampleCache(
-              opts.get<bool>("prune_duplicates")),
-              opts.get<int>("sample_cache_size"),
-              opts.get<bool>("iterate_sample_files"),
-              opts.get<int>("max_sample_files"),
-              opts.get<int>("index_sample_files"), this)),
-      rng(utils::parse_rng_from_options(opts)) {}
+      sample_cache_manager(
+          SampleCache(opts.get<bool>("prune_duplicates"),
+                      opts.get<int>("duplicate_filter_size")),
+          opts.get<int>("sample_cache_size"),
+          opts.get<bool>("iterate_sample_files"),
+          opts.get<int>("max_sample_files"),
+          opts.get<int>("index_sample_files"),
+          opts.get<bool>("background_writer"), this),
+      rng(utils::parse_rng_from_options(opts)),
+      num_workers(opts.get<int>("workers")) {}
 
 void SamplingEngine::initialize() {
     cout << "Initializing Sampling Engine...";
-    remove(plan_manager.get_plan_filename().c_str());
+    // A resumed engine continues the sample files of the previous run.
+    if (!is_resuming()) {
+        remove(plan_manager.get_plan_filename().c_str());
+    }
     cout << "done." << endl;
 }
 
+bool SamplingEngine::supports_checkpoints() const {
+    // The worker processes cannot be stopped in a consistent state.
+    return num_workers == 1;
+}
+
+void SamplingEngine::save_sampling_state(utils::BinaryWriter &writer) const {
+    writer.write_string(rng->get_state());
+    writer.write_string(utils::get_mt19937_state(utils::get_global_mt19937()));
+    writer.write<int>(current_technique - sampling_techniques.begin());
+    writer.write<int>(sampling_techniques.size());
+    for (const shared_ptr<sampling_technique::SamplingTechnique> &st :
+         sampling_techniques) {
+        st->save_state(writer);
+    }
+}
+
+void SamplingEngine::load_sampling_state(utils::BinaryReader &reader) {
+    rng->set_state(reader.read_string());
+    utils::set_mt19937_state(utils::get_global_mt19937(), reader.read_string());
+    int technique = reader.read<int>();
+    if (reader.read<int>() != static_cast<int>(sampling_techniques.size()) ||
+        technique < 0 ||
+        technique > static_cast<int>(sampling_techniques.size())) {
+        cerr << "The sampling techniques differ from the checkpoint." << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+    }
+    current_technique = sampling_techniques.begin() + technique;
+    for (const shared_ptr<sampling_technique::SamplingTechnique> &st :
+         sampling_techniques) {
+        st->load_state(reader);
+    }
+}
+
+void SamplingEngine::save_checkpoint(utils::BinaryWriter &writer) {
+    SearchEngine::save_checkpoint(writer);
+    save_sampling_state(writer);
+    sample_cache_manager.save(writer);
+}
+
+void SamplingEngine::load_checkpoint(utils::BinaryReader &reader) {
+    SearchEngine::load_checkpoint(reader);
+    load_sampling_state(reader);
+    sample_cache_manager.load(reader);
+    cout << "Resumed sampling with " << sample_cache_manager.size()
+         << " samples." << endl;
+}
+
 void SamplingEngine::update_current_technique() {
     if (shuffle_sampling_techniques) {
         current_technique = sampling_techniques.end();
@@ -90,6 +149,15 @@ void SamplingEngine::update_current_technique() {
 }
 
 SearchStatus SamplingEngine::step() {
+    if (num_workers > 1) {
+        return parallel_step();
+    }
+    if (uses_checkpoints()) {
+        ostringstream out(ios::binary);
+        utils::BinaryWriter writer(out);
+        save_sampling_state(writer);
+        state_before_step = out.str();
+    }
     update_current_technique();
     if (current_technique == sampling_techniques.end()) {
         return SOLVED;
@@ -97,13 +165,87 @@ SearchStatus SamplingEngine::step() {
 
     const shared_ptr<AbstractTask> next_task = (*current_technique)->next(task);
     vector<string> new_samples =  sample(next_task);
+    if (uses_checkpoints() && timer->is_expired()) {
+        // Sample the (possibly cut off) task again after resuming.
+        istringstream in(state_before_step, ios::binary);
+        utils::BinaryReader reader(in);
+        load_sampling_state(reader);
+        return TIMEOUT;
+    }
     sample_cache_manager.insert(new_samples.begin(), new_samples.end());
     return IN_PROGRESS;
 }
 
+SearchStatus SamplingEngine::parallel_step() {
+    if (!worker_pool) {
+        // Draw the seeds before forking to obtain one RNG stream per worker.
+        vector<int> worker_seeds;
+        for (int worker = 0; worker < num_workers; ++worker) {
+            worker_seeds.push_back((*rng)(numeric_limits<int>::max()));
+        }
+        cout << "Starting " << num_workers << " sampling workers." << endl;
+        worker_pool = utils::make_unique_ptr<SamplingWorkerPool>(num_workers);
+        worker_pool->start([this, &worker_seeds](int worker) {
+                               run_worker(worker, worker_seeds[worker]);
+                           });
+    }
+
+    vector<SamplingWorkerPool::Batch> batches;
+    bool running = worker_pool->receive(batches, 100);
+    for (SamplingWorkerPool::Batch &batch : batches) {
+        sampling_techniques[batch.technique]->register_worker_task();
+        sample_cache_manager.insert(batch.samples.begin(), batch.samples.end());
+    }
+    if (!running) {
+        return SOLVED;
+    }
+    if (timer->is_expired()) {
+        worker_pool->terminate();
+        return TIMEOUT;
+    }
+    return IN_PROGRESS;
+}
+
+void SamplingEngine::run_worker(int worker, int worker_seed) {
+    /*
+      Every worker samples its share of the tasks of every technique with
+      its own random number generators. The global generator is reseeded,
+      too, as some components use it by default.
+    */
+    utils::RandomNumberGenerator worker_rng(worker_seed);
+    rng->seed(worker_rng(numeric_limits<int>::max()));
+    utils::get_global_mt19937().seed(worker_rng(numeric_limits<int>::max()));
+    for (const shared_ptr<sampling_technique::SamplingTechnique> &st :
+         sampling_techniques) {
+        st->assign_to_worker(
+            worker, num_workers, worker_rng(numeric_limits<int>::max()));
+    }
+    current_technique = sampling_techniques.begin();
+
+    while (!timer->is_expired()) {
+        update_current_technique();
+        if (current_technique == sampling_techniques.end()) {
+            break;
+        }
+        int technique = current_technique - sampling_techniques.begin();
+        const shared_ptr<AbstractTask> next_task = (*current_technique)->next(task);
+        worker_pool->send(technique, sample(next_task));
+    }
+}
+
+void SamplingEngine::write_samples(
+    ostream &out, const vector<string> &samples) const {
+    out << sample_file_header() << "\n";
+    for (const string &sample : samples) {
+        out << sample << "\n";
+    }
+}
+
 void SamplingEngine::print_statistics() const {
     cout << "Generated Entries: " << (sample_cache_manager.size())
          << endl;
+    cout << "Filtered duplicate entries: "
+         << sample_cache_manager.get_num_filtered_duplicates() << endl;
     cout << "Sampling Techniques used:" << endl;
     for (auto &st : sampling_techniques) {
         cout << '\t' << st->get_name();
@@ -113,6 +255,11 @@ void SamplingEngine::print_statistics() const {
 }
 
 void SamplingEngine::save_plan_if_necessary() {
+    if (get_status() == TIMEOUT && uses_checkpoints()) {
+        cout << "The samples which are not yet written are kept in the "
+                "checkpoint." << endl;
+        return;
+    }
     sample_cache_manager.finalize();
 }
 
@@ -160,6 +307,34 @@ void SamplingEngine::add_sampling_options(options::OptionParser &parser) {
         "then duplicates are only pruned between samples which are in memory"
         "at the same time.",
         "false");
+    parser.add_option<int>(
+        "duplicate_filter_size",
+        "Size in MiB of a Bloom filter which removes duplicate samples "
+        "across all samples generated (also across writes of the sample "
+        "cache). Samples are compared by a 128-bit fingerprint of the whole "
+        "entry. With about 10 bits per sample, a new sample is wrongly "
+        "removed with a probability of about 1%. Use 0 to disable the "
+        "filter.",
+        "0",
+        Bounds("0", "infinity"));
+    parser.add_option<bool>(
+        "background_writer",
+        "Write the sample files in a background thread while sampling "
+        "continues. At most two full caches are waiting to be written at "
+        "any time.",
+        "false");
+    parser.add_option<int>(
+        "workers",
+        "Number of worker processes used for sampling. Every worker is "
+        "forked from the planner and owns its search engines, state "
+        "registries and random number generators and samples its share of "
+        "the tasks of every sampling technique. The samples are collected by "
+        "the planner and stored in a fixed round-robin order over the "
+        "workers, thus, for a fixed random seed and number of workers the "
+        "output is deterministic. Multiple workers are only supported on "
+        "Linux and macOS.",
+        "1",
+        Bounds("1", "infinity"));
     utils::add_rng_options(parser);
 }
 }
@@ -7,6 +7,7 @@
 #include "../utils/hash.h"
 
 #include "sample_cache.h"
+#include "sampling_worker_pool.h"
 
 #include <functional>
 #include <memory>
@@ -34,11 +35,27 @@ protected:
         sampling_technique::SamplingTechnique>>::const_iterator current_technique;
     SampleCacheManager sample_cache_manager;
     std::shared_ptr<utils::RandomNumberGenerator> rng;
+    const int num_workers;
+    std::unique_ptr<SamplingWorkerPool> worker_pool;
+    /*
+      With checkpoints, the sampling state before the current task. If the
+      task is cut off by the time limit, it is restored, such that the
+      resumed engine samples the task again.
+    */
+    std::string state_before_step;
 
 
     virtual void initialize() override;
+    virtual bool supports_checkpoints() const override;
+    virtual void save_checkpoint(utils::BinaryWriter &writer) override;
+    virtual void load_checkpoint(utils::BinaryReader &reader) override;
+    // Store and restore the random number generators and techniques.
+    virtual void save_sampling_state(utils::BinaryWriter &writer) const;
+    virtual void load_sampling_state(utils::BinaryReader &reader);
     virtual void update_current_technique();
     virtual SearchStatus step() override;
+    SearchStatus parallel_step();
+    void run_worker(int worker, int worker_seed);
     virtual std::vector<std::string> sample(
         std::shared_ptr<AbstractTask> task) = 0;
 public:
@@ -46,6 +63,13 @@ public:
     virtual ~SamplingEngine() = default;
 
     virtual std::string sample_file_header() const = 0;
+    /*
+      Write the given samples as one chunk (header plus samples) to out. This
+      might be called from the background writer of the sample cache and
+      may therefore only access members which are constant while sampling.
+    */
+    virtual void write_samples(
+        std::ostream &out, const std::vector<std::string> &samples) const;
     virtual void print_statistics() const override;
     virtual void save_plan_if_necessary() override;
 
@@ -8,6 +8,8 @@
 #include "../task_utils/successor_generator.h"
 #include "../task_utils/task_properties.h"
 
+#include "../utils/binary_io.h"
+
 #include <algorithm>
 #include <iostream>
 #include <memory>
@@ -42,6 +44,9 @@ string SamplingSearch::construct_meta(
         size_t modification_hash,
         const string &sample_type,
         const string &snd_state) {
+    if (sample_format == SampleFormat::BINARY) {
+        return binary_format->encode_meta(modification_hash, sample_type);
+    }
     return "{" + entry_meta_general + to_string(modification_hash) + "\", "
            "\"sample_type\": \"" + sample_type + "\", "
            "\"fields\": [{\"name\": \"current_state\", \"type\": \"state\", \"format\": \"FD\"}, " +
@@ -52,12 +57,52 @@ string SamplingSearch::construct_meta(
            entry_meta_heuristics + "]}";
 }
 
+string SamplingSearch::construct_goal(const GoalsProxy &goals) const {
+    if (sample_format == SampleFormat::BINARY) {
+        return binary_format->encode_goals(goals);
+    }
+    ostringstream stream_pddl_goal;
+    goals.dump_pddl(stream_pddl_goal, "\t");
+    return stream_pddl_goal.str();
+}
+
 
 void SamplingSearch::add_entry(
     vector<string> &new_entries, const string &meta, const State &state,
     const string &goal, const StateID &second_state_id,
     const OperatorID &op_id, const vector<int> *heuristics,
     const OperatorsProxy &ops, const StateRegistry &sr) {
+    if (sample_format == SampleFormat::BINARY) {
+        string entry = meta + binary_format->encode_state(state);
+        if (!skip_goal_field) {
+            entry += goal;
+        }
+        if (!skip_snd_state_field) {
+            bool has_second_state = second_state_id != StateID::no_state;
+            entry.push_back(has_second_state);
+            if (has_second_state) {
+                entry += binary_format->encode_state(
+                    sr.lookup_state(second_state_id));
+            }
+        }
+        if (!skip_action_field) {
+            BinarySampleFormat::push_varint(
+                entry, op_id == OperatorID::no_operator ?
+                0 : op_id.get_index() + 1);
+        }
+        if (add_unsolved_samples) {
+            entry.push_back(!engine->found_solution());
+        }
+        BinarySampleFormat::push_varint(
+            entry, heuristics == nullptr ? 0 : heuristics->size());
+        if (heuristics != nullptr) {
+            for (int h : *heuristics) {
+                BinarySampleFormat::push_signed_varint(entry, h);
+            }
+        }
+        new_entries.push_back(move(entry));
+        return;
+    }
     ostringstream stream;
     if (sample_format == SampleFormat::FIELDS) {
         stream << meta;
@@ -166,10 +211,15 @@ int SamplingSearch::extract_entries_trajectories(
     for (size_t idx_goal = trajectory.size(); idx_goal-- > min_idx_goal;) {
         if (pddl_goal.empty() || expand) {
             // TODO: Goal is to precise, can we make it more exact via Regression?
-            ostringstream stream_pddl_goal;
-            convert_and_push_state(
+            if (sample_format == SampleFormat::BINARY) {
+                string_pddl_goal = binary_format->encode_state(
+                    sr.lookup_state(trajectory[idx_goal]));
+            } else {
+                ostringstream stream_pddl_goal;
+                convert_and_push_state(
                     stream_pddl_goal, sr.lookup_state(trajectory[idx_goal]));
-            string_pddl_goal = stream_pddl_goal.str();
+                string_pddl_goal = stream_pddl_goal.str();
+            }
         }
         int heuristic = 0;
 
@@ -313,7 +363,8 @@ SamplingSearch::SamplingSearch(const options::Options &opts)
       successfully_solved_increment_threshold(
               successfully_solved_history_size * opts.get<double>("upgrade_solved_rate")){
     if (sample_format != SampleFormat::FIELDS &&
-        sample_format != SampleFormat::CSV) {
+        sample_format != SampleFormat::CSV &&
+        sample_format != SampleFormat::BINARY) {
         cerr << "Invalid sample format for sampling_search" << endl;
         utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
     }
@@ -358,21 +409,17 @@ vector<string> SamplingSearch::extract_samples() {
 
     if (store_expansions){
         if (engine->found_solution() || store_expansions_unsolved) {
-            ostringstream stream_pddl_goal;
-            gps.dump_pddl(stream_pddl_goal, "\t");
             vector<int> expansions = {engine->get_statistics().get_expanded()};
             add_entry(new_entries,
                       construct_meta(mod_hash, "init", "next_state"),
-                      tp.get_initial_state(), stream_pddl_goal.str(),
+                      tp.get_initial_state(), construct_goal(gps),
                       StateID::no_state, OperatorID::no_operator,
                       &expansions, ops, sr);
         } else if (add_unsolved_samples) {
-            ostringstream stream_pddl_goal;
-            gps.dump_pddl(stream_pddl_goal, "\t");
             vector<int> expansions = {-1};
             add_entry(new_entries,
                       construct_meta(mod_hash, "init", "next_state"),
-                      tp.get_initial_state(), stream_pddl_goal.str(),
+                      tp.get_initial_state(), construct_goal(gps),
                       StateID::no_state, OperatorID::no_operator,
                       &expansions, ops, sr);
         }
@@ -388,12 +435,10 @@ vector<string> SamplingSearch::extract_samples() {
                     construct_meta(mod_hash, "inter", "next_state"),
                     engine->get_plan(), trajectory);
         } else if (add_unsolved_samples) {
-            ostringstream stream_pddl_goal;
-            gps.dump_pddl(stream_pddl_goal, "\t");
             vector<int> h_value = {-1};
             add_entry(new_entries,
                       construct_meta(mod_hash, "init", "next_state"),
-                      tp.get_initial_state(), stream_pddl_goal.str(),
+                      tp.get_initial_state(), construct_goal(gps),
                       StateID::no_state, OperatorID::no_operator,
                       &h_value, ops, sr);
         }
@@ -416,9 +461,7 @@ vector<string> SamplingSearch::extract_samples() {
     if (store_all_states) {
         const string meta_visited = construct_meta(
              mod_hash, "visited", "previous_state");
-        ostringstream stream_pddl_goal;
-        gps.dump_pddl(stream_pddl_goal, "\t");
-        const string pddl_goal = stream_pddl_goal.str();
+        const string pddl_goal = construct_goal(gps);
 
         for (StateRegistry::const_iterator iter = sr.begin(); iter != sr.end();
              ++iter) {
@@ -436,6 +479,11 @@ void SamplingSearch::next_engine() {
     if (network_reload_count >= network_reload_frequency) {
         ignore_repredefinitions.erase("network");
         network_reload_count = 0;
+        /*
+          The reused predefinitions may hold the old network. Hence, we
+          redefine all predefinitions together with the network.
+        */
+        reusing_predefinitions = false;
     }
     SamplingSearchBase::next_engine();
 
@@ -449,6 +497,26 @@ void SamplingSearch::next_engine() {
 }
 
 
+void SamplingSearch::save_sampling_state(utils::BinaryWriter &writer) const {
+    SamplingSearchBase::save_sampling_state(writer);
+    // The techniques are identified by their position (the IDs are global).
+    for (const auto &st : sampling_techniques) {
+        writer.write<uint64_t>(successfully_solved.at(st->id));
+        const deque<bool> &history = successfully_solved_history.at(st->id);
+        writer.write_vector(vector<char>(history.begin(), history.end()));
+    }
+}
+
+void SamplingSearch::load_sampling_state(utils::BinaryReader &reader) {
+    SamplingSearchBase::load_sampling_state(reader);
+    for (const auto &st : sampling_techniques) {
+        successfully_solved[st->id] = reader.read<uint64_t>();
+        vector<char> history = reader.read_vector<char>();
+        successfully_solved_history[st->id].assign(
+            history.begin(), history.end());
+    }
+}
+
 void SamplingSearch::post_search(std::vector<std::string> &samples) {
     if ((*current_technique)->has_upgradeable_parameters()) {
         auto &history = successfully_solved_history.find((*current_technique)->id)->second;
@@ -472,7 +540,10 @@ void SamplingSearch::post_search(std::vector<std::string> &samples) {
                 << (*current_technique)->id << ":";
             (*current_technique)->dump_upgradable_parameters(oss);
 
-            samples.push_back(oss.str());
+            // Binary sample files do not support comments.
+            if (sample_format != SampleFormat::BINARY) {
+                samples.push_back(oss.str());
+            }
             cout << oss.str() << endl;
         } else {
             successfully_solved[(*current_technique)->id] = nb_solved;
@@ -486,6 +557,31 @@ std::string SamplingSearch::sample_file_header() const {
     return constructed_sample_file_header;
 }
 
+void SamplingSearch::write_samples(
+    ostream &out, const vector<string> &samples) const {
+    if (sample_format != SampleFormat::BINARY) {
+        SamplingSearchBase::write_samples(out, samples);
+        return;
+    }
+    int fields = 0;
+    if (!skip_goal_field) {
+        fields |= BinarySampleFormat::GOAL;
+    }
+    if (!skip_snd_state_field) {
+        fields |= BinarySampleFormat::SECOND_STATE;
+    }
+    if (!skip_action_field) {
+        fields |= BinarySampleFormat::ACTION;
+    }
+    if (add_unsolved_samples) {
+        fields |= BinarySampleFormat::UNSOLVED;
+    }
+    vector<string> heuristic_names = {"hplan"};
+    heuristic_names.insert(
+        heuristic_names.end(), use_evaluators.begin(), use_evaluators.end());
+    binary_format->write(out, samples, fields, heuristic_names);
+}
+
 void SamplingSearch::add_sampling_search_options(options::OptionParser &parser) {
     // Sources for samples to store
     parser.add_option<bool> ("store_solution_trajectory",
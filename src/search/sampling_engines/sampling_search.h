@@ -64,6 +64,7 @@ protected:
             size_t modification_hash,
             const std::string &sample_type,
             const std::string &snd_state);
+    std::string construct_goal(const GoalsProxy &goals) const;
     void add_entry(
         std::vector<std::string> &new_entries, const std::string &meta,
         const State &state,
@@ -84,7 +85,12 @@ protected:
     
     void post_search(std::vector<std::string> &samples) override;
     virtual void next_engine() override;
+    virtual void save_sampling_state(utils::BinaryWriter &writer) const override;
+    virtual void load_sampling_state(utils::BinaryReader &reader) override;
     virtual std::string sample_file_header() const override;
+    virtual void write_samples(
+        std::ostream &out,
+        const std::vector<std::string> &samples) const override;
 
 public:
     explicit SamplingSearch(const options::Options &opts);
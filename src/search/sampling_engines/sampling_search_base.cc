@@ -5,6 +5,7 @@
 #include "../heuristic.h"
 #include "../plugin.h"
 
+#include "../tasks/replaceable_initial_state_task.h"
 #include "../task_utils/successor_generator.h"
 #include "../task_utils/task_properties.h"
 #include "../utils/countdown_timer.h"
@@ -31,17 +32,104 @@ SamplingSearchBase::SamplingSearchBase(const options::Options &opts)
       search_parse_tree(prepare_search_parse_tree(opts.get_unparsed_config())),
       registry(*opts.get_registry()),
       predefinitions(*opts.get_predefinitions()),
-      tmp_ignore_repredefinitions(opts.get_list<string>("ignore_repredefinitions")){
+      tmp_ignore_repredefinitions(opts.get_list<string>("ignore_repredefinitions")),
+      reuse_predefinitions(opts.get<bool>("reuse_predefinitions")),
+      reset_predefinitions(opts.get_list<string>("reset_predefinitions")) {
     ignore_repredefinitions = std::unordered_set<string>(
             tmp_ignore_repredefinitions.begin(),
             tmp_ignore_repredefinitions.end());
 }
 
 
+static bool have_equal_operator(
+        const AbstractTask &task1, const AbstractTask &task2,
+        int op, bool is_axiom) {
+    if (task1.get_operator_cost(op, is_axiom) !=
+        task2.get_operator_cost(op, is_axiom)) {
+        return false;
+    }
+    int num_preconditions = task1.get_num_operator_preconditions(op, is_axiom);
+    if (num_preconditions !=
+        task2.get_num_operator_preconditions(op, is_axiom)) {
+        return false;
+    }
+    for (int i = 0; i < num_preconditions; ++i) {
+        if (task1.get_operator_precondition(op, i, is_axiom) !=
+            task2.get_operator_precondition(op, i, is_axiom)) {
+            return false;
+        }
+    }
+    int num_effects = task1.get_num_operator_effects(op, is_axiom);
+    if (num_effects != task2.get_num_operator_effects(op, is_axiom)) {
+        return false;
+    }
+    for (int eff = 0; eff < num_effects; ++eff) {
+        if (task1.get_operator_effect(op, eff, is_axiom) !=
+            task2.get_operator_effect(op, eff, is_axiom)) {
+            return false;
+        }
+        int num_conditions =
+            task1.get_num_operator_effect_conditions(op, eff, is_axiom);
+        if (num_conditions !=
+            task2.get_num_operator_effect_conditions(op, eff, is_axiom)) {
+            return false;
+        }
+        for (int cond = 0; cond < num_conditions; ++cond) {
+            if (task1.get_operator_effect_condition(op, eff, cond, is_axiom) !=
+                task2.get_operator_effect_condition(op, eff, cond, is_axiom)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/*
+  Two tasks differ only in their initial states, if they have the same
+  variables, operators, axioms and goals.
+*/
+static bool differ_only_in_initial_state(
+        const AbstractTask &task1, const AbstractTask &task2) {
+    if (task1.get_num_variables() != task2.get_num_variables() ||
+        task1.get_num_operators() != task2.get_num_operators() ||
+        task1.get_num_axioms() != task2.get_num_axioms() ||
+        task1.get_num_goals() != task2.get_num_goals()) {
+        return false;
+    }
+    for (int var = 0; var < task1.get_num_variables(); ++var) {
+        if (task1.get_variable_domain_size(var) !=
+            task2.get_variable_domain_size(var)) {
+            return false;
+        }
+    }
+    for (int op = 0; op < task1.get_num_operators(); ++op) {
+        if (!have_equal_operator(task1, task2, op, false)) {
+            return false;
+        }
+    }
+    for (int axiom = 0; axiom < task1.get_num_axioms(); ++axiom) {
+        if (!have_equal_operator(task1, task2, axiom, true)) {
+            return false;
+        }
+    }
+    for (int i = 0; i < task1.get_num_goals(); ++i) {
+        if (task1.get_goal_fact(i) != task2.get_goal_fact(i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void SamplingSearchBase::next_engine() {
     utils::g_log.silence = true;
     sampling_engine::paths.clear();
-    registry.handle_all_repredefinition(predefinitions, ignore_repredefinitions);
+    if (reusing_predefinitions) {
+        for (const string &key : reset_predefinitions) {
+            registry.handle_repredefinition(key, predefinitions);
+        }
+    } else {
+        registry.handle_all_repredefinition(predefinitions, ignore_repredefinitions);
+    }
 
     options::OptionParser engine_parser(
         search_parse_tree, registry, predefinitions, false);
@@ -54,6 +142,18 @@ void SamplingSearchBase::next_engine() {
 
 std::vector<std::string> SamplingSearchBase::sample(std::shared_ptr<AbstractTask> task) {
     utils::g_log << "." << flush;
+    if (reuse_predefinitions) {
+        reusing_predefinitions = reusable_task &&
+            differ_only_in_initial_state(*reusable_task, *task);
+        if (reusing_predefinitions) {
+            reusable_task->set_initial_state_values(
+                task->get_initial_state_values());
+        } else {
+            reusable_task =
+                make_shared<extra_tasks::ReplaceableInitialStateTask>(task);
+        }
+        task = reusable_task;
+    }
     sampling_technique::modified_task = task;
     next_engine();
     utils::g_log.silence = true;
@@ -79,5 +179,21 @@ void SamplingSearchBase::add_sampling_search_base_options(options::OptionParser
             "ignore_repredefinitions",
             "List of predefined object types NOT to redefine for every "
             "search", "[]");
+    parser.add_option<bool>(
+            "reuse_predefinitions",
+            "Keep the predefined objects (e.g. evaluators with their "
+            "precomputed data structures) as long as the sampled tasks differ "
+            "only in their initial states. Then, the search engines run on a "
+            "task whose initial state is replaced and the per-state data of "
+            "the evaluators is reset with every new search engine. "
+            "Predefinitions which depend on the initial state (e.g. landmark "
+            "heuristics) have to be listed in 'reset_predefinitions'. "
+            "The predefinitions have to use 'transform=sampling_transform()'.",
+            "false");
+    parser.add_list_option<string>(
+            "reset_predefinitions",
+            "List of predefined objects which are redefined for every "
+            "search, even if 'reuse_predefinitions' keeps the other "
+            "predefinitions.", "[]");
 }
 }
@@ -18,6 +18,10 @@ class Evaluator;
 class Heuristic;
 class PruningMethod;
 
+namespace extra_tasks {
+class ReplaceableInitialStateTask;
+}
+
 namespace options {
 class Options;
 struct ParseNode;
@@ -36,6 +40,18 @@ protected:
     std::vector<std::string> tmp_ignore_repredefinitions;
     std::unordered_set<std::string> ignore_repredefinitions;
 
+    /*
+      If reuse_predefinitions is enabled, the predefinitions are only
+      redefined if the sampled task differs from the previous one in more than
+      its initial state. Otherwise, the search engines work on reusable_task
+      whose initial state is replaced and only the predefinitions in
+      reset_predefinitions are redefined.
+    */
+    const bool reuse_predefinitions;
+    const std::vector<std::string> reset_predefinitions;
+    std::shared_ptr<extra_tasks::ReplaceableInitialStateTask> reusable_task;
+    bool reusing_predefinitions = false;
+
     std::shared_ptr<SearchEngine> engine;
 
     virtual void post_search(std::vector<std::string> &samples);
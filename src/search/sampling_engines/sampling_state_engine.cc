@@ -3,6 +3,7 @@
 #include "../option_parser.h"
 
 #include "../task_utils/task_properties.h"
+#include "../utils/memory.h"
 
 #include <iostream>
 #include <string>
@@ -37,6 +38,8 @@ SampleFormat select_sample_format(const string &sample_format) {
         return SampleFormat::CSV;
     } else if (sample_format == "fields") {
         return SampleFormat::FIELDS;
+    } else if (sample_format == "binary") {
+        return SampleFormat::BINARY;
     }
     cerr << "Invalid sample format:" << sample_format << endl;
     utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
@@ -61,7 +64,12 @@ SamplingStateEngine::SamplingStateEngine(const options::Options &opts)
       state_format(select_state_format(
               opts.get<string>("state_format"))),
       field_separator(opts.get<string>("field_separator")),
-      state_separator(opts.get<string>("state_separator")) {
+      state_separator(opts.get<string>("state_separator")),
+      binary_format(sample_format == SampleFormat::BINARY ?
+                    utils::make_unique_ptr<BinarySampleFormat>(
+                        *task, get_compression(
+                            opts.get<string>("sample_compression"))) :
+                    nullptr) {
 }
 
 string SamplingStateEngine::sample_file_header() const {
@@ -75,6 +83,9 @@ string SamplingStateEngine::sample_file_header() const {
     } else if (sample_format == SampleFormat::CSV) {
         oss << "# All fields one after another concatenated by "
             << field_separator << ".\n";
+    } else if (sample_format == SampleFormat::BINARY) {
+        // Binary sample files describe themselves in their chunk headers.
+        return "";
     } else {
         utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
     }
@@ -166,9 +177,18 @@ void SamplingStateEngine::add_sampling_state_options(
         "sample_format",
         "Format in which to write down the samples. The field order is"
         "V - value, current state, optionally goal condition. Choose from:"
-        "csv: writes the data fields separated by 'separator'.",
+        "csv: writes the data fields separated by 'separator'."
+        "binary: writes the samples in a binary format with bit-packed "
+        "states (see binary_sample_format.h). The state_format and "
+        "separators are ignored.",
         default_sample_format
     );
+    parser.add_option<string> (
+        "sample_compression",
+        "Compression of the blocks of the binary sample format. Choose from:"
+        "none, zlib (requires the planner to be compiled with zlib).",
+        "none"
+    );
     parser.add_option<string> (
         "state_format",
         "Format in which to write down states. Choose from:"
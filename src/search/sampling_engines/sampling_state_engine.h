@@ -1,6 +1,7 @@
 #ifndef SEARCH_ENGINES_SAMPLING_STATE_ENGINE_H
 #define SEARCH_ENGINES_SAMPLING_STATE_ENGINE_H
 
+#include "binary_sample_format.h"
 #include "sampling_engine.h"
 
 #include <functional>
@@ -38,7 +39,8 @@ extern std::vector<Path> paths;
 
 enum SampleFormat {
     CSV,
-    FIELDS
+    FIELDS,
+    BINARY
 };
 
 enum StateFormat {
@@ -55,7 +57,8 @@ protected:
     const StateFormat state_format;
     const std::string field_separator;
     const std::string state_separator;
-
+    // Only set for the binary sample format.
+    const std::unique_ptr<BinarySampleFormat> binary_format;
 
     virtual std::string sample_file_header() const override;
 
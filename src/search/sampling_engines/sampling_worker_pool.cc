@@ -0,0 +1,260 @@
+#include "sampling_worker_pool.h"
+
+#include "../utils/system.h"
+
+#include <cassert>
+#include <cstring>
+#include <iostream>
+
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+#include <csignal>
+#include <errno.h>
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace sampling_engine {
+static void append_size(string &buffer, size_t value) {
+    buffer.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+static size_t read_size(const string &buffer, size_t &pos) {
+    size_t value;
+    memcpy(&value, buffer.data() + pos, sizeof(value));
+    pos += sizeof(value);
+    return value;
+}
+
+static string serialize_batch(
+    int technique, const vector<string> &samples) {
+    string message;
+    append_size(message, 0);
+    append_size(message, technique);
+    append_size(message, samples.size());
+    for (const string &sample : samples) {
+        append_size(message, sample.size());
+        message.append(sample);
+    }
+    size_t length = message.size() - sizeof(size_t);
+    memcpy(&message[0], &length, sizeof(length));
+    return message;
+}
+
+/*
+  Extract all complete batches from the front of buffer. A batch is encoded
+  as [length][technique][number of samples]([sample length][sample])*.
+*/
+static void deserialize_batches(
+    string &buffer, deque<SamplingWorkerPool::Batch> &batches) {
+    size_t pos = 0;
+    while (buffer.size() - pos >= sizeof(size_t)) {
+        size_t start = pos;
+        size_t length = read_size(buffer, pos);
+        if (buffer.size() - pos < length) {
+            pos = start;
+            break;
+        }
+        SamplingWorkerPool::Batch batch;
+        batch.technique = static_cast<int>(read_size(buffer, pos));
+        size_t nb_samples = read_size(buffer, pos);
+        batch.samples.reserve(nb_samples);
+        for (size_t i = 0; i < nb_samples; ++i) {
+            size_t sample_length = read_size(buffer, pos);
+            batch.samples.emplace_back(buffer, pos, sample_length);
+            pos += sample_length;
+        }
+        assert(pos == start + sizeof(size_t) + length);
+        batches.push_back(move(batch));
+    }
+    buffer.erase(0, pos);
+}
+
+SamplingWorkerPool::SamplingWorkerPool(int num_workers)
+    : num_workers(num_workers) {
+    assert(num_workers > 0);
+}
+
+SamplingWorkerPool::~SamplingWorkerPool() {
+    if (worker_fd == -1) {
+        terminate();
+    }
+}
+
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+void SamplingWorkerPool::start(const function<void(int)> &run_worker) {
+    assert(workers.empty());
+    // Do not duplicate buffered output in the children.
+    cout.flush();
+    cerr.flush();
+    workers.resize(num_workers);
+    for (int idx = 0; idx < num_workers; ++idx) {
+        int fds[2];
+        if (pipe(fds) == -1) {
+            cerr << "Could not create pipe for sampling worker: "
+                 << strerror(errno) << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+        }
+        pid_t pid = fork();
+        if (pid == -1) {
+            cerr << "Could not fork sampling worker: "
+                 << strerror(errno) << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+        } else if (pid == 0) {
+            close(fds[0]);
+            for (int prev = 0; prev < idx; ++prev) {
+                close(workers[prev].fd);
+            }
+            workers.clear();
+            worker_fd = fds[1];
+            run_worker(idx);
+            close(worker_fd);
+            cout.flush();
+            cerr.flush();
+            /*
+              Skip the destructors and exit handlers. They belong to the
+              parent process (e.g. they would write the sample files).
+            */
+            _exit(0);
+        }
+        close(fds[1]);
+        workers[idx].pid = pid;
+        workers[idx].fd = fds[0];
+    }
+}
+
+void SamplingWorkerPool::send(
+    int technique, const vector<string> &samples) const {
+    assert(worker_fd != -1);
+    string message = serialize_batch(technique, samples);
+    const char *data = message.data();
+    size_t remaining = message.size();
+    while (remaining > 0) {
+        ssize_t written = write(worker_fd, data, remaining);
+        if (written == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // The parent process is gone.
+            _exit(static_cast<int>(utils::ExitCode::SEARCH_CRITICAL_ERROR));
+        }
+        data += written;
+        remaining -= written;
+    }
+}
+
+void SamplingWorkerPool::read_available(Worker &worker) {
+    char chunk[1 << 16];
+    ssize_t nb_read;
+    do {
+        nb_read = read(worker.fd, chunk, sizeof(chunk));
+    } while (nb_read == -1 && errno == EINTR);
+    if (nb_read <= 0) {
+        if (!worker.buffer.empty()) {
+            cerr << "Sampling worker " << worker.pid
+                 << " sent an incomplete batch." << endl;
+        }
+        close(worker.fd);
+        worker.fd = -1;
+        worker.eof = true;
+    } else {
+        worker.buffer.append(chunk, nb_read);
+        deserialize_batches(worker.buffer, worker.batches);
+    }
+}
+
+bool SamplingWorkerPool::receive(vector<Batch> &batches, int timeout_ms) {
+    vector<pollfd> fds;
+    vector<int> fd_workers;
+    for (int idx = 0; idx < num_workers; ++idx) {
+        if (!workers[idx].eof) {
+            fds.push_back({workers[idx].fd, POLLIN, 0});
+            fd_workers.push_back(idx);
+        }
+    }
+    if (!fds.empty() && poll(fds.data(), fds.size(), timeout_ms) > 0) {
+        for (size_t i = 0; i < fds.size(); ++i) {
+            if (fds[i].revents & (POLLIN | POLLHUP | POLLERR)) {
+                read_available(workers[fd_workers[i]]);
+            }
+        }
+    }
+
+    int nb_finished = 0;
+    while (nb_finished < num_workers) {
+        Worker &worker = workers[next_worker];
+        if (!worker.batches.empty()) {
+            batches.push_back(move(worker.batches.front()));
+            worker.batches.pop_front();
+        } else if (!worker.eof) {
+            // Wait for the worker whose turn it is.
+            return true;
+        }
+        nb_finished = worker.is_finished() ? nb_finished + 1 : 0;
+        next_worker = (next_worker + 1) % num_workers;
+    }
+    wait_for_workers();
+    return false;
+}
+
+void SamplingWorkerPool::wait_for_workers() {
+    for (Worker &worker : workers) {
+        if (worker.pid == -1) {
+            continue;
+        }
+        int status;
+        while (waitpid(worker.pid, &status, 0) == -1 && errno == EINTR) {
+        }
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            cerr << "Sampling worker " << worker.pid
+                 << " terminated abnormally." << endl;
+        }
+        worker.pid = -1;
+    }
+}
+
+void SamplingWorkerPool::terminate() {
+    for (Worker &worker : workers) {
+        if (worker.pid != -1) {
+            kill(worker.pid, SIGKILL);
+            while (waitpid(worker.pid, nullptr, 0) == -1 && errno == EINTR) {
+            }
+            worker.pid = -1;
+        }
+        if (worker.fd != -1) {
+            close(worker.fd);
+            worker.fd = -1;
+            worker.eof = true;
+        }
+    }
+}
+#else
+void SamplingWorkerPool::start(const function<void(int)> &) {
+    cerr << "Sampling with multiple workers is only supported on Linux "
+            "and macOS." << endl;
+    utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+}
+
+void SamplingWorkerPool::send(int, const vector<string> &) const {
+    ABORT("Sampling workers are not supported on this platform.");
+}
+
+void SamplingWorkerPool::read_available(Worker &) {
+    ABORT("Sampling workers are not supported on this platform.");
+}
+
+bool SamplingWorkerPool::receive(vector<Batch> &, int) {
+    ABORT("Sampling workers are not supported on this platform.");
+    return false;
+}
+
+void SamplingWorkerPool::wait_for_workers() {
+}
+
+void SamplingWorkerPool::terminate() {
+}
+#endif
+}
@@ -0,0 +1,76 @@
+#ifndef SEARCH_ENGINES_SAMPLING_WORKER_POOL_H
+#define SEARCH_ENGINES_SAMPLING_WORKER_POOL_H
+
+#include <deque>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace sampling_engine {
+/*
+  Runs sampling workers in forked processes. Every worker owns a copy of the
+  whole planner state (search engines, state registries, random number
+  generators and all global variables like sampling_technique::modified_task),
+  hence, the sampling code does not have to be thread-safe. Workers send
+  their samples through a pipe to the parent process which delivers them in a
+  fixed round-robin order over the workers (one batch per worker and turn).
+  Thus, the order of the samples only depends on the batches the workers
+  produce and not on the timing of the workers.
+
+  Only supported on Linux and macOS.
+*/
+class SamplingWorkerPool {
+public:
+    struct Batch {
+        int technique;
+        std::vector<std::string> samples;
+    };
+
+private:
+    struct Worker {
+        int pid = -1;
+        int fd = -1;
+        bool eof = false;
+        std::string buffer;
+        std::deque<Batch> batches;
+
+        bool is_finished() const {
+            return eof && batches.empty();
+        }
+    };
+
+    const int num_workers;
+    std::vector<Worker> workers;
+    int next_worker = 0;
+    // Write end of the pipe (only set within a worker process).
+    int worker_fd = -1;
+
+    void read_available(Worker &worker);
+    void wait_for_workers();
+
+public:
+    explicit SamplingWorkerPool(int num_workers);
+    SamplingWorkerPool(const SamplingWorkerPool &) = delete;
+    ~SamplingWorkerPool();
+
+    /*
+      Fork the workers. Every worker executes run_worker with its index and
+      terminates afterwards. This method only returns in the parent process.
+    */
+    void start(const std::function<void(int)> &run_worker);
+
+    // Called within a worker to send a batch of samples to the parent.
+    void send(int technique, const std::vector<std::string> &samples) const;
+
+    /*
+      Wait at most timeout_ms milliseconds for new data from the workers and
+      append all batches whose turn has come to the given vector. Returns
+      false if all workers are finished and all batches were delivered.
+    */
+    bool receive(std::vector<Batch> &batches, int timeout_ms);
+
+    // Kill all workers which are still running.
+    void terminate();
+};
+}
+#endif
@@ -6,6 +6,8 @@
 #include "../plugin.h"
 #include "../state_registry.h"
 
+#include "../utils/binary_io.h"
+
 #include <fstream>
 #include <sstream>
 #include <unordered_map>
@@ -165,6 +167,20 @@ bool SamplingTechnique::empty() const {
     return counter >= count;
 }
 
+void SamplingTechnique::assign_to_worker(
+        int worker, int num_workers, int seed) {
+    assert(0 <= worker && worker < num_workers);
+    int remaining = count - counter;
+    int share = remaining / num_workers +
+                (worker < remaining % num_workers ? 1 : 0);
+    counter = count - share;
+    rng->seed(seed);
+}
+
+void SamplingTechnique::register_worker_task() {
+    counter++;
+}
+
 shared_ptr<AbstractTask> SamplingTechnique::next(
         const shared_ptr<AbstractTask> &seed_task) {
     return next(seed_task, TaskProxy(*seed_task));
@@ -245,6 +261,7 @@ void SamplingTechnique::do_upgrade_parameters() {
 }
 
 void SamplingTechnique::upgrade_parameters() {
+    ++num_upgrades;
     if (remaining_upgrades == -1) {
         do_upgrade_parameters();
     } else if (remaining_upgrades > 0) {
@@ -263,6 +280,22 @@ void SamplingTechnique::dump_upgradable_parameters(ostream &/*stream*/) const {
     utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
 }
 
+void SamplingTechnique::save_state(utils::BinaryWriter &writer) const {
+    writer.write<int>(counter);
+    writer.write<int>(num_upgrades);
+    writer.write_string(rng->get_state());
+}
+
+void SamplingTechnique::load_state(utils::BinaryReader &reader) {
+    counter = reader.read<int>();
+    int upgrades = reader.read<int>();
+    // Upgrades which were already performed cannot be undone.
+    for (int i = num_upgrades; i < upgrades; ++i) {
+        upgrade_parameters();
+    }
+    rng->set_state(reader.read_string());
+}
+
 bool SamplingTechnique::test_mutexes(const shared_ptr<AbstractTask> &task) const {
     //Check initial state
     vector<int> init = task->get_initial_state_values();
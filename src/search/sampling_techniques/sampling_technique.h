@@ -29,6 +29,11 @@ class Predefinitions;
 class Registry;
 }
 
+namespace utils {
+class BinaryReader;
+class BinaryWriter;
+}
+
 namespace sampling_technique {
 extern std::shared_ptr<AbstractTask> modified_task;
 
@@ -52,6 +57,7 @@ protected:
 
 protected:
     int remaining_upgrades;
+    int num_upgrades = 0;
 
     std::shared_ptr<utils::RandomNumberGenerator> rng;
     std::vector<std::vector<std::set<FactPair>>> alternative_task_mutexes;
@@ -80,6 +86,15 @@ public:
     int get_counter() const;
     bool empty() const;
 
+    /*
+      Restrict the technique to the share of its remaining tasks which the
+      given worker (out of num_workers) generates and reseed its random
+      number generator (see SamplingEngine option 'workers').
+    */
+    void assign_to_worker(int worker, int num_workers, int seed);
+    // Count a task which was generated by a worker process.
+    void register_worker_task();
+
     std::shared_ptr<AbstractTask> next(
         const std::shared_ptr<AbstractTask> &seed_task = tasks::g_root_task);
     std::shared_ptr<AbstractTask> next(
@@ -100,6 +115,15 @@ public:
     virtual void upgrade_parameters();
     virtual void dump_upgradable_parameters(std::ostream &stream) const;
 
+    /*
+      Store and restore the progress of the technique (counter, parameter
+      upgrades and random number generators) for a checkpoint of the
+      sampling engine. Loading replays the upgrades on the freshly
+      constructed technique.
+    */
+    virtual void save_state(utils::BinaryWriter &writer) const;
+    virtual void load_state(utils::BinaryReader &reader);
+
     static const std::string no_dump_directory;
 };
 }
@@ -9,6 +9,8 @@
 
 #include "../task_utils/sampling.h"
 
+#include "../utils/binary_io.h"
+
 using namespace std;
 
 namespace sampling_technique {
@@ -30,6 +32,16 @@ static int compute_heuristic(
 }
 
 
+void TechniqueGBackwardNone::save_state(utils::BinaryWriter &writer) const {
+    SamplingTechnique::save_state(writer);
+    writer.write_string(steps->get_rng_state());
+}
+
+void TechniqueGBackwardNone::load_state(utils::BinaryReader &reader) {
+    SamplingTechnique::load_state(reader);
+    steps->set_rng_state(reader.read_string());
+}
+
 const string &TechniqueGBackwardNone::get_name() const {
     return name;
 }
@@ -44,6 +44,9 @@ public:
 
     virtual void dump_upgradable_parameters(std::ostream &stream) const override;
 
+    virtual void save_state(utils::BinaryWriter &writer) const override;
+    virtual void load_state(utils::BinaryReader &reader) override;
+
     virtual const std::string &get_name() const override;
     const static std::string name;
 };
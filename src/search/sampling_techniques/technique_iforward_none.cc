@@ -6,11 +6,23 @@
 
 #include "../tasks/modified_init_goals_task.h"
 
+#include "../utils/binary_io.h"
+
 using namespace std;
 
 namespace sampling_technique {
 const std::string TechniqueIForwardNone::name = "iforward_none";
 
+void TechniqueIForwardNone::save_state(utils::BinaryWriter &writer) const {
+    SamplingTechnique::save_state(writer);
+    writer.write_string(steps->get_rng_state());
+}
+
+void TechniqueIForwardNone::load_state(utils::BinaryReader &reader) {
+    SamplingTechnique::load_state(reader);
+    steps->set_rng_state(reader.read_string());
+}
+
 const string &TechniqueIForwardNone::get_name() const {
     return name;
 }
@@ -33,6 +33,9 @@ public:
     explicit TechniqueIForwardNone(const options::Options &opts);
     virtual ~TechniqueIForwardNone() override = default;
 
+    virtual void save_state(utils::BinaryWriter &writer) const override;
+    virtual void load_state(utils::BinaryReader &reader) override;
+
     virtual const std::string &get_name() const override;
     const static std::string name;
 };
@@ -10,6 +10,8 @@
 #include "task_utils/task_properties.h"
 #include "tasks/root_task.h"
 #include "task_utils/successor_generator.h"
+#include "utils/binary_io.h"
+#include "utils/hash.h"
 #include "utils/logging.h"
 #include "utils/rng_options.h"
 #include "utils/system.h"
@@ -18,6 +20,9 @@
 #include "utils/memory.h"
 
 #include <cassert>
+#include <cctype>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
 #include <limits>
 
@@ -26,14 +31,158 @@ using utils::ExitCode;
 
 class PruningMethod;
 
+static const string CHECKPOINT_MAGIC = "fast-downward-checkpoint-2";
+/*
+  Options which may change when a search is resumed from a checkpoint. They
+  are not part of the fingerprint of a checkpoint.
+*/
+static const vector<string> RESUME_OPTIONS = {
+    "checkpoint_file", "checkpoint_interval", "max_expansions", "max_time"};
+
+static bool file_exists(const string &filename) {
+    return ifstream(filename).good();
+}
+
+static void feed_operator(
+    utils::HashState &hash_state, const AbstractTask &task, int op,
+    bool is_axiom) {
+    utils::feed(hash_state, task.get_operator_cost(op, is_axiom));
+    int num_preconditions = task.get_num_operator_preconditions(op, is_axiom);
+    utils::feed(hash_state, num_preconditions);
+    for (int i = 0; i < num_preconditions; ++i) {
+        utils::feed(hash_state, task.get_operator_precondition(op, i, is_axiom));
+    }
+    int num_effects = task.get_num_operator_effects(op, is_axiom);
+    utils::feed(hash_state, num_effects);
+    for (int eff = 0; eff < num_effects; ++eff) {
+        utils::feed(hash_state, task.get_operator_effect(op, eff, is_axiom));
+        int num_conditions =
+            task.get_num_operator_effect_conditions(op, eff, is_axiom);
+        utils::feed(hash_state, num_conditions);
+        for (int cond = 0; cond < num_conditions; ++cond) {
+            utils::feed(hash_state, task.get_operator_effect_condition(
+                            op, eff, cond, is_axiom));
+        }
+    }
+}
+
+/*
+  Return the position of the next "key = " in config at or after pos where
+  key is the complete option name (e.g. not the end of "my_key = ").
+*/
+static size_t find_option(const string &config, const string &key, size_t pos) {
+    string pattern = key + " = ";
+    for (size_t found = config.find(pattern, pos); found != string::npos;
+         found = config.find(pattern, found + 1)) {
+        if (found == 0 || !(isalnum(config[found - 1]) ||
+                            config[found - 1] == '_')) {
+            return found;
+        }
+    }
+    return string::npos;
+}
+
+/*
+  Remove the options in RESUME_OPTIONS ("key = value" as printed by the
+  option parser) from the given configuration.
+*/
+static string remove_resume_options(const string &config) {
+    string result;
+    size_t pos = 0;
+    while (pos < config.size()) {
+        size_t option_start = string::npos;
+        for (const string &key : RESUME_OPTIONS) {
+            size_t found = find_option(config, key, pos);
+            if (found != string::npos &&
+                (option_start == string::npos || found < option_start)) {
+                option_start = found;
+            }
+        }
+        if (option_start == string::npos) {
+            result += config.substr(pos);
+            break;
+        }
+        result += config.substr(pos, option_start - pos);
+        // The values of these options are atoms.
+        pos = config.find_first_of(",)", option_start);
+        if (pos == string::npos) {
+            break;
+        }
+        if (config[pos] == ',') {
+            // Skip the separator after the option.
+            pos = config.find_first_not_of(' ', pos + 1);
+            if (pos == string::npos) {
+                break;
+            }
+        }
+    }
+    return result;
+}
+
+/*
+  Fingerprint of the task and of the engine configuration. A checkpoint
+  can only be resumed by a search with the same fingerprint.
+*/
+static uint64_t compute_checkpoint_fingerprint(
+    const AbstractTask &task, const string &config) {
+    utils::HashState hash_state;
+    utils::feed(hash_state, task.get_num_variables());
+    for (int var = 0; var < task.get_num_variables(); ++var) {
+        utils::feed(hash_state, task.get_variable_domain_size(var));
+        utils::feed(hash_state, task.get_variable_axiom_layer(var));
+        utils::feed(hash_state, task.get_variable_default_axiom_value(var));
+    }
+    utils::feed(hash_state, task.get_num_operators());
+    for (int op = 0; op < task.get_num_operators(); ++op) {
+        feed_operator(hash_state, task, op, false);
+    }
+    utils::feed(hash_state, task.get_num_axioms());
+    for (int axiom = 0; axiom < task.get_num_axioms(); ++axiom) {
+        feed_operator(hash_state, task, axiom, true);
+    }
+    utils::feed(hash_state, task.get_num_goals());
+    for (int i = 0; i < task.get_num_goals(); ++i) {
+        utils::feed(hash_state, task.get_goal_fact(i));
+    }
+    utils::feed(hash_state, task.get_initial_state_values());
+    string engine_config = remove_resume_options(config);
+    vector<int> characters(engine_config.begin(), engine_config.end());
+    utils::feed(hash_state, characters);
+    return hash_state.get_hash64();
+}
+
+static shared_ptr<segment_storage::SegmentStorage> create_segment_storage(
+    const Options &opts) {
+    string directory = opts.get<string>("storage_directory", "none");
+    if (directory == "none") {
+        return nullptr;
+    }
+    size_t ram_budget = opts.get<int>("storage_ram_budget", 0);
+    return make_shared<segment_storage::SegmentStorage>(
+        directory, ram_budget << 20);
+}
+
 SearchEngine::SearchEngine(const Options &opts)
     : status(IN_PROGRESS),
+      checkpoint_file(opts.get<string>("checkpoint_file", "none")),
+      checkpoint_interval(opts.get<double>("checkpoint_interval", 600)),
+      checkpoint_exists(checkpoint_file != "none" &&
+                        file_exists(checkpoint_file)),
+      unparsed_config(opts.get_unparsed_config()),
       solution_found(false),
       task(opts.get<shared_ptr<AbstractTask>>("transform")),
       task_proxy(*task),
-      state_registry(task_proxy),
-      successor_generator(successor_generator::get_successor_generator(task_proxy)),
-      search_space(state_registry),
+      state_registry(task_proxy, opts.get<bool>("incremental_hashing", false),
+                     create_segment_storage(opts)),
+      successor_generator(successor_generator::get_successor_generator(
+                              task_proxy,
+                              opts.get<successor_generator::SuccessorGeneratorType>(
+                                  "successor_generator",
+                                  successor_generator::SuccessorGeneratorType::TREE))),
+      search_space(state_registry,
+                   opts.get<OperatorCost>("cost_type"),
+                   opts.get<ParentPointers>(
+                       "parent_pointers", ParentPointers::FULL)),
       search_progress(opts.get<utils::Verbosity>("verbosity")),
       statistics(SearchStatistics(opts.get<utils::Verbosity>("verbosity"), opts.get<int>("max_expansions"))),
       statistics_interval(opts.get<double>("statistics_interval")),
@@ -100,22 +249,94 @@ const TaskProxy &SearchEngine::get_task_proxy() const {
     return task_proxy;
 }
 
+bool SearchEngine::uses_checkpoints() const {
+    return checkpoint_file != "none" && supports_checkpoints();
+}
+
+bool SearchEngine::is_resuming() const {
+    return uses_checkpoints() && checkpoint_exists;
+}
+
+void SearchEngine::save_checkpoint(utils::BinaryWriter &writer) {
+    statistics.save(writer);
+    state_registry.save(writer);
+    search_space.save(writer);
+}
+
+void SearchEngine::load_checkpoint(utils::BinaryReader &reader) {
+    statistics.load(reader);
+    state_registry.load(reader);
+    search_space.load(reader);
+}
+
+void SearchEngine::write_checkpoint() {
+    utils::Timer checkpoint_timer;
+    bool written = utils::write_file_atomically(
+        checkpoint_file, [this](utils::BinaryWriter &writer) {
+            writer.write_string(CHECKPOINT_MAGIC);
+            writer.write<uint64_t>(compute_checkpoint_fingerprint(
+                                       *task, unparsed_config));
+            save_checkpoint(writer);
+        });
+    if (written) {
+        utils::g_log << "Checkpoint written to " << checkpoint_file << " ["
+                     << checkpoint_timer << "]" << endl;
+    } else {
+        utils::g_log << "Warning: could not write checkpoint to "
+                     << checkpoint_file << endl;
+    }
+}
+
+void SearchEngine::read_checkpoint() {
+    ifstream in(checkpoint_file, ios::binary);
+    utils::BinaryReader reader(in);
+    if (reader.read_string() != CHECKPOINT_MAGIC) {
+        cerr << checkpoint_file << " is not a checkpoint of this planner "
+             << "version." << endl;
+        utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
+    }
+    if (reader.read<uint64_t>() != compute_checkpoint_fingerprint(
+            *task, unparsed_config)) {
+        cerr << checkpoint_file << " was written for a different task or "
+             << "with different search options." << endl;
+        utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
+    }
+    load_checkpoint(reader);
+    utils::g_log << "Resumed search from checkpoint " << checkpoint_file
+                 << endl;
+}
+
 void SearchEngine::search() {
-    initialize();
+    bool use_checkpoints = uses_checkpoints();
+    if (!initialized) {
+        initialize();
+        if (checkpoint_file != "none" && !use_checkpoints) {
+            utils::g_log << "Warning: this search engine does not support "
+                         << "checkpoints, checkpoint_file is ignored." << endl;
+        }
+        if (is_resuming()) {
+            read_checkpoint();
+        }
+        initialized = true;
+    }
     assert(!timer);
     timer = utils::make_unique_ptr<utils::CountdownTimer>(max_time);
     double last_statistic_time  = timer->get_elapsed_time();
+    double last_checkpoint_time = timer->get_elapsed_time();
+    bool stopped_at_limit = false;
     while (status == IN_PROGRESS) {
         try {
             status = step();
         } catch (MaximumExpansionsError e) {
             cout << "Maximum number of expansions reached. Abort search."
                 << endl;
+            stopped_at_limit = true;
             break;
         }
         if (timer->is_expired()) {
             utils::g_log << "Time limit reached. Abort search." << endl;
             status = TIMEOUT;
+            stopped_at_limit = true;
             break;
         }
         if(statistics_interval > 0 &&
@@ -123,6 +344,17 @@ void SearchEngine::search() {
             print_timed_statistics();
             last_statistic_time = timer->get_elapsed_time();
         }
+        if (use_checkpoints && status == IN_PROGRESS &&
+            timer->get_elapsed_time() - last_checkpoint_time > checkpoint_interval) {
+            write_checkpoint();
+            last_checkpoint_time = timer->get_elapsed_time();
+        }
+    }
+    if (use_checkpoints && stopped_at_limit) {
+        write_checkpoint();
+    } else if (use_checkpoints && (status == SOLVED || status == FAILED)) {
+        // A finished search must not be resumed by the next run.
+        remove(checkpoint_file.c_str());
     }
     // TODO: Revise when and which search times are logged.
     utils::g_log << "Actual search time: " << timer->get_elapsed_time() << endl;
@@ -150,6 +382,25 @@ int SearchEngine::get_adjusted_cost(const OperatorProxy &op) const {
     return get_adjusted_action_cost(op, cost_type, is_unit_cost);
 }
 
+void SearchEngine::prepare_restart(const SearchEngine &phase) {
+    if (phase.cost_type != cost_type) {
+        cerr << "The phases of a restarted search must use the same "
+             << "cost_type." << endl;
+        utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
+    }
+    status = IN_PROGRESS;
+    solution_found = false;
+    plan.clear();
+    goal_id = StateID::no_state;
+    timer = nullptr;
+    max_time = phase.max_time;
+    bound = phase.bound;
+}
+
+void SearchEngine::restart_with(SearchEngine &) {
+    ABORT("This search engine does not support restarts.");
+}
+
 double SearchEngine::get_max_time() {
     return max_time;
 }
@@ -205,6 +456,75 @@ void SearchEngine::add_options_to_parser(OptionParser &parser) {
             "Use a negative value to disable. Default: 30",
             "30"
             );
+    parser.add_option<bool>(
+        "incremental_hashing",
+        "Store the hash of every registered state and derive the hash of a "
+        "successor from its predecessor (Zobrist hashing) instead of hashing "
+        "the whole packed state. This costs one additional 4-byte bin per "
+        "state and pays off for tasks with many variables.",
+        "false");
+    parser.add_enum_option<successor_generator::SuccessorGeneratorType>(
+        "successor_generator",
+        {"TREE", "BITSET"},
+        "Data structure used to find the applicable operators.",
+        "TREE",
+        {"decision tree over the precondition variables",
+         "bitwise comparison of the state with the precondition masks of "
+         "all operators; faster for tasks with many operators whose "
+         "preconditions share few variables"});
+    parser.add_enum_option<ParentPointers>(
+        "parent_pointers",
+        {"FULL", "STATE", "NONE"},
+        "Information stored per state to reconstruct the plan. Storing less "
+        "reduces the memory per state (16 bytes for FULL if costs are "
+        "adjusted, 4 bytes less otherwise) at the cost of recomputing the "
+        "plan at the end. The plan found is the same or cheaper.",
+        "FULL",
+        {"parent state and creating operator (8 bytes)",
+         "parent state (4 bytes); the operator is recomputed from the parent",
+         "nothing; the plan is reconstructed by regression and a lookup of "
+         "the predecessors and their g-values (not supported for tasks with "
+         "axioms or conditional effects)"});
+    parser.add_option<string>(
+        "storage_directory",
+        "Directory for a memory-mapped file which stores the states and "
+        "per-state information (e.g. search nodes) exceeding "
+        "storage_ram_budget. The operating system keeps the recently used "
+        "parts in memory and writes the others to the file when physical "
+        "memory gets scarce (e.g. under a cgroup limit or before the OOM "
+        "killer strikes). The mapped file counts against an address space "
+        "limit (ulimit -v, RLIMIT_AS). Hence, the driver limits the data "
+        "segment (RLIMIT_DATA, which excludes shared file mappings) instead "
+        "when this option is used. Use 'none' to keep everything in RAM.",
+        "none");
+    parser.add_option<int>(
+        "storage_ram_budget",
+        "Memory in MiB for states and per-state information which is "
+        "allocated in RAM before the storage_directory file is used.",
+        "1024",
+        Bounds("0", "infinity"));
+    parser.add_option<string>(
+        "checkpoint_file",
+        "File to store the state of the search in every checkpoint_interval "
+        "seconds and when the search stops at max_time or max_expansions. "
+        "If the file exists when the search starts, the search continues "
+        "from the stored state. A checkpoint is rejected if it was written "
+        "for another task or with other search options (except for the "
+        "checkpoint options, max_time and max_expansions). Options of "
+        "predefined objects are not compared. "
+        "The file is replaced atomically, so a killed planner leaves the "
+        "last complete checkpoint, and it is removed when the search "
+        "finishes. Use 'none' to disable checkpoints. "
+        "Currently supported by eager search (without path-dependent "
+        "evaluators) and sampling engines with a single worker. Sampling "
+        "engines stopped at max_time keep the samples which are not yet "
+        "written in the checkpoint instead of writing them.",
+        "none");
+    parser.add_option<double>(
+        "checkpoint_interval",
+        "Seconds between two checkpoints.",
+        "600",
+        Bounds("0", "infinity"));
     parser.add_option<shared_ptr<AbstractTask>>(
         "transform",
         "Optional task transformation for the search algorithm."
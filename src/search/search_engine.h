@@ -10,6 +10,7 @@
 #include "state_registry.h"
 #include "task_proxy.h"
 
+#include <string>
 #include <vector>
 
 namespace options {
@@ -27,6 +28,8 @@ class SuccessorGenerator;
 }
 
 namespace utils {
+class BinaryReader;
+class BinaryWriter;
 class CountdownTimer;
 enum class Verbosity;
 }
@@ -37,6 +40,22 @@ class SearchEngine {
     SearchStatus status;
     Plan plan;
     StateID goal_id = StateID::no_state;
+
+    /*
+      If a checkpoint file is given, the engine stores its state in the file
+      every checkpoint_interval seconds and when the search stops at a limit.
+      If the file exists when the search starts, the search resumes from it.
+    */
+    const std::string checkpoint_file;
+    const double checkpoint_interval;
+    const bool checkpoint_exists;
+    // Part of the fingerprint of a checkpoint.
+    const std::string unparsed_config;
+    // False until search() was called for the first time.
+    bool initialized = false;
+
+    void write_checkpoint();
+    void read_checkpoint();
 protected:
     bool solution_found;
 
@@ -62,9 +81,28 @@ protected:
     virtual void initialize() {}
     virtual SearchStatus step() = 0;
 
+    /*
+      Engines which support checkpoints store everything they need to
+      continue after initialize() was called on a new engine. The default
+      implementations store the statistics, the registered states and the
+      search space; overriding methods should call them first.
+    */
+    virtual bool supports_checkpoints() const {return false;}
+    virtual void save_checkpoint(utils::BinaryWriter &writer);
+    virtual void load_checkpoint(utils::BinaryReader &reader);
+    bool uses_checkpoints() const;
+    // True if the search will continue from an existing checkpoint.
+    bool is_resuming() const;
+
     void set_plan(const Plan &plan);
     bool check_goal_and_set_plan(const State &state);
     int get_adjusted_cost(const OperatorProxy &op) const;
+    /*
+      Reset the status, solution and timer such that search() can be called
+      again, and take the bound and time limit of the given phase. The
+      registered states, the search space and the statistics are kept.
+    */
+    void prepare_restart(const SearchEngine &phase);
 public:
     SearchEngine(const options::Options &opts);
     virtual ~SearchEngine();
@@ -86,6 +124,15 @@ public:
     double get_max_time();
     void reduce_max_time(double new_max_time);
 
+    /*
+      Engines which support restarts can continue after a finished search
+      with the parameters (e.g. open list and evaluators) of another engine
+      of the same type (see option reuse_state of iterated search). The
+      other engine must not be used afterwards.
+    */
+    virtual bool supports_restarts() const {return false;}
+    virtual void restart_with(SearchEngine &phase);
+
     /* The following three methods should become functions as they
        do not require access to private/protected class members. */
     static void add_pruning_option(options::OptionParser &parser);
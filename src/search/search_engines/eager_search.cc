@@ -8,6 +8,7 @@
 
 #include "../algorithms/ordered_set.h"
 #include "../task_utils/successor_generator.h"
+#include "../task_utils/task_properties.h"
 
 #include "../utils/logging.h"
 
@@ -20,6 +21,10 @@
 using namespace std;
 
 namespace eager_search {
+// Values of pending_index for states which are not pending.
+static const int NOT_PENDING = -1;
+static const int NOT_PENDING_PREFERRED = -2;
+
 EagerSearch::EagerSearch(const Options &opts)
     : SearchEngine(opts),
       reopen_closed_nodes(opts.get<bool>("reopen_closed")),
@@ -28,7 +33,10 @@ EagerSearch::EagerSearch(const Options &opts)
       f_evaluator(opts.get<shared_ptr<Evaluator>>("f_eval", nullptr)),
       preferred_operator_evaluators(opts.get_list<shared_ptr<Evaluator>>("preferred")),
       lazy_evaluator(opts.get<shared_ptr<Evaluator>>("lazy_evaluator", nullptr)),
-      pruning_method(opts.get<shared_ptr<PruningMethod>>("pruning")) {
+      pruning_method(opts.get<shared_ptr<PruningMethod>>("pruning")),
+      batch_evaluators(opts.get_list<shared_ptr<Evaluator>>("batch_evaluators")),
+      batch_expansions(opts.get<int>("batch_expansions")),
+      pending_index(NOT_PENDING) {
     if (lazy_evaluator && !lazy_evaluator->does_cache_estimates()) {
         cerr << "lazy_evaluator must cache its estimates" << endl;
         utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
@@ -102,18 +110,141 @@ void EagerSearch::initialize() {
     pruning_method->initialize(task);
 }
 
+bool EagerSearch::supports_checkpoints() const {
+    // The information of path-dependent evaluators is not stored.
+    return path_dependent_evaluators.empty();
+}
+
+void EagerSearch::load_checkpoint(utils::BinaryReader &reader) {
+    SearchEngine::load_checkpoint(reader);
+    /*
+      The open list is not stored. Instead, it is rebuilt from the open
+      search nodes, which are evaluated again (as non-preferred states).
+    */
+    assert(pending_successors.empty());
+    open_list->clear();
+    int num_open = 0;
+    for (StateID id : state_registry) {
+        State state = state_registry.lookup_state(id);
+        SearchNode node = search_space.get_node(state);
+        if (!node.is_open()) {
+            continue;
+        }
+        EvaluationContext eval_context(state, node.get_g(), false, &statistics);
+        if (open_list->is_dead_end(eval_context)) {
+            node.mark_as_dead_end();
+            statistics.inc_dead_ends();
+        } else {
+            open_list->insert(eval_context, id);
+            ++num_open;
+        }
+    }
+    utils::g_log << "Reinserted " << num_open << " open states." << endl;
+}
+
+bool EagerSearch::supports_restarts() const {
+    // The information of path-dependent evaluators depends on the order of
+    // the transitions.
+    return path_dependent_evaluators.empty();
+}
+
+void EagerSearch::restart_with(SearchEngine &phase) {
+    EagerSearch *next = dynamic_cast<EagerSearch *>(&phase);
+    if (!next) {
+        cerr << "All phases of a restarted search must be eager searches."
+             << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+    }
+    // Batches are always inserted completely within a step.
+    assert(pending_successors.empty());
+    if (found_solution()) {
+        SearchNode goal_node = search_space.get_node(get_goal_state());
+        if (goal_node.is_closed()) {
+            goal_node.reopen();
+        }
+    }
+    prepare_restart(phase);
+    reopen_closed_nodes = next->reopen_closed_nodes;
+    open_list = move(next->open_list);
+    f_evaluator = next->f_evaluator;
+    preferred_operator_evaluators = next->preferred_operator_evaluators;
+    lazy_evaluator = next->lazy_evaluator;
+    pruning_method = next->pruning_method;
+    batch_evaluators = next->batch_evaluators;
+    batch_expansions = next->batch_expansions;
+
+    set<Evaluator *> evals;
+    open_list->get_path_dependent_evaluators(evals);
+    for (const shared_ptr<Evaluator> &evaluator : preferred_operator_evaluators) {
+        evaluator->get_path_dependent_evaluators(evals);
+    }
+    if (f_evaluator) {
+        f_evaluator->get_path_dependent_evaluators(evals);
+    }
+    if (lazy_evaluator) {
+        lazy_evaluator->get_path_dependent_evaluators(evals);
+    }
+    if (!evals.empty()) {
+        cerr << "Restarted searches do not support path-dependent evaluators."
+             << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+    }
+    pruning_method->initialize(task);
+
+    /*
+      Continue with the open states and the inconsistent closed states of
+      the previous phase (ARA*). All other closed states keep their
+      g-values. The goal state of the previous phase was reopened above, so
+      a cheaper path to it is expanded. States whose real g-value reaches
+      the bound are kept open but not inserted, as their successors are
+      pruned.
+    */
+    for (StateID id : inconsistent_states) {
+        SearchNode node = search_space.get_node(state_registry.lookup_state(id));
+        if (node.is_closed()) {
+            node.reopen();
+        }
+    }
+    inconsistent_states.clear();
+    int num_open = 0;
+    for (StateID id : state_registry) {
+        State state = state_registry.lookup_state(id);
+        SearchNode node = search_space.get_node(state);
+        if (!node.is_open() || node.get_real_g() >= bound) {
+            continue;
+        }
+        EvaluationContext eval_context(state, node.get_g(), false, &statistics);
+        if (open_list->is_dead_end(eval_context)) {
+            node.mark_as_dead_end();
+            statistics.inc_dead_ends();
+        } else {
+            open_list->insert(eval_context, id);
+            ++num_open;
+        }
+    }
+    utils::g_log << "Restarted search with " << num_open << " open states."
+                 << endl;
+}
+
 void EagerSearch::print_statistics() const {
     statistics.print_detailed_statistics();
     search_space.print_statistics();
     pruning_method->print_statistics();
 }
 
-SearchStatus EagerSearch::step() {
+tl::optional<SearchNode> EagerSearch::fetch_next_node() {
+    tl::optional<SearchNode> node = fetch_next_open_node();
+    if (node) {
+        close_for_expansion(*node);
+    }
+    return node;
+}
+
+tl::optional<SearchNode> EagerSearch::fetch_next_open_node() {
     tl::optional<SearchNode> node;
     while (true) {
         if (open_list->empty()) {
-            utils::g_log << "Completely explored state space -- no solution!" << endl;
-            return FAILED;
+            return tl::nullopt;
         }
         StateID id = open_list->remove_min();
         State s = state_registry.lookup_state(id);
@@ -161,11 +292,33 @@ SearchStatus EagerSearch::step() {
             }
         }
 
-        node->close();
-        assert(!node->is_dead_end());
-        update_f_value_statistics(eval_context);
-        statistics.inc_expanded();
-        break;
+        return node;
+    }
+}
+
+void EagerSearch::close_for_expansion(SearchNode &node) {
+    /*
+      Count the expansion first: if it exceeds max_expansions, the node
+      stays open, so a checkpoint written at the limit does not contain a
+      closed node that was never expanded.
+    */
+    statistics.inc_expanded();
+    node.close();
+    assert(!node.is_dead_end());
+    EvaluationContext eval_context(
+        node.get_state(), node.get_g(), false, &statistics);
+    update_f_value_statistics(eval_context);
+}
+
+SearchStatus EagerSearch::step() {
+    tl::optional<SearchNode> node = fetch_next_node();
+    if (!node) {
+        utils::g_log << "Completely explored state space -- no solution!" << endl;
+        return FAILED;
+    }
+
+    if (!batch_evaluators.empty()) {
+        return batched_step(*node);
     }
 
     const State &s = node->get_state();
@@ -220,6 +373,7 @@ SearchStatus EagerSearch::step() {
 
             EvaluationContext succ_eval_context(
                 succ_state, succ_g, is_preferred, &statistics);
+            succ_eval_context.set_transition(s.get_id(), op_id);
             statistics.inc_evaluated_states();
 
             if (open_list->is_dead_end(succ_eval_context)) {
@@ -274,6 +428,9 @@ SearchStatus EagerSearch::step() {
                 // If we do not reopen closed nodes, we just update the parent pointers.
                 // Note that this could cause an incompatibility between
                 // the g-value and the actual path that is traced back.
+                if (succ_node.is_closed()) {
+                    inconsistent_states.push_back(succ_state.get_id());
+                }
                 succ_node.update_parent(*node, op, get_adjusted_cost(op));
             }
         }
@@ -282,6 +439,163 @@ SearchStatus EagerSearch::step() {
     return IN_PROGRESS;
 }
 
+SearchStatus EagerSearch::batched_step(const SearchNode &first_node) {
+    // Each batch is evaluated and inserted before the step returns.
+    assert(pending_successors.empty());
+    if (check_goal_and_set_plan(first_node.get_state()))
+        return SOLVED;
+    expand_into_batch(first_node);
+    try {
+        fill_batch();
+    } catch (const MaximumExpansionsError &) {
+        /*
+          The pending successors stay open without being in the open list.
+          Checkpoints and restarts insert all open nodes again.
+        */
+        for (const PendingSuccessor &pending : pending_successors) {
+            pending_index[pending.state] = NOT_PENDING;
+        }
+        pending_successors.clear();
+        throw;
+    }
+    evaluate_batch();
+    return IN_PROGRESS;
+}
+
+void EagerSearch::fill_batch() {
+    for (int num_expanded = 1; num_expanded < batch_expansions; ++num_expanded) {
+        tl::optional<SearchNode> node = fetch_next_open_node();
+        if (!node)
+            break;
+        const State &s = node->get_state();
+        if (task_properties::is_goal_state(task_proxy, s)) {
+            /*
+              The pending successors may lead to a cheaper goal. We return
+              the goal node to the open list (unexpanded and as preferred as
+              it was before), so that it is only goal-tested as the first
+              node of a later batch, i.e., after the pending successors were
+              inserted.
+            */
+            bool is_preferred = pending_index[s] == NOT_PENDING_PREFERRED;
+            EvaluationContext eval_context(
+                s, node->get_g(), is_preferred, &statistics);
+            open_list->insert(eval_context, s.get_id());
+            break;
+        }
+        close_for_expansion(*node);
+        expand_into_batch(*node);
+    }
+}
+
+void EagerSearch::expand_into_batch(const SearchNode &node) {
+    const State &s = node.get_state();
+    vector<OperatorID> applicable_ops;
+    successor_generator.generate_applicable_ops(s, applicable_ops);
+    pruning_method->prune_operators(s, applicable_ops);
+
+    // This evaluates the expanded state (again) to get preferred ops
+    EvaluationContext eval_context(s, node.get_g(), false, &statistics, true);
+    ordered_set::OrderedSet<OperatorID> preferred_operators;
+    for (const shared_ptr<Evaluator> &preferred_operator_evaluator : preferred_operator_evaluators) {
+        collect_preferred_operators(eval_context,
+                                    preferred_operator_evaluator.get(),
+                                    preferred_operators);
+    }
+
+    for (OperatorID op_id : applicable_ops) {
+        OperatorProxy op = task_proxy.get_operators()[op_id];
+        if ((node.get_real_g() + op.get_cost()) >= bound)
+            continue;
+
+        State succ_state = state_registry.get_successor_state(s, op);
+        statistics.inc_generated();
+        bool is_preferred = preferred_operators.contains(op_id);
+
+        SearchNode succ_node = search_space.get_node(succ_state);
+
+        for (Evaluator *evaluator : path_dependent_evaluators) {
+            evaluator->notify_state_transition(s, op_id, succ_state);
+        }
+
+        // Previously encountered dead end. Don't re-evaluate.
+        if (succ_node.is_dead_end())
+            continue;
+
+        int succ_g = node.get_g() + get_adjusted_cost(op);
+        if (succ_node.is_new()) {
+            /*
+              Open the node right away s.t. states that are generated again
+              within the same batch are recognized as duplicates. The node is
+              evaluated (and possibly marked as dead end) in evaluate_batch.
+            */
+            succ_node.open(node, op, get_adjusted_cost(op));
+            pending_index[succ_state] = pending_successors.size();
+            pending_successors.emplace_back(
+                succ_state, is_preferred, s.get_id(), op_id);
+        } else if (succ_node.get_g() > succ_g) {
+            if (pending_index[succ_state] >= 0) {
+                // Not yet evaluated. It is inserted with the updated g value.
+                succ_node.update_parent(node, op, get_adjusted_cost(op));
+            } else if (reopen_closed_nodes) {
+                if (succ_node.is_closed()) {
+                    statistics.inc_reopened();
+                }
+                succ_node.reopen(node, op, get_adjusted_cost(op));
+                EvaluationContext succ_eval_context(
+                    succ_state, succ_node.get_g(), is_preferred, &statistics);
+                open_list->insert(succ_eval_context, succ_state.get_id());
+                pending_index[succ_state] =
+                    is_preferred ? NOT_PENDING_PREFERRED : NOT_PENDING;
+            } else {
+                if (succ_node.is_closed()) {
+                    inconsistent_states.push_back(succ_state.get_id());
+                }
+                succ_node.update_parent(node, op, get_adjusted_cost(op));
+            }
+        }
+    }
+}
+
+void EagerSearch::evaluate_batch() {
+    vector<EvaluationContext> eval_contexts;
+    eval_contexts.reserve(pending_successors.size());
+    for (const PendingSuccessor &pending : pending_successors) {
+        SearchNode succ_node = search_space.get_node(pending.state);
+        eval_contexts.emplace_back(
+            pending.state, succ_node.get_g(), pending.is_preferred, &statistics);
+        eval_contexts.back().set_transition(
+            pending.parent_id, pending.creating_operator);
+        pending_index[pending.state] =
+            pending.is_preferred ? NOT_PENDING_PREFERRED : NOT_PENDING;
+    }
+    pending_successors.clear();
+
+    for (const shared_ptr<Evaluator> &evaluator : batch_evaluators) {
+        vector<EvaluationResult> results = evaluator->compute_results(eval_contexts);
+        assert(results.size() == eval_contexts.size());
+        for (size_t i = 0; i < eval_contexts.size(); ++i) {
+            eval_contexts[i].set_result(evaluator.get(), move(results[i]));
+        }
+    }
+
+    for (EvaluationContext &succ_eval_context : eval_contexts) {
+        const State &succ_state = succ_eval_context.get_state();
+        SearchNode succ_node = search_space.get_node(succ_state);
+        statistics.inc_evaluated_states();
+
+        if (open_list->is_dead_end(succ_eval_context)) {
+            succ_node.mark_as_dead_end();
+            statistics.inc_dead_ends();
+            continue;
+        }
+        open_list->insert(succ_eval_context, succ_state.get_id());
+        if (search_progress.check_progress(succ_eval_context)) {
+            statistics.print_checkpoint_line(succ_node.get_g());
+            reward_progress();
+        }
+    }
+}
+
 void EagerSearch::reward_progress() {
     // Boost the "preferred operator" open lists somewhat whenever
     // one of the heuristics finds a state with a new best h value.
@@ -309,6 +623,24 @@ void EagerSearch::update_f_value_statistics(EvaluationContext &eval_context) {
 }
 
 void add_options_to_parser(OptionParser &parser) {
+    parser.add_list_option<shared_ptr<Evaluator>>(
+        "batch_evaluators",
+        "If non-empty, the new successors of batch_expansions expanded nodes "
+        "are first collected and then evaluated together by these evaluators "
+        "before they are inserted into the open list. This is useful for "
+        "evaluators which profit from batched evaluations (e.g. network "
+        "heuristics). All other evaluators are still evaluated state by state.",
+        "[]");
+    parser.add_option<int>(
+        "batch_expansions",
+        "Number of nodes expanded before their successors are evaluated "
+        "(only used if batch_evaluators is non-empty). Only the first node "
+        "of a batch is goal-tested; a goal state fetched later is returned "
+        "to the open list. With more than one expansion per batch, a node "
+        "can be expanded before a cheaper path to it is inserted, so "
+        "optimal searches need reopen_closed=true (as set by astar).",
+        "1",
+        Bounds("1", "infinity"));
     SearchEngine::add_pruning_option(parser);
     SearchEngine::add_options_to_parser(parser);
 }
@@ -2,9 +2,11 @@
 #define SEARCH_ENGINES_EAGER_SEARCH_H
 
 #include "../open_list.h"
+#include "../per_state_information.h"
 #include "../search_engine.h"
 
 #include <memory>
+#include <optional.hh>
 #include <vector>
 
 class Evaluator;
@@ -17,7 +19,7 @@ class Options;
 
 namespace eager_search {
 class EagerSearch : public SearchEngine {
-    const bool reopen_closed_nodes;
+    bool reopen_closed_nodes;
 
     std::unique_ptr<StateOpenList> open_list;
     std::shared_ptr<Evaluator> f_evaluator;
@@ -28,6 +30,50 @@ class EagerSearch : public SearchEngine {
 
     std::shared_ptr<PruningMethod> pruning_method;
 
+    /*
+      Batched expansion: the new successors of up to batch_expansions
+      expanded nodes are collected and evaluated together by the
+      batch_evaluators (via Evaluator::compute_results) before they are
+      inserted into the open list.
+    */
+    std::vector<std::shared_ptr<Evaluator>> batch_evaluators;
+    int batch_expansions;
+    struct PendingSuccessor {
+        State state;
+        bool is_preferred;
+        StateID parent_id;
+        OperatorID creating_operator;
+
+        PendingSuccessor(const State &state, bool is_preferred,
+                         StateID parent_id, OperatorID creating_operator)
+            : state(state), is_preferred(is_preferred),
+              parent_id(parent_id), creating_operator(creating_operator) {
+        }
+    };
+    std::vector<PendingSuccessor> pending_successors;
+    /*
+      Index of a state in pending_successors. States which are not pending
+      are NOT_PENDING or, if they were last inserted into the open list as
+      preferred successors, NOT_PENDING_PREFERRED.
+    */
+    PerStateInformation<int> pending_index;
+
+    /*
+      Closed states whose g-value decreased without reopening them. They
+      are reopened when the search is restarted (like INCONS in ARA*).
+    */
+    std::vector<StateID> inconsistent_states;
+
+    tl::optional<SearchNode> fetch_next_node();
+    // Remove the next node to expand from the open list without closing it.
+    tl::optional<SearchNode> fetch_next_open_node();
+    void close_for_expansion(SearchNode &node);
+    SearchStatus batched_step(const SearchNode &first_node);
+    // Expand further nodes into the batch of batched_step.
+    void fill_batch();
+    void expand_into_batch(const SearchNode &node);
+    void evaluate_batch();
+
     void start_f_value_statistics(EvaluationContext &eval_context);
     void update_f_value_statistics(EvaluationContext &eval_context);
     void reward_progress();
@@ -36,12 +82,18 @@ protected:
     virtual void initialize() override;
     virtual SearchStatus step() override;
 
+    virtual bool supports_checkpoints() const override;
+    virtual void load_checkpoint(utils::BinaryReader &reader) override;
+
 public:
     explicit EagerSearch(const options::Options &opts);
     virtual ~EagerSearch() = default;
 
     virtual void print_statistics() const override;
 
+    virtual bool supports_restarts() const override;
+    virtual void restart_with(SearchEngine &phase) override;
+
     void dump_search_space() const;
 };
 
@@ -0,0 +1,516 @@
+#include "external_astar.h"
+
+#include "../evaluation_context.h"
+#include "../evaluator.h"
+#include "../option_parser.h"
+#include "../plugin.h"
+
+#include "../algorithms/int_packer.h"
+#include "../task_utils/successor_generator.h"
+#include "../task_utils/task_properties.h"
+#include "../utils/logging.h"
+#include "../utils/memory.h"
+#include "../utils/system.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <queue>
+#include <set>
+
+using namespace std;
+
+namespace external_astar {
+static const PackedStateBin NO_OPERATOR = numeric_limits<PackedStateBin>::max();
+// Bucket buffers are written to disk if they contain this many words.
+static const size_t FLUSH_WORDS = 1 << 16;
+// Words read from a file at once.
+static const size_t READ_WORDS = 1 << 16;
+// The scratch registry is replaced if it contains this many states.
+static const size_t MAX_SCRATCH_STATES = 100000;
+
+/*
+  Reads the records of a file block by block. The returned pointer stays
+  valid until the next call of next().
+*/
+class RecordReader {
+    ifstream in;
+    const int record_size;
+    vector<PackedStateBin> block;
+    size_t pos;
+    size_t end;
+    long long &bytes_read;
+public:
+    RecordReader(const string &path, int record_size, long long &bytes_read)
+        : in(path, ios::binary),
+          record_size(record_size),
+          block(max(READ_WORDS / record_size, size_t(1)) * record_size),
+          pos(0),
+          end(0),
+          bytes_read(bytes_read) {
+        if (!in) {
+            cerr << "Could not open " << path << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+        }
+    }
+
+    // Return the next record or nullptr at the end of the file.
+    const PackedStateBin *next() {
+        if (pos == end) {
+            in.read(reinterpret_cast<char *>(block.data()),
+                    block.size() * sizeof(PackedStateBin));
+            bytes_read += in.gcount();
+            end = in.gcount() / sizeof(PackedStateBin);
+            pos = 0;
+            if (end == 0) {
+                return nullptr;
+            }
+            assert(end % record_size == 0);
+        }
+        const PackedStateBin *record = &block[pos];
+        pos += record_size;
+        return record;
+    }
+};
+
+ExternalAStar::ExternalAStar(const Options &opts)
+    : SearchEngine(opts),
+      evaluator(opts.get<shared_ptr<Evaluator>>("eval")),
+      directory(opts.get<string>("directory")),
+      file_prefix("external-astar-" + to_string(utils::get_process_id())),
+      sort_memory(static_cast<size_t>(opts.get<int>("sort_memory")) << 20),
+      state_packer(nullptr),
+      num_bins(0),
+      record_size(0),
+      max_run_records(0),
+      num_buffered_words(0),
+      num_files(0),
+      bytes_written(0),
+      bytes_read(0),
+      num_duplicates(0) {
+}
+
+ExternalAStar::~ExternalAStar() {
+    for (auto &entry : buckets) {
+        const Bucket &bucket = entry.second;
+        if (!bucket.open_path.empty()) {
+            remove_file(bucket.open_path);
+        }
+        for (const string &path : bucket.closed_paths) {
+            remove_file(path);
+        }
+    }
+}
+
+void ExternalAStar::initialize() {
+    utils::g_log << "Conducting external memory A* search in " << directory
+                 << ", (real) bound = " << bound << endl;
+
+    set<Evaluator *> path_dependent_evaluators;
+    evaluator->get_path_dependent_evaluators(path_dependent_evaluators);
+    if (!path_dependent_evaluators.empty()) {
+        cerr << "external_astar does not support path-dependent evaluators."
+             << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+    }
+    // Positive costs ensure that the parent of a state is in a bucket with
+    // a lower g-value, which the bucket order and plan extraction rely on.
+    for (OperatorProxy op : task_proxy.get_operators()) {
+        if (get_adjusted_cost(op) <= 0) {
+            cerr << "external_astar needs positive operator costs "
+                 << "(e.g. use cost_type=plusone)." << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+        }
+    }
+
+    state_packer = &task_properties::g_state_packers[task_proxy];
+    num_bins = state_packer->get_num_bins();
+    record_size = num_bins + 1;
+    max_run_records = max(
+        sort_memory / (record_size * sizeof(PackedStateBin)), size_t(1));
+    scratch_registry = utils::make_unique_ptr<StateRegistry>(task_proxy);
+
+    const State &initial_state = scratch_registry->get_initial_state();
+    EvaluationContext eval_context(initial_state, 0, false, &statistics);
+    statistics.inc_evaluated_states();
+    print_initial_evaluator_values(eval_context);
+    if (eval_context.is_evaluator_value_infinite(evaluator.get())) {
+        utils::g_log << "Initial state is a dead end." << endl;
+        return;
+    }
+    vector<PackedStateBin> record(
+        initial_state.get_buffer(), initial_state.get_buffer() + num_bins);
+    record.push_back(NO_OPERATOR);
+    add_record(0, eval_context.get_evaluator_value(evaluator.get()), record);
+}
+
+string ExternalAStar::get_new_path(int g, int h) {
+    return directory + "/" + file_prefix + "-g" + to_string(g) + "-h" +
+           to_string(h) + "-" + to_string(num_files++);
+}
+
+void ExternalAStar::remove_file(const string &path) {
+    remove(path.c_str());
+}
+
+bool ExternalAStar::get_next_bucket(int &g, int &h) const {
+    bool found = false;
+    for (const auto &entry : buckets) {
+        if (entry.second.num_open_records == 0) {
+            continue;
+        }
+        int bucket_g = entry.first.first;
+        int bucket_h = entry.first.second;
+        if (!found || bucket_g + bucket_h < g + h ||
+            (bucket_g + bucket_h == g + h && bucket_g < g)) {
+            g = bucket_g;
+            h = bucket_h;
+            found = true;
+        }
+    }
+    return found;
+}
+
+void ExternalAStar::add_record(
+    int g, int h, const vector<PackedStateBin> &record) {
+    assert(static_cast<int>(record.size()) == record_size);
+    Bucket &bucket = buckets[make_pair(g, h)];
+    if (bucket.open_path.empty()) {
+        bucket.open_path = get_new_path(g, h) + ".open";
+    }
+    bucket.buffer.insert(bucket.buffer.end(), record.begin(), record.end());
+    ++bucket.num_open_records;
+    num_buffered_words += record_size;
+    if (bucket.buffer.size() >= FLUSH_WORDS) {
+        flush_bucket(bucket);
+    }
+    if (num_buffered_words >= max_run_records * record_size) {
+        flush_all_buckets();
+    }
+}
+
+void ExternalAStar::flush_bucket(Bucket &bucket) {
+    if (bucket.buffer.empty()) {
+        return;
+    }
+    ofstream out(bucket.open_path, ios::binary | ios::app);
+    size_t num_bytes = bucket.buffer.size() * sizeof(PackedStateBin);
+    out.write(reinterpret_cast<const char *>(bucket.buffer.data()), num_bytes);
+    if (!out) {
+        cerr << "Could not write " << bucket.open_path << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+    }
+    bytes_written += num_bytes;
+    num_buffered_words -= bucket.buffer.size();
+    vector<PackedStateBin>().swap(bucket.buffer);
+}
+
+void ExternalAStar::flush_all_buckets() {
+    for (auto &entry : buckets) {
+        flush_bucket(entry.second);
+    }
+}
+
+/*
+  Sort the open records of the bucket in runs of max_run_records records,
+  remove the duplicates within each run and write the runs to disk.
+*/
+vector<string> ExternalAStar::sort_runs(Bucket &bucket) {
+    flush_bucket(bucket);
+    size_t state_bytes = num_bins * sizeof(PackedStateBin);
+    vector<string> run_paths;
+    RecordReader reader(bucket.open_path, record_size, bytes_read);
+    const PackedStateBin *record = reader.next();
+    vector<PackedStateBin> records;
+    vector<size_t> order;
+    while (record) {
+        records.clear();
+        while (record && records.size() < max_run_records * record_size) {
+            records.insert(records.end(), record, record + record_size);
+            record = reader.next();
+        }
+        size_t num_records = records.size() / record_size;
+        order.resize(num_records);
+        for (size_t i = 0; i < num_records; ++i) {
+            order[i] = i * record_size;
+        }
+        sort(order.begin(), order.end(),
+             [&](size_t lhs, size_t rhs) {
+                 return memcmp(&records[lhs], &records[rhs], state_bytes) < 0;
+             });
+
+        run_paths.push_back(get_new_path(-1, -1) + ".run");
+        ofstream out(run_paths.back(), ios::binary);
+        const PackedStateBin *last = nullptr;
+        for (size_t offset : order) {
+            const PackedStateBin *current = &records[offset];
+            if (last && memcmp(last, current, state_bytes) == 0) {
+                ++num_duplicates;
+                continue;
+            }
+            out.write(reinterpret_cast<const char *>(current),
+                      record_size * sizeof(PackedStateBin));
+            bytes_written += record_size * sizeof(PackedStateBin);
+            last = current;
+        }
+        if (!out) {
+            cerr << "Could not write " << run_paths.back() << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+        }
+    }
+    remove_file(bucket.open_path);
+    bucket.open_path.clear();
+    bucket.num_open_records = 0;
+    return run_paths;
+}
+
+vector<int> ExternalAStar::unpack(const PackedStateBin *record) const {
+    int num_variables = task_proxy.get_variables().size();
+    vector<int> values(num_variables);
+    for (int var = 0; var < num_variables; ++var) {
+        values[var] = state_packer->get(record, var);
+    }
+    return values;
+}
+
+void ExternalAStar::expand(const PackedStateBin *record, int g) {
+    State state = task_proxy.create_state(unpack(record));
+    vector<OperatorID> applicable_ops;
+    successor_generator.generate_applicable_ops(state, applicable_ops);
+    statistics.inc_expanded();
+    statistics.inc_generated_ops(applicable_ops.size());
+
+    if (scratch_registry->size() >= MAX_SCRATCH_STATES) {
+        scratch_registry = utils::make_unique_ptr<StateRegistry>(task_proxy);
+    }
+    vector<PackedStateBin> succ_record(record_size);
+    for (OperatorID op_id : applicable_ops) {
+        OperatorProxy op = task_proxy.get_operators()[op_id];
+        int succ_g = g + get_adjusted_cost(op);
+        if (succ_g >= bound) {
+            continue;
+        }
+        State succ_state = state.get_unregistered_successor(op);
+        // Evaluators cache per registered state, so we register it.
+        State registered_succ = scratch_registry->insert_state(
+            vector<int>(succ_state.get_unpacked_values()));
+        statistics.inc_generated();
+
+        EvaluationContext eval_context(
+            registered_succ, succ_g, false, &statistics);
+        statistics.inc_evaluated_states();
+        if (eval_context.is_evaluator_value_infinite(evaluator.get())) {
+            statistics.inc_dead_ends();
+            continue;
+        }
+        int succ_h = eval_context.get_evaluator_value(evaluator.get());
+        const PackedStateBin *buffer = registered_succ.get_buffer();
+        copy(buffer, buffer + num_bins, succ_record.begin());
+        succ_record[num_bins] = op_id.get_index();
+        add_record(succ_g, succ_h, succ_record);
+    }
+}
+
+SearchStatus ExternalAStar::step() {
+    int g = 0;
+    int h = 0;
+    if (!get_next_bucket(g, h)) {
+        utils::g_log << "Completely explored state space -- no solution!"
+                     << endl;
+        return FAILED;
+    }
+    statistics.report_f_value_progress(g + h);
+    Bucket &bucket = buckets[make_pair(g, h)];
+    vector<string> run_paths = sort_runs(bucket);
+    size_t state_bytes = num_bins * sizeof(PackedStateBin);
+    auto less_state = [&](const PackedStateBin *lhs, const PackedStateBin *rhs) {
+                          return memcmp(lhs, rhs, state_bytes) < 0;
+                      };
+
+    // Merge the runs.
+    vector<unique_ptr<RecordReader>> run_readers;
+    vector<const PackedStateBin *> run_records;
+    auto greater_run = [&](int lhs, int rhs) {
+                           return less_state(run_records[rhs], run_records[lhs]);
+                       };
+    priority_queue<int, vector<int>, decltype(greater_run)> queue(greater_run);
+    for (const string &path : run_paths) {
+        run_readers.push_back(utils::make_unique_ptr<RecordReader>(
+                                  path, record_size, bytes_read));
+        run_records.push_back(run_readers.back()->next());
+        if (run_records.back()) {
+            queue.push(run_records.size() - 1);
+        }
+    }
+
+    // States expanded before can only be in closed buckets with the same h.
+    vector<unique_ptr<RecordReader>> closed_readers;
+    vector<const PackedStateBin *> closed_records;
+    for (auto &entry : buckets) {
+        if (entry.first.second == h && entry.first.first <= g) {
+            for (const string &path : entry.second.closed_paths) {
+                closed_readers.push_back(utils::make_unique_ptr<RecordReader>(
+                                             path, record_size, bytes_read));
+                closed_records.push_back(closed_readers.back()->next());
+            }
+        }
+    }
+
+    string closed_path = get_new_path(g, h) + ".closed";
+    ofstream closed_out(closed_path, ios::binary);
+    bucket.closed_paths.push_back(closed_path);
+    vector<PackedStateBin> current(record_size);
+    vector<PackedStateBin> last;
+    SearchStatus status = IN_PROGRESS;
+    while (!queue.empty()) {
+        int run = queue.top();
+        queue.pop();
+        copy(run_records[run], run_records[run] + record_size, current.begin());
+        run_records[run] = run_readers[run]->next();
+        if (run_records[run]) {
+            queue.push(run);
+        }
+
+        if (!last.empty() && !less_state(last.data(), current.data())) {
+            ++num_duplicates;
+            continue;
+        }
+        last = current;
+        bool is_closed = false;
+        for (size_t i = 0; i < closed_readers.size(); ++i) {
+            while (closed_records[i] &&
+                   less_state(closed_records[i], current.data())) {
+                closed_records[i] = closed_readers[i]->next();
+            }
+            if (closed_records[i] &&
+                !less_state(current.data(), closed_records[i])) {
+                is_closed = true;
+            }
+        }
+        if (is_closed) {
+            ++num_duplicates;
+            continue;
+        }
+
+        closed_out.write(reinterpret_cast<const char *>(current.data()),
+                         record_size * sizeof(PackedStateBin));
+        bytes_written += record_size * sizeof(PackedStateBin);
+        State state = task_proxy.create_state(unpack(current.data()));
+        if (task_properties::is_goal_state(task_proxy, state)) {
+            utils::g_log << "Solution found!" << endl;
+            closed_out.close();
+            extract_plan(current, g);
+            status = SOLVED;
+            break;
+        }
+        expand(current.data(), g);
+    }
+    if (!closed_out) {
+        cerr << "Could not write " << closed_path << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+    }
+
+    run_readers.clear();
+    for (const string &path : run_paths) {
+        remove_file(path);
+    }
+    return status;
+}
+
+void ExternalAStar::extract_plan(vector<PackedStateBin> record, int g) {
+    Plan plan;
+    vector<PackedStateBin> succ_buffer(num_bins);
+    while (record[num_bins] != NO_OPERATOR) {
+        OperatorID op_id(record[num_bins]);
+        OperatorProxy op = task_proxy.get_operators()[op_id];
+        int parent_g = g - get_adjusted_cost(op);
+        bool found = false;
+        for (auto &entry : buckets) {
+            if (entry.first.first != parent_g) {
+                continue;
+            }
+            for (const string &path : entry.second.closed_paths) {
+                RecordReader reader(path, record_size, bytes_read);
+                while (const PackedStateBin *parent = reader.next()) {
+                    State state = task_proxy.create_state(unpack(parent));
+                    if (!task_properties::is_applicable(op, state)) {
+                        continue;
+                    }
+                    State succ_state = state.get_unregistered_successor(op);
+                    fill(succ_buffer.begin(), succ_buffer.end(), 0);
+                    for (size_t var = 0; var < succ_state.size(); ++var) {
+                        state_packer->set(
+                            succ_buffer.data(), var, succ_state[var].get_value());
+                    }
+                    if (equal(succ_buffer.begin(), succ_buffer.end(),
+                              record.begin())) {
+                        record.assign(parent, parent + record_size);
+                        found = true;
+                        break;
+                    }
+                }
+                if (found) {
+                    break;
+                }
+            }
+            if (found) {
+                break;
+            }
+        }
+        if (!found) {
+            cerr << "Could not find the parent of a state on the plan." << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+        }
+        plan.push_back(op_id);
+        g = parent_g;
+    }
+    reverse(plan.begin(), plan.end());
+    set_plan(plan);
+}
+
+void ExternalAStar::print_statistics() const {
+    statistics.print_detailed_statistics();
+    utils::g_log << "Buckets: " << buckets.size() << endl;
+    utils::g_log << "Removed duplicates: " << num_duplicates << endl;
+    utils::g_log << "Bytes written: " << bytes_written << endl;
+    utils::g_log << "Bytes read: " << bytes_read << endl;
+}
+
+static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
+    parser.document_synopsis(
+        "External memory A*",
+        "A* with delayed duplicate detection which keeps the search space in "
+        "files instead of memory. The states are stored in buckets by "
+        "(g, h) and every bucket is sorted and merged with sequential disk "
+        "accesses only. The plan is optimal for admissible heuristics.");
+    parser.document_note(
+        "Operator costs",
+        "All operators must have positive (adjusted) costs, e.g. use "
+        "cost_type=plusone for tasks with zero-cost operators.");
+    parser.add_option<shared_ptr<Evaluator>>("eval", "evaluator for h-value");
+    parser.add_option<string>(
+        "directory",
+        "directory for the bucket files",
+        ".");
+    parser.add_option<int>(
+        "sort_memory",
+        "memory in MiB for sorting the records of a bucket and for buffering "
+        "generated records",
+        "256",
+        Bounds("1", "infinity"));
+    SearchEngine::add_options_to_parser(parser);
+    Options opts = parser.parse();
+
+    shared_ptr<ExternalAStar> engine;
+    if (!parser.dry_run()) {
+        engine = make_shared<ExternalAStar>(opts);
+    }
+
+    return engine;
+}
+
+static Plugin<SearchEngine> _plugin("external_astar", _parse);
+}
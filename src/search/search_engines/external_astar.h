@@ -0,0 +1,100 @@
+#ifndef SEARCH_ENGINES_EXTERNAL_ASTAR_H
+#define SEARCH_ENGINES_EXTERNAL_ASTAR_H
+
+#include "../search_engine.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+class Evaluator;
+
+namespace options {
+class OptionParser;
+class Options;
+}
+
+namespace external_astar {
+/*
+  External memory A* with delayed duplicate detection (Edelkamp, Jabbar and
+  Schroedl, 2004).
+
+  The search space is partitioned into buckets by (g, h). Every bucket
+  consists of
+    - open records: the generated states, appended to a file in the order
+      they are generated (including duplicates), and
+    - closed files: sorted runs of the states expanded from the bucket.
+  A record is a packed state (as in the state registry) followed by the ID
+  of the operator which generated it.
+
+  The buckets are processed by increasing f = g + h and then by increasing
+  g. To process a bucket, its open records are sorted in runs that fit into
+  memory and merged. While merging, duplicates are removed and states which
+  are contained in a closed file of a bucket (g', h) with g' <= g are
+  subtracted (a state always has the same h-value, so duplicates can only be
+  in buckets with the same h). Thus, all accesses to the disk are
+  sequential. The remaining states are expanded and written to a new closed
+  file of the bucket.
+
+  No parent pointers are stored. To extract the plan, the parent of a state
+  reached with operator o is searched by scanning the closed files of the
+  buckets with g - cost(o).
+*/
+class ExternalAStar : public SearchEngine {
+    struct Bucket {
+        std::vector<PackedStateBin> buffer;
+        std::string open_path;
+        long long num_open_records = 0;
+        std::vector<std::string> closed_paths;
+    };
+
+    std::shared_ptr<Evaluator> evaluator;
+    const std::string directory;
+    const std::string file_prefix;
+    const size_t sort_memory;
+
+    const int_packer::IntPacker *state_packer;
+    int num_bins;
+    // Words per record (packed state and operator ID).
+    int record_size;
+    // Number of records sorted in memory at once.
+    size_t max_run_records;
+
+    // Buckets indexed by (g, h).
+    std::map<std::pair<int, int>, Bucket> buckets;
+    size_t num_buffered_words;
+    int num_files;
+
+    // A small registry to evaluate the successors of the current bucket.
+    std::unique_ptr<StateRegistry> scratch_registry;
+
+    long long bytes_written;
+    long long bytes_read;
+    long long num_duplicates;
+
+    std::string get_new_path(int g, int h);
+    bool get_next_bucket(int &g, int &h) const;
+    void add_record(int g, int h, const std::vector<PackedStateBin> &record);
+    void flush_bucket(Bucket &bucket);
+    void flush_all_buckets();
+    std::vector<std::string> sort_runs(Bucket &bucket);
+    void expand(const PackedStateBin *record, int g);
+    std::vector<int> unpack(const PackedStateBin *record) const;
+    void extract_plan(std::vector<PackedStateBin> goal_record, int g);
+    void remove_file(const std::string &path);
+
+protected:
+    virtual void initialize() override;
+    virtual SearchStatus step() override;
+
+public:
+    explicit ExternalAStar(const options::Options &opts);
+    virtual ~ExternalAStar() override;
+
+    virtual void print_statistics() const override;
+};
+}
+
+#endif
@@ -0,0 +1,444 @@
+#include "hda_search.h"
+
+#include "search_common.h"
+
+#include "../evaluation_context.h"
+#include "../evaluator.h"
+#include "../open_list_factory.h"
+#include "../option_parser.h"
+#include "../plugin.h"
+
+#include "../task_utils/successor_generator.h"
+#include "../task_utils/task_properties.h"
+#include "../utils/countdown_timer.h"
+#include "../utils/hash.h"
+#include "../utils/logging.h"
+#include "../utils/memory.h"
+#include "../utils/system.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <set>
+#include <thread>
+
+using namespace std;
+
+namespace hda_search {
+static const int INF = numeric_limits<int>::max();
+
+/*
+  Return the parse tree of the "eval" argument (keyword or first positional
+  argument) of the given engine configuration.
+*/
+static options::ParseTree get_evaluator_parse_tree(
+    const string &unparsed_config) {
+    options::ParseTree pt = options::generate_parse_tree(unparsed_config);
+    auto first = options::first_child_of_root(pt);
+    for (auto it = first; it != options::end_of_roots_children(pt); ++it) {
+        if (it->key == "eval" || (it == first && it->key.empty())) {
+            return options::subtree(pt, it);
+        }
+    }
+    cerr << "hda: missing evaluator in " << unparsed_config << endl;
+    utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+}
+
+/*
+  Predefined objects would be shared by the evaluators of all workers, no
+  matter how deeply they are nested in the evaluator definition.
+*/
+static void check_no_predefinitions(
+    const options::ParseTree &parse_tree,
+    const options::Predefinitions &predefinitions) {
+    for (const options::ParseNode &node : parse_tree) {
+        if (predefinitions.contains(node.value)) {
+            cerr << "hda: every thread needs its own evaluator, but the "
+                 << "evaluator uses the predefined object '" << node.value
+                 << "'. Define it inside the search engine instead." << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+        }
+    }
+}
+
+HDASearch::Worker::Worker(
+    int id, const shared_ptr<Evaluator> &evaluator, bool greedy,
+    utils::Verbosity verbosity)
+    : id(id),
+      evaluator(evaluator),
+      statistics(verbosity, numeric_limits<int>::max()) {
+    if (greedy) {
+        open_list = search_common::create_standard_scalar_open_list_factory(
+            evaluator, false)->create_state_open_list();
+    } else {
+        Options opts;
+        opts.set("eval", evaluator);
+        open_list = search_common::create_astar_open_list_factory_and_f_eval(
+            opts).first->create_state_open_list();
+    }
+}
+
+HDASearch::HDASearch(const Options &opts)
+    : SearchEngine(opts),
+      num_threads(opts.get<int>("threads")),
+      greedy(opts.get<bool>("greedy")),
+      max_expansions(opts.get<int>("max_expansions")),
+      max_states(opts.get<int>("max_states")),
+      outstanding(0),
+      stop(false),
+      timed_out(false),
+      num_expansions(0),
+      reached_max_expansions(false),
+      incumbent_cost(INF) {
+    evaluators.push_back(opts.get<shared_ptr<Evaluator>>("eval"));
+    /*
+      Evaluators are not thread-safe. Every worker gets its own instance
+      which is parsed again from the definition of the first one.
+    */
+    options::ParseTree eval_parse_tree =
+        get_evaluator_parse_tree(opts.get_unparsed_config());
+    if (num_threads > 1) {
+        check_no_predefinitions(eval_parse_tree, *opts.get_predefinitions());
+    }
+    for (int i = 1; i < num_threads; ++i) {
+        options::OptionParser parser(
+            eval_parse_tree, *opts.get_registry(), *opts.get_predefinitions(),
+            false);
+        evaluators.push_back(parser.start_parsing<shared_ptr<Evaluator>>());
+    }
+}
+
+HDASearch::~HDASearch() {
+}
+
+void HDASearch::initialize() {
+    utils::g_log << "Conducting hash distributed "
+                 << (greedy ? "greedy best first search" : "A* search")
+                 << " with " << num_threads << " threads, (real) bound = "
+                 << bound << endl;
+
+    set<Evaluator *> path_dependent_evaluators;
+    evaluators.front()->get_path_dependent_evaluators(path_dependent_evaluators);
+    if (!path_dependent_evaluators.empty()) {
+        cerr << "hda: path-dependent evaluators are not supported, because "
+             << "the transitions between states of different threads are "
+             << "not observable." << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+    }
+
+    /*
+      The per-task information (state packer, axiom evaluator, successor
+      generator) is created lazily and must exist before the threads start.
+      The registry creates the state packer and the axiom evaluator.
+    */
+    shared_registry = utils::make_unique_ptr<ConcurrentStateRegistry>(
+        task_proxy, max_states);
+    node_infos = utils::make_unique_ptr<ConcurrentPerStateInformation<NodeInfo>>(
+        *shared_registry);
+    for (int i = 0; i < num_threads; ++i) {
+        workers.push_back(utils::make_unique_ptr<Worker>(
+                              i, evaluators[i], greedy, verbosity));
+    }
+
+    State initial_state = task_proxy.get_initial_state();
+    initial_state.unpack();
+    StateID initial_id =
+        shared_registry->insert_state(initial_state.get_unpacked_values()).first;
+    Worker &owner = *workers[get_owner(initial_id)];
+    owner.inbox.emplace_back(
+        initial_id, 0, 0, StateID::no_state, OperatorID::no_operator);
+    outstanding = 1;
+}
+
+int HDASearch::get_owner(StateID id) const {
+    const PackedStateBin *buffer = shared_registry->lookup_buffer(id);
+    int num_bins =
+        shared_registry->get_state_size_in_bytes() / sizeof(PackedStateBin);
+    utils::HashState hash_state;
+    for (int i = 0; i < num_bins; ++i) {
+        hash_state.feed(buffer[i]);
+    }
+    return hash_state.get_hash64() % num_threads;
+}
+
+void HDASearch::send(Worker &sender, Message &&message) {
+    int receiver = get_owner(message.id);
+    if (receiver == sender.id) {
+        receive(sender, message);
+    } else {
+        sender.outbox[receiver].push_back(move(message));
+    }
+}
+
+void HDASearch::flush(Worker &sender) {
+    for (int receiver = 0; receiver < num_threads; ++receiver) {
+        vector<Message> &messages = sender.outbox[receiver];
+        if (messages.empty()) {
+            continue;
+        }
+        // The messages count as outstanding work before they become visible.
+        outstanding += messages.size();
+        Worker &worker = *workers[receiver];
+        {
+            lock_guard<mutex> lock(worker.inbox_mutex);
+            move(messages.begin(), messages.end(), back_inserter(worker.inbox));
+        }
+        worker.inbox_cv.notify_one();
+        messages.clear();
+    }
+}
+
+void HDASearch::receive(Worker &worker, const Message &message) {
+    NodeInfo &info = (*node_infos)[message.id];
+    bool is_new = info.g == -1;
+    if (info.dead_end || (!is_new && info.g <= message.g) ||
+        (greedy && !is_new)) {
+        return;
+    }
+
+    // The state is not registered in a StateRegistry, so it is not cached.
+    State state = task_proxy.create_state(
+        shared_registry->lookup_values(message.id));
+    EvaluationContext eval_context(
+        state, message.g, false, &worker.statistics);
+    if (is_new) {
+        worker.statistics.inc_evaluated_states();
+        if (worker.open_list->is_dead_end(eval_context)) {
+            info.dead_end = true;
+            worker.statistics.inc_dead_ends();
+            return;
+        }
+        info.h = eval_context.get_evaluator_value(worker.evaluator.get());
+    } else {
+        if (info.closed) {
+            worker.statistics.inc_reopened();
+        }
+        EvaluationResult result;
+        result.set_evaluator_value(info.h);
+        result.set_count_evaluation(false);
+        eval_context.set_result(worker.evaluator.get(), move(result));
+    }
+    info.g = message.g;
+    info.real_g = message.real_g;
+    info.closed = false;
+    info.parent_id = message.parent_id;
+    info.creating_operator = message.creating_operator;
+    if (!greedy && info.g + info.h >= incumbent_cost) {
+        return;
+    }
+    worker.open_list->insert(eval_context, message.id);
+}
+
+void HDASearch::expand_next(Worker &worker) {
+    StateID id = worker.open_list->remove_min();
+    NodeInfo &info = (*node_infos)[id];
+    if (info.closed || (!greedy && info.g + info.h >= incumbent_cost)) {
+        return;
+    }
+    if (num_expansions++ >= max_expansions) {
+        reached_max_expansions = true;
+        stop = true;
+        return;
+    }
+    info.closed = true;
+    worker.statistics.inc_expanded();
+
+    State state = task_proxy.create_state(shared_registry->lookup_values(id));
+    if (task_properties::is_goal_state(task_proxy, state)) {
+        lock_guard<mutex> lock(solution_mutex);
+        if (info.g < incumbent_cost) {
+            incumbent_cost = info.g;
+            goal_id = id;
+            if (greedy) {
+                stop = true;
+            }
+        }
+        return;
+    }
+
+    vector<OperatorID> applicable_ops;
+    successor_generator.generate_applicable_ops(state, applicable_ops);
+    worker.statistics.inc_generated_ops(applicable_ops.size());
+    for (OperatorID op_id : applicable_ops) {
+        OperatorProxy op = task_proxy.get_operators()[op_id];
+        int succ_real_g = info.real_g + op.get_cost();
+        int succ_g = info.g + get_adjusted_cost(op);
+        if (succ_real_g >= bound || (!greedy && succ_g >= incumbent_cost)) {
+            continue;
+        }
+
+        pair<StateID, bool> succ = shared_registry->get_successor_state(id, op);
+        worker.statistics.inc_generated();
+        // In greedy mode, only the first path to a state is considered.
+        if (greedy && !succ.second) {
+            continue;
+        }
+        send(worker, Message(succ.first, succ_g, succ_real_g, id, op_id));
+    }
+}
+
+void HDASearch::run_worker(Worker &worker) {
+    worker.outbox.resize(num_threads);
+    // An active worker counts as outstanding work.
+    bool active = false;
+    int num_steps = 0;
+    vector<Message> messages;
+    while (!stop) {
+        {
+            lock_guard<mutex> lock(worker.inbox_mutex);
+            messages.swap(worker.inbox);
+        }
+        if (!messages.empty()) {
+            if (!active) {
+                ++outstanding;
+                active = true;
+            }
+            for (Message &message : messages) {
+                receive(worker, message);
+            }
+            outstanding -= messages.size();
+            messages.clear();
+        }
+
+        if (!worker.open_list->empty()) {
+            expand_next(worker);
+            flush(worker);
+            if (++num_steps % 256 == 0 && timer->is_expired()) {
+                timed_out = true;
+                stop = true;
+            }
+            continue;
+        }
+
+        if (active) {
+            active = false;
+            --outstanding;
+        }
+        if (outstanding == 0) {
+            stop = true;
+            break;
+        }
+        unique_lock<mutex> lock(worker.inbox_mutex);
+        worker.inbox_cv.wait_for(
+            lock, chrono::milliseconds(1),
+            [&]() {return !worker.inbox.empty() || stop;});
+    }
+}
+
+void HDASearch::extract_plan() {
+    Plan plan;
+    StateID id = goal_id;
+    while (true) {
+        const NodeInfo &info = (*node_infos)[id];
+        if (info.creating_operator == OperatorID::no_operator) {
+            break;
+        }
+        plan.push_back(info.creating_operator);
+        id = info.parent_id;
+    }
+    reverse(plan.begin(), plan.end());
+    set_plan(plan);
+}
+
+SearchStatus HDASearch::step() {
+    vector<thread> threads;
+    for (int i = 1; i < num_threads; ++i) {
+        threads.emplace_back(&HDASearch::run_worker, this, ref(*workers[i]));
+    }
+    run_worker(*workers[0]);
+    for (thread &t : threads) {
+        t.join();
+    }
+
+    for (const unique_ptr<Worker> &worker : workers) {
+        const SearchStatistics &stats = worker->statistics;
+        statistics.inc_expanded(stats.get_expanded());
+        statistics.inc_evaluated_states(stats.get_evaluated_states());
+        statistics.inc_evaluations(stats.get_evaluations());
+        statistics.inc_generated(stats.get_generated());
+        statistics.inc_reopened(stats.get_reopened());
+        statistics.inc_generated_ops(stats.get_generated_ops());
+        statistics.inc_dead_ends(stats.get_dead_ends());
+    }
+
+    /*
+      In A* mode, an incumbent solution is not known to be optimal before
+      the search space below its cost is exhausted.
+    */
+    if (reached_max_expansions && (!greedy || goal_id == StateID::no_state)) {
+        throw MaximumExpansionsError(
+            "Maximum number of expansions reached. Abort search.");
+    }
+    if (goal_id != StateID::no_state) {
+        utils::g_log << "Solution found!" << endl;
+        extract_plan();
+        return SOLVED;
+    }
+    if (timed_out) {
+        return TIMEOUT;
+    }
+    utils::g_log << "Completely explored state space -- no solution!" << endl;
+    return FAILED;
+}
+
+void HDASearch::print_statistics() const {
+    statistics.print_detailed_statistics();
+    utils::g_log << "Expanded states per thread:";
+    for (const unique_ptr<Worker> &worker : workers) {
+        utils::g_log << " " << worker->statistics.get_expanded();
+    }
+    utils::g_log << endl;
+    shared_registry->print_statistics();
+}
+
+static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
+    parser.document_synopsis(
+        "Hash distributed A* (HDA*)",
+        "Parallel A* (or greedy best first search) which distributes the "
+        "states by their hash values among several threads. Every thread "
+        "evaluates and expands only its own states and sends the successors "
+        "owned by other threads to them. The states are registered in one "
+        "state registry shared by all threads. In A* mode, the search "
+        "continues after the first solution until no state with an f-value "
+        "below the best solution cost is left. Hence, the solution is "
+        "optimal for admissible heuristics.");
+    parser.document_note(
+        "Evaluators",
+        "Every thread needs its own evaluator object. Thus, the evaluator "
+        "has to be defined inside the search engine (it is parsed once per "
+        "thread) and must not use predefined evaluators or landmark "
+        "factories at any depth. Path-dependent evaluators are not "
+        "supported. The option max_expansions limits the expansions of all "
+        "threads together.");
+    parser.add_option<shared_ptr<Evaluator>>("eval", "evaluator for h-value");
+    parser.add_option<int>(
+        "threads",
+        "number of worker threads",
+        "1",
+        Bounds("1", "infinity"));
+    parser.add_option<bool>(
+        "greedy",
+        "Order the states by h instead of g + h and stop at the first "
+        "solution found.",
+        "false");
+    parser.add_option<int>(
+        "max_states",
+        "Capacity of the shared state registry. It cannot grow, so the "
+        "search stops with an out of memory error if more states are "
+        "generated. The registry allocates 16 to 32 bytes per state for its "
+        "hash table on construction.",
+        "4000000",
+        Bounds("1", "1000000000"));
+    SearchEngine::add_options_to_parser(parser);
+    Options opts = parser.parse();
+
+    shared_ptr<HDASearch> engine;
+    if (!parser.dry_run()) {
+        engine = make_shared<HDASearch>(opts);
+    }
+
+    return engine;
+}
+
+static Plugin<SearchEngine> _plugin("hda", _parse);
+}
@@ -0,0 +1,135 @@
+#ifndef SEARCH_ENGINES_HDA_SEARCH_H
+#define SEARCH_ENGINES_HDA_SEARCH_H
+
+#include "../concurrent_per_state_information.h"
+#include "../concurrent_state_registry.h"
+#include "../open_list.h"
+#include "../search_engine.h"
+
+#include "../options/parse_tree.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class Evaluator;
+
+namespace options {
+class OptionParser;
+class Options;
+}
+
+namespace hda_search {
+/*
+  Hash distributed best-first search (HDA*, Kishimoto et al., 2009) with
+  shared memory threads.
+
+  All workers register their states in one ConcurrentStateRegistry, so the
+  duplicate detection is shared and messages only carry state IDs. Every
+  state is owned by the worker thread hash(state) % threads, which keeps its
+  node information (in a ConcurrentPerStateInformation shared by all
+  workers, but only accessed by the owner), evaluates it with its own
+  evaluator and inserts it into its own open list. A worker registers the
+  successors of the states it expands and sends them to their owners.
+
+  The search terminates if no work is left, i.e. all open lists are empty
+  and no states are in transit (or a goal is found in greedy mode). For
+  this, "outstanding" counts the workers which are not idle plus the sent
+  but not yet processed messages. It only becomes 0 if no work is left
+  and afterwards nobody can create new work.
+
+  In A* mode, the first goal found is only an incumbent solution. States
+  are pruned if g + h is not smaller than the incumbent cost and the
+  search continues until all workers run out of states. Thus, with an
+  admissible heuristic, the returned plan is optimal.
+*/
+class HDASearch : public SearchEngine {
+    struct Message {
+        StateID id;
+        int g;
+        int real_g;
+        StateID parent_id;
+        OperatorID creating_operator;
+
+        Message(StateID id, int g, int real_g, StateID parent_id,
+                OperatorID creating_operator)
+            : id(id), g(g), real_g(real_g), parent_id(parent_id),
+              creating_operator(creating_operator) {
+        }
+    };
+
+    struct NodeInfo {
+        // g is -1 for states which were never reached.
+        int g = -1;
+        int real_g = -1;
+        int h = 0;
+        bool closed = false;
+        bool dead_end = false;
+        StateID parent_id = StateID::no_state;
+        OperatorID creating_operator = OperatorID::no_operator;
+    };
+
+    struct Worker {
+        const int id;
+        std::shared_ptr<Evaluator> evaluator;
+        std::unique_ptr<StateOpenList> open_list;
+        SearchStatistics statistics;
+
+        // Messages sent to this worker.
+        std::mutex inbox_mutex;
+        std::condition_variable inbox_cv;
+        std::vector<Message> inbox;
+
+        // Messages of this worker not yet sent (one buffer per receiver).
+        std::vector<std::vector<Message>> outbox;
+
+        Worker(int id, const std::shared_ptr<Evaluator> &evaluator,
+               bool greedy, utils::Verbosity verbosity);
+    };
+
+    const int num_threads;
+    const bool greedy;
+    // Limit on the expansions of all workers together.
+    const int max_expansions;
+    const int max_states;
+    // One evaluator per worker, parsed separately from the same definition.
+    std::vector<std::shared_ptr<Evaluator>> evaluators;
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    std::unique_ptr<ConcurrentStateRegistry> shared_registry;
+    std::unique_ptr<ConcurrentPerStateInformation<NodeInfo>> node_infos;
+
+    std::atomic<long long> outstanding;
+    std::atomic<bool> stop;
+    std::atomic<bool> timed_out;
+    std::atomic<long long> num_expansions;
+    std::atomic<bool> reached_max_expansions;
+
+    std::mutex solution_mutex;
+    std::atomic<int> incumbent_cost;
+    StateID goal_id = StateID::no_state;
+
+    int get_owner(StateID id) const;
+    void send(Worker &sender, Message &&message);
+    void flush(Worker &sender);
+    void receive(Worker &worker, const Message &message);
+    void expand_next(Worker &worker);
+    void run_worker(Worker &worker);
+    void extract_plan();
+
+protected:
+    virtual void initialize() override;
+    virtual SearchStatus step() override;
+
+public:
+    explicit HDASearch(const options::Options &opts);
+    virtual ~HDASearch() override;
+
+    virtual void print_statistics() const override;
+};
+}
+
+#endif
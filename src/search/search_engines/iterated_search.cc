@@ -20,6 +20,7 @@ IteratedSearch::IteratedSearch(const Options &opts, options::Registry &registry,
       repeat_last_phase(opts.get<bool>("repeat_last")),
       continue_on_fail(opts.get<bool>("continue_on_fail")),
       continue_on_solve(opts.get<bool>("continue_on_solve")),
+      reuse_state(opts.get<bool>("reuse_state")),
       phase(0),
       last_phase_found_solution(false),
       best_bound(bound),
@@ -58,6 +59,16 @@ shared_ptr<SearchEngine> IteratedSearch::create_current_phase() {
     return get_search_engine(phase);
 }
 
+void IteratedSearch::add_phase_statistics(
+    const SearchStatistics &stats, int factor) {
+    statistics.inc_expanded(factor * stats.get_expanded());
+    statistics.inc_evaluated_states(factor * stats.get_evaluated_states());
+    statistics.inc_evaluations(factor * stats.get_evaluations());
+    statistics.inc_generated(factor * stats.get_generated());
+    statistics.inc_generated_ops(factor * stats.get_generated_ops());
+    statistics.inc_reopened(factor * stats.get_reopened());
+}
+
 SearchStatus IteratedSearch::step() {
     shared_ptr<SearchEngine> current_search = create_current_phase();
     if (!current_search) {
@@ -68,8 +79,26 @@ SearchStatus IteratedSearch::step() {
     }
     ++phase;
 
+    if (reused_search) {
+        // The statistics of the reused engine are cumulative.
+        add_phase_statistics(reused_search->get_statistics(), -1);
+        reused_search->restart_with(*current_search);
+        current_search = reused_search;
+    }
+
     current_search->search();
 
+    if (reuse_state && !reused_search) {
+        if (current_search->supports_restarts()) {
+            reused_search = current_search;
+        } else {
+            utils::g_log << "Warning: the search engine does not support "
+                         << "restarts, every phase starts from scratch."
+                         << endl;
+            reuse_state = false;
+        }
+    }
+
     Plan found_plan;
     int plan_cost = 0;
     last_phase_found_solution = current_search->found_solution();
@@ -84,14 +113,7 @@ SearchStatus IteratedSearch::step() {
         }
     }
     current_search->print_statistics();
-
-    const SearchStatistics &current_stats = current_search->get_statistics();
-    statistics.inc_expanded(current_stats.get_expanded());
-    statistics.inc_evaluated_states(current_stats.get_evaluated_states());
-    statistics.inc_evaluations(current_stats.get_evaluations());
-    statistics.inc_generated(current_stats.get_generated());
-    statistics.inc_generated_ops(current_stats.get_generated_ops());
-    statistics.inc_reopened(current_stats.get_reopened());
+    add_phase_statistics(current_search->get_statistics(), 1);
 
     return step_return_value();
 }
@@ -133,8 +155,8 @@ static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
     parser.document_synopsis("Iterated search", "");
     parser.document_note(
         "Note 1",
-        "We don't cache heuristic values between search iterations at"
-        " the moment. If you perform a LAMA-style iterative search,"
+        "Without reuse_state, we don't cache heuristic values between "
+        "search iterations. If you perform a LAMA-style iterative search,"
         " heuristic values will be computed multiple times.");
     parser.document_note(
         "Note 2",
@@ -172,6 +194,20 @@ static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
     parser.add_option<bool>("continue_on_solve",
                             "continue search after solution found",
                             "true");
+    parser.add_option<bool>(
+        "reuse_state",
+        "Keep the engine of the first phase and restart it with the open "
+        "list, evaluators and options of the following phases (e.g. lower "
+        "weights) instead of searching from scratch. The registered states, "
+        "their g-values and the evaluator caches are shared between the "
+        "phases: the new open list contains the open states and the closed "
+        "states whose g-value decreased in the previous phase (as in ARA*), "
+        "which are evaluated again (looked up in the cache of predefined "
+        "heuristics). Supported for eager searches with the same cost_type "
+        "and without path-dependent evaluators; other engines search every "
+        "phase from scratch. Use heuristic predefinition to share the "
+        "heuristic caches.",
+        "false");
     SearchEngine::add_options_to_parser(parser);
     Options opts = parser.parse();
 
@@ -24,6 +24,12 @@ class IteratedSearch : public SearchEngine {
     bool repeat_last_phase;
     bool continue_on_fail;
     bool continue_on_solve;
+    /*
+      If reuse_state is set, the engine of the first phase is kept and
+      restarted with the parameters of the following phases.
+    */
+    bool reuse_state;
+    std::shared_ptr<SearchEngine> reused_search;
 
     int phase;
     bool last_phase_found_solution;
@@ -33,6 +39,7 @@ class IteratedSearch : public SearchEngine {
     std::shared_ptr<SearchEngine> get_search_engine(int engine_configs_index);
     std::shared_ptr<SearchEngine> create_current_phase();
     SearchStatus step_return_value();
+    void add_phase_statistics(const SearchStatistics &stats, int factor);
 
     virtual SearchStatus step() override;
 
@@ -1,10 +1,24 @@
 #include "search_node_info.h"
 
-static const int pointer_bytes = sizeof(void *);
-static const int info_bytes = 3 * sizeof(int) + sizeof(StateID);
-static const int padding_bytes = info_bytes % pointer_bytes;
+using namespace std;
 
-static_assert(
-    sizeof(SearchNodeInfo) == info_bytes + padding_bytes,
-    "The size of SearchNodeInfo is larger than expected. This probably means "
-    "that packing two fields into one integer using bitfields is not supported.");
+SearchNodeLayout::SearchNodeLayout(
+    ParentPointers parent_pointers, bool store_real_g)
+    : parent_index(-1),
+      operator_index(-1),
+      real_g_index(-1),
+      size(1) {
+    if (parent_pointers != ParentPointers::NONE)
+        parent_index = size++;
+    if (parent_pointers == ParentPointers::FULL)
+        operator_index = size++;
+    if (store_real_g)
+        real_g_index = size++;
+}
+
+vector<int> SearchNodeLayout::get_default_entry() const {
+    // Status NEW and g = -1 are encoded as 0.
+    vector<int> entry(size, -1);
+    entry[0] = 0;
+    return entry;
+}
@@ -4,21 +4,137 @@
 #include "operator_id.h"
 #include "state_id.h"
 
+#include <cassert>
+#include <vector>
+
 // For documentation on classes relevant to storing and working with registered
 // states see the file state_registry.h.
 
-struct SearchNodeInfo {
+/*
+  Determines which information is stored to reconstruct the path to a state.
+    FULL: the parent state and the creating operator.
+    STATE: only the parent state. The creating operator is recomputed by
+      applying the operators to the parent.
+    NONE: nothing. A predecessor is found by regressing the state over the
+      operators and looking up the resulting states and their g-values in
+      the state registry.
+*/
+enum class ParentPointers {
+    FULL,
+    STATE,
+    NONE
+};
+
+/*
+  The search node information of a state is stored as an array of ints
+  whose length depends on the layout. The first entry always packs the
+  status (2 bits) and g + 1 (30 bits). The parent state, the creating
+  operator and the real g-value follow if they are stored. Unused fields
+  have index -1. The real g-value is only stored if it can differ from g,
+  i.e., if action costs are adjusted.
+*/
+class SearchNodeLayout {
+    int parent_index;
+    int operator_index;
+    int real_g_index;
+    int size;
+public:
+    SearchNodeLayout(ParentPointers parent_pointers, bool store_real_g);
+
+    bool stores_parent() const {
+        return parent_index != -1;
+    }
+
+    bool stores_operator() const {
+        return operator_index != -1;
+    }
+
+    bool stores_real_g() const {
+        return real_g_index != -1;
+    }
+
+    int get_size() const {
+        return size;
+    }
+
+    std::vector<int> get_default_entry() const;
+
+    friend class SearchNodeInfo;
+};
+
+
+/*
+  View of the search node information of one state. Fields that are not
+  stored must not be set to other values than the ones implied by the
+  layout (no parent, g as real g) and are reported as such.
+*/
+class SearchNodeInfo {
+    int *data;
+    const SearchNodeLayout *layout;
+
+    unsigned int get_header() const {
+        return static_cast<unsigned int>(data[0]);
+    }
+
+    void set_header(unsigned int status, int g) {
+        assert(g >= -1 && g + 1 < (1 << 30));
+        data[0] = static_cast<int>(
+            (static_cast<unsigned int>(g + 1) << 2) | status);
+    }
+public:
     enum NodeStatus {NEW = 0, OPEN = 1, CLOSED = 2, DEAD_END = 3};
 
-    unsigned int status : 2;
-    int g : 30;
-    StateID parent_state_id;
-    OperatorID creating_operator;
-    int real_g;
+    SearchNodeInfo(int *data, const SearchNodeLayout &layout)
+        : data(data), layout(&layout) {
+    }
+
+    NodeStatus get_status() const {
+        return static_cast<NodeStatus>(get_header() & 3);
+    }
+
+    void set_status(NodeStatus status) {
+        set_header(status, get_g());
+    }
+
+    int get_g() const {
+        return static_cast<int>(get_header() >> 2) - 1;
+    }
+
+    void set_g(int g) {
+        set_header(get_status(), g);
+    }
+
+    int get_real_g() const {
+        return layout->stores_real_g() ? data[layout->real_g_index] : get_g();
+    }
+
+    void set_real_g(int real_g) {
+        if (layout->stores_real_g())
+            data[layout->real_g_index] = real_g;
+        else
+            assert(real_g == get_g());
+    }
+
+    StateID get_parent_state_id() const {
+        if (layout->stores_parent())
+            return StateID(data[layout->parent_index]);
+        return StateID::no_state;
+    }
+
+    void set_parent_state_id(StateID id) {
+        if (layout->stores_parent())
+            data[layout->parent_index] = id.value;
+    }
+
+    OperatorID get_creating_operator() const {
+        if (layout->stores_operator())
+            return OperatorID(data[layout->operator_index]);
+        return OperatorID::no_operator;
+    }
 
-    SearchNodeInfo()
-        : status(NEW), g(-1), parent_state_id(StateID::no_state),
-          creating_operator(-1), real_g(-1) {
+    void set_creating_operator(OperatorID op_id) {
+        if (layout->stores_operator())
+            data[layout->operator_index] = op_id.get_index();
     }
 };
 
@@ -4,13 +4,17 @@
 #include "task_proxy.h"
 
 #include "task_utils/task_properties.h"
+#include "utils/binary_io.h"
 #include "utils/logging.h"
+#include "utils/system.h"
 
+#include <algorithm>
 #include <cassert>
+#include <unordered_set>
 
 using namespace std;
 
-SearchNode::SearchNode(const State &state, SearchNodeInfo &info)
+SearchNode::SearchNode(const State &state, const SearchNodeInfo &info)
     : state(state), info(info) {
     assert(state.get_id() != StateID::no_state);
 }
@@ -20,167 +24,357 @@ const State &SearchNode::get_state() const {
 }
 
 bool SearchNode::is_open() const {
-    return info.status == SearchNodeInfo::OPEN;
+    return info.get_status() == SearchNodeInfo::OPEN;
 }
 
 bool SearchNode::is_closed() const {
-    return info.status == SearchNodeInfo::CLOSED;
+    return info.get_status() == SearchNodeInfo::CLOSED;
 }
 
 bool SearchNode::is_dead_end() const {
-    return info.status == SearchNodeInfo::DEAD_END;
+    return info.get_status() == SearchNodeInfo::DEAD_END;
 }
 
 bool SearchNode::is_new() const {
-    return info.status == SearchNodeInfo::NEW;
+    return info.get_status() == SearchNodeInfo::NEW;
 }
 
 int SearchNode::get_g() const {
-    assert(info.g >= 0);
-    return info.g;
+    assert(info.get_g() >= 0);
+    return info.get_g();
 }
 
 int SearchNode::get_real_g() const {
-    return info.real_g;
+    return info.get_real_g();
 }
 
 void SearchNode::open_initial() {
-    assert(info.status == SearchNodeInfo::NEW);
-    info.status = SearchNodeInfo::OPEN;
-    info.g = 0;
-    info.real_g = 0;
-    info.parent_state_id = StateID::no_state;
-    info.creating_operator = OperatorID::no_operator;
+    assert(info.get_status() == SearchNodeInfo::NEW);
+    info.set_status(SearchNodeInfo::OPEN);
+    info.set_g(0);
+    info.set_real_g(0);
+    info.set_parent_state_id(StateID::no_state);
+    info.set_creating_operator(OperatorID::no_operator);
 }
 
 void SearchNode::open(const SearchNode &parent_node,
                       const OperatorProxy &parent_op,
                       int adjusted_cost) {
-    assert(info.status == SearchNodeInfo::NEW);
-    info.status = SearchNodeInfo::OPEN;
-    info.g = parent_node.info.g + adjusted_cost;
-    info.real_g = parent_node.info.real_g + parent_op.get_cost();
-    info.parent_state_id = parent_node.get_state().get_id();
-    info.creating_operator = OperatorID(parent_op.get_id());
+    assert(info.get_status() == SearchNodeInfo::NEW);
+    info.set_status(SearchNodeInfo::OPEN);
+    update_parent(parent_node, parent_op, adjusted_cost);
 }
 
 void SearchNode::reopen() {
-    assert(info.status == SearchNodeInfo::OPEN ||
-           info.status == SearchNodeInfo::CLOSED);
-    info.status = SearchNodeInfo::OPEN;
+    assert(info.get_status() == SearchNodeInfo::OPEN ||
+           info.get_status() == SearchNodeInfo::CLOSED);
+    info.set_status(SearchNodeInfo::OPEN);
 }
 
 void SearchNode::reopen(const SearchNode &parent_node,
                         const OperatorProxy &parent_op,
                         int adjusted_cost) {
-    assert(info.status == SearchNodeInfo::OPEN ||
-           info.status == SearchNodeInfo::CLOSED);
+    assert(info.get_status() == SearchNodeInfo::OPEN ||
+           info.get_status() == SearchNodeInfo::CLOSED);
 
     // The latter possibility is for inconsistent heuristics, which
     // may require reopening closed nodes.
-    info.status = SearchNodeInfo::OPEN;
-    info.g = parent_node.info.g + adjusted_cost;
-    info.real_g = parent_node.info.real_g + parent_op.get_cost();
-    info.parent_state_id = parent_node.get_state().get_id();
-    info.creating_operator = OperatorID(parent_op.get_id());
+    info.set_status(SearchNodeInfo::OPEN);
+    update_parent(parent_node, parent_op, adjusted_cost);
 }
 
 // like reopen, except doesn't change status
 void SearchNode::update_parent(const SearchNode &parent_node,
                                const OperatorProxy &parent_op,
                                int adjusted_cost) {
-    assert(info.status == SearchNodeInfo::OPEN ||
-           info.status == SearchNodeInfo::CLOSED);
+    assert(info.get_status() == SearchNodeInfo::OPEN ||
+           info.get_status() == SearchNodeInfo::CLOSED);
     // The latter possibility is for inconsistent heuristics, which
     // may require reopening closed nodes.
-    info.g = parent_node.info.g + adjusted_cost;
-    info.real_g = parent_node.info.real_g + parent_op.get_cost();
-    info.parent_state_id = parent_node.get_state().get_id();
-    info.creating_operator = OperatorID(parent_op.get_id());
+    info.set_g(parent_node.info.get_g() + adjusted_cost);
+    info.set_real_g(parent_node.info.get_real_g() + parent_op.get_cost());
+    info.set_parent_state_id(parent_node.get_state().get_id());
+    info.set_creating_operator(OperatorID(parent_op.get_id()));
 }
 
 void SearchNode::close() {
-    assert(info.status == SearchNodeInfo::OPEN);
-    info.status = SearchNodeInfo::CLOSED;
+    assert(info.get_status() == SearchNodeInfo::OPEN);
+    info.set_status(SearchNodeInfo::CLOSED);
 }
 
 void SearchNode::mark_as_dead_end() {
-    info.status = SearchNodeInfo::DEAD_END;
+    info.set_status(SearchNodeInfo::DEAD_END);
 }
 
 void SearchNode::dump(const TaskProxy &task_proxy) const {
     utils::g_log << state.get_id() << ": ";
     task_properties::dump_fdr(state);
-    if (info.creating_operator != OperatorID::no_operator) {
+    OperatorID creating_operator = info.get_creating_operator();
+    if (creating_operator != OperatorID::no_operator) {
         OperatorsProxy operators = task_proxy.get_operators();
-        OperatorProxy op = operators[info.creating_operator.get_index()];
+        OperatorProxy op = operators[creating_operator.get_index()];
         utils::g_log << " created by " << op.get_name()
-                     << " from " << info.parent_state_id << endl;
+                     << " from " << info.get_parent_state_id() << endl;
     } else {
         utils::g_log << " no parent" << endl;
     }
 }
 
-SearchSpace::SearchSpace(StateRegistry &state_registry)
-    : state_registry(state_registry) {
+SearchSpace::SearchSpace(StateRegistry &state_registry,
+                         OperatorCost cost_type,
+                         ParentPointers parent_pointers)
+    : layout(parent_pointers, cost_type != NORMAL),
+      search_node_infos(layout.get_default_entry()),
+      state_registry(state_registry),
+      cost_type(cost_type),
+      is_unit_cost(task_properties::is_unit_cost(
+                       state_registry.get_task_proxy())) {
+    if (parent_pointers == ParentPointers::NONE) {
+        /*
+          Regression is only implemented for tasks without axioms and
+          conditional effects.
+        */
+        TaskProxy task_proxy = state_registry.get_task_proxy();
+        task_properties::verify_no_axioms(task_proxy);
+        task_properties::verify_no_conditional_effects(task_proxy);
+    }
 }
 
 SearchNode SearchSpace::get_node(const State &state) {
-    return SearchNode(state, search_node_infos[state]);
+    return SearchNode(
+        state, SearchNodeInfo(search_node_infos[state].data(), layout));
 }
 
-void SearchSpace::trace_path(const State &goal_state,
-                             vector<OperatorID> &path) const {
-    State current_state = goal_state;
-    assert(current_state.get_registry() == &state_registry);
-    assert(path.empty());
-    for (;;) {
-        const SearchNodeInfo &info = search_node_infos[current_state];
-        if (info.creating_operator == OperatorID::no_operator) {
-            assert(info.parent_state_id == StateID::no_state);
-            break;
+const SearchNodeInfo SearchSpace::get_info(const State &state) const {
+    // The returned object is const, so the data is never written.
+    ArrayView<const int> data = search_node_infos[state];
+    return SearchNodeInfo(const_cast<int *>(data.data()), layout);
+}
+
+int SearchSpace::get_adjusted_cost(const OperatorProxy &op) const {
+    return get_adjusted_action_cost(op, cost_type, is_unit_cost);
+}
+
+OperatorID SearchSpace::find_creating_operator(
+    const State &parent, const State &state) const {
+    /*
+      Among the operators leading from parent to state, choose the cheapest
+      one. Its cost is at most the cost of the operator that was used when
+      the parent was set.
+    */
+    parent.unpack();
+    state.unpack();
+    OperatorID best_op = OperatorID::no_operator;
+    int best_cost = -1;
+    for (OperatorProxy op : state_registry.get_task_proxy().get_operators()) {
+        if (!task_properties::is_applicable(op, parent))
+            continue;
+        int cost = get_adjusted_cost(op);
+        if (best_op != OperatorID::no_operator && cost >= best_cost)
+            continue;
+        State succ = parent.get_unregistered_successor(op);
+        if (succ.get_unpacked_values() == state.get_unpacked_values()) {
+            best_op = OperatorID(op.get_id());
+            best_cost = cost;
         }
-        path.push_back(info.creating_operator);
-        current_state = state_registry.lookup_state(info.parent_state_id);
     }
-    reverse(path.begin(), path.end());
+    assert(best_op != OperatorID::no_operator);
+    return best_op;
 }
 
-void SearchSpace::trace_path(const State &goal_state,
-                             vector<StateID> &trajectory) const {
-    State current_state = goal_state;
+vector<pair<StateID, OperatorID>> SearchSpace::find_predecessors(
+    const State &state) const {
+    /*
+      A registered state p is a predecessor of state via operator o if o
+      leads from p to state and g(p) + cost(o) <= g(state). The latter
+      holds for the parent that was stored last, so every reached state
+      except the initial state has such a predecessor. Since every
+      predecessor has been reached as well, following predecessors leads
+      back to the initial state, and the path costs at most g(state).
 
-    assert(trajectory.empty());
-    trajectory.push_back(goal_state.get_id());
-    for (;;) {
-        const SearchNodeInfo &info = search_node_infos[current_state];
-        if (info.creating_operator == OperatorID::no_operator) {
-            assert(info.parent_state_id == StateID::no_state);
-            break;
+      The candidates for p are obtained by regression: p agrees with state
+      on all variables not affected by o, has the precondition values of o
+      and any value on affected variables without precondition.
+    */
+    TaskProxy task_proxy = state_registry.get_task_proxy();
+    VariablesProxy variables = task_proxy.get_variables();
+    state.unpack();
+    const vector<int> &values = state.get_unpacked_values();
+    int g = get_info(state).get_g();
+
+    vector<pair<int, pair<StateID, OperatorID>>> predecessors;
+    for (OperatorProxy op : task_proxy.get_operators()) {
+        int cost = get_adjusted_cost(op);
+        if (cost > g)
+            continue;
+        bool consistent = true;
+        vector<int> candidate = values;
+        vector<int> free_vars;
+        for (EffectProxy effect : op.get_effects()) {
+            FactPair fact = effect.get_fact().get_pair();
+            if (values[fact.var] != fact.value) {
+                consistent = false;
+                break;
+            }
+            free_vars.push_back(fact.var);
+        }
+        if (!consistent)
+            continue;
+        for (FactProxy precondition : op.get_preconditions()) {
+            FactPair fact = precondition.get_pair();
+            if (find(free_vars.begin(), free_vars.end(), fact.var) ==
+                free_vars.end()) {
+                // Unaffected variables keep their value.
+                if (values[fact.var] != fact.value) {
+                    consistent = false;
+                    break;
+                }
+            } else {
+                free_vars.erase(
+                    find(free_vars.begin(), free_vars.end(), fact.var));
+            }
+            candidate[fact.var] = fact.value;
+        }
+        if (!consistent)
+            continue;
+
+        // Enumerate all values of the affected variables without precondition.
+        for (int var : free_vars)
+            candidate[var] = 0;
+        while (true) {
+            StateID id = state_registry.find_state(candidate);
+            if (id != StateID::no_state) {
+                int pred_g = get_info(state_registry.lookup_state(id)).get_g();
+                if (pred_g != -1 && pred_g + cost <= g) {
+                    predecessors.emplace_back(
+                        pred_g, make_pair(id, OperatorID(op.get_id())));
+                }
+            }
+            size_t i = 0;
+            for (; i < free_vars.size(); ++i) {
+                int var = free_vars[i];
+                if (++candidate[var] < variables[var].get_domain_size())
+                    break;
+                candidate[var] = 0;
+            }
+            if (i == free_vars.size())
+                break;
         }
-        trajectory.push_back(info.parent_state_id);
-        current_state = state_registry.lookup_state(info.parent_state_id);
     }
-    reverse(trajectory.begin(), trajectory.end());
+    // Prefer predecessors with low g-values.
+    sort(predecessors.begin(), predecessors.end(),
+         [](const pair<int, pair<StateID, OperatorID>> &lhs,
+            const pair<int, pair<StateID, OperatorID>> &rhs) {
+             return lhs.first < rhs.first;
+         });
+    vector<pair<StateID, OperatorID>> result;
+    result.reserve(predecessors.size());
+    for (const auto &predecessor : predecessors)
+        result.push_back(predecessor.second);
+    return result;
+}
+
+StateID SearchSpace::get_parent_id(const State &state) const {
+    if (layout.stores_parent())
+        return get_info(state).get_parent_state_id();
+    vector<pair<StateID, OperatorID>> predecessors = find_predecessors(state);
+    return predecessors.empty() ? StateID::no_state : predecessors[0].first;
+}
+
+OperatorID SearchSpace::get_creating_operator(const State &state) const {
+    const SearchNodeInfo info = get_info(state);
+    if (layout.stores_operator())
+        return info.get_creating_operator();
+    if (layout.stores_parent()) {
+        StateID parent_id = info.get_parent_state_id();
+        if (parent_id == StateID::no_state)
+            return OperatorID::no_operator;
+        return find_creating_operator(
+            state_registry.lookup_state(parent_id), state);
+    }
+    vector<pair<StateID, OperatorID>> predecessors = find_predecessors(state);
+    return predecessors.empty() ? OperatorID::no_operator : predecessors[0].second;
+}
+
+void SearchSpace::trace_path_without_parents(
+    const State &goal_state, vector<OperatorID> &path,
+    vector<StateID> &trajectory) const {
+    /*
+      Depth-first search from the goal state over predecessors (see
+      find_predecessors). It only backtracks in the presence of zero-cost
+      cycles.
+    */
+    struct Frame {
+        StateID state_id;
+        OperatorID op_id;
+        vector<pair<StateID, OperatorID>> predecessors;
+        size_t next;
+    };
+    StateID initial_state_id = state_registry.get_initial_state().get_id();
+    unordered_set<int> visited;
+    vector<Frame> stack;
+    stack.push_back({goal_state.get_id(), OperatorID::no_operator,
+                     find_predecessors(goal_state), 0});
+    visited.insert(goal_state.get_id().value);
+    while (stack.back().state_id != initial_state_id) {
+        Frame &frame = stack.back();
+        if (frame.next == frame.predecessors.size()) {
+            stack.pop_back();
+            if (stack.empty()) {
+                cerr << "Could not reconstruct the path to the goal state."
+                     << endl;
+                utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+            }
+            continue;
+        }
+        pair<StateID, OperatorID> predecessor = frame.predecessors[frame.next++];
+        if (!visited.insert(predecessor.first.value).second)
+            continue;
+        State state = state_registry.lookup_state(predecessor.first);
+        stack.push_back({predecessor.first, predecessor.second,
+                         find_predecessors(state), 0});
+    }
+    // The stack contains the path from the goal state to the initial state.
+    for (auto it = stack.rbegin(); it != stack.rend(); ++it) {
+        trajectory.push_back(it->state_id);
+        if (it->op_id != OperatorID::no_operator)
+            path.push_back(it->op_id);
+    }
+}
+
+void SearchSpace::trace_path(const State &goal_state,
+                             vector<OperatorID> &path) const {
+    vector<StateID> trajectory;
+    trace_path(goal_state, path, trajectory);
 }
 
 void SearchSpace::trace_path(const State &goal_state,
-                             vector<OperatorID> &path,
                              vector<StateID> &trajectory) const {
-    State current_state = goal_state;
+    vector<OperatorID> path;
+    trace_path(goal_state, path, trajectory);
+}
 
+void SearchSpace::trace_path(const State &goal_state,
+                             vector<OperatorID> &path,
+                             vector<StateID> &trajectory) const {
+    assert(goal_state.get_registry() == &state_registry);
     assert(path.empty());
     assert(trajectory.empty());
+    if (!layout.stores_parent()) {
+        trace_path_without_parents(goal_state, path, trajectory);
+        return;
+    }
+    State current_state = goal_state;
     trajectory.push_back(goal_state.get_id());
     for (;;) {
-        const SearchNodeInfo &info = search_node_infos[current_state];
-        if (info.creating_operator == OperatorID::no_operator) {
-            assert(info.parent_state_id == StateID::no_state);
+        StateID parent_id = get_info(current_state).get_parent_state_id();
+        if (parent_id == StateID::no_state) {
             break;
         }
-        path.push_back(info.creating_operator);
-        trajectory.push_back(info.parent_state_id);
-        current_state = state_registry.lookup_state(info.parent_state_id);
+        State parent_state = state_registry.lookup_state(parent_id);
+        path.push_back(get_creating_operator(current_state));
+        trajectory.push_back(parent_id);
+        current_state = parent_state;
     }
     reverse(path.begin(), path.end());
     reverse(trajectory.begin(), trajectory.end());
@@ -192,14 +386,15 @@ void SearchSpace::dump(const TaskProxy &task_proxy) const {
         /* The body duplicates SearchNode::dump() but we cannot create
            a search node without discarding the const qualifier. */
         State state = state_registry.lookup_state(id);
-        const SearchNodeInfo &node_info = search_node_infos[state];
+        const SearchNodeInfo node_info = get_info(state);
         utils::g_log << id << ": ";
         task_properties::dump_fdr(state);
-        if (node_info.creating_operator != OperatorID::no_operator &&
-            node_info.parent_state_id != StateID::no_state) {
-            OperatorProxy op = operators[node_info.creating_operator.get_index()];
+        if (node_info.get_creating_operator() != OperatorID::no_operator &&
+            node_info.get_parent_state_id() != StateID::no_state) {
+            OperatorProxy op =
+                operators[node_info.get_creating_operator().get_index()];
             utils::g_log << " created by " << op.get_name()
-                         << " from " << node_info.parent_state_id << endl;
+                         << " from " << node_info.get_parent_state_id() << endl;
         } else {
             utils::g_log << "has no parent" << endl;
         }
@@ -209,3 +404,31 @@ void SearchSpace::dump(const TaskProxy &task_proxy) const {
 void SearchSpace::print_statistics() const {
     state_registry.print_statistics();
 }
+
+void SearchSpace::save(utils::BinaryWriter &writer) const {
+    const PerStateArray<int> &infos = search_node_infos;
+    writer.write<int>(layout.get_size());
+    writer.write<uint64_t>(state_registry.size());
+    for (StateID id : state_registry) {
+        State state = state_registry.lookup_state(id);
+        writer.write_bytes(infos[state].data(), layout.get_size() * sizeof(int));
+    }
+}
+
+void SearchSpace::load(utils::BinaryReader &reader) {
+    int size = layout.get_size();
+    if (reader.read<int>() != size) {
+        cerr << "The stored search nodes were created with other "
+             << "parent_pointers or cost_type options." << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+    }
+    if (reader.read_size(size * sizeof(int)) != state_registry.size()) {
+        cerr << "The number of stored search nodes does not match the "
+             << "number of states." << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+    }
+    for (StateID id : state_registry) {
+        State state = state_registry.lookup_state(id);
+        reader.read_bytes(search_node_infos[state].data(), size * sizeof(int));
+    }
+}
@@ -2,21 +2,27 @@
 #define SEARCH_SPACE_H
 
 #include "operator_cost.h"
-#include "per_state_information.h"
+#include "per_state_array.h"
 #include "search_node_info.h"
 
+#include <utility>
 #include <vector>
 
 class OperatorProxy;
 class State;
 class TaskProxy;
 
+namespace utils {
+class BinaryReader;
+class BinaryWriter;
+}
+
 
 class SearchNode {
     State state;
-    SearchNodeInfo &info;
+    SearchNodeInfo info;
 public:
-    SearchNode(const State &state, SearchNodeInfo &info);
+    SearchNode(const State &state, const SearchNodeInfo &info);
 
     const State &get_state() const;
 
@@ -47,21 +53,31 @@ public:
 
 
 class SearchSpace {
-    PerStateInformation<SearchNodeInfo> search_node_infos;
+    const SearchNodeLayout layout;
+    PerStateArray<int> search_node_infos;
 
     StateRegistry &state_registry;
+    const OperatorCost cost_type;
+    const bool is_unit_cost;
+
+    const SearchNodeInfo get_info(const State &state) const;
+    int get_adjusted_cost(const OperatorProxy &op) const;
+    OperatorID find_creating_operator(
+        const State &parent, const State &state) const;
+    std::vector<std::pair<StateID, OperatorID>> find_predecessors(
+        const State &state) const;
+    void trace_path_without_parents(const State &goal_state,
+                                    std::vector<OperatorID> &path,
+                                    std::vector<StateID> &trajectory) const;
 public:
-    explicit SearchSpace(StateRegistry &state_registry);
+    SearchSpace(StateRegistry &state_registry,
+                OperatorCost cost_type = NORMAL,
+                ParentPointers parent_pointers = ParentPointers::FULL);
 
     SearchNode get_node(const State &state);
 
-    StateID get_parent_id(const State &state) const {
-        return search_node_infos[state].parent_state_id;
-    }
-
-    OperatorID get_creating_operator(const State &state) const {
-        return search_node_infos[state].creating_operator;
-    }
+    StateID get_parent_id(const State &state) const;
+    OperatorID get_creating_operator(const State &state) const;
 
     void trace_path(const State &goal_state,
                     std::vector<OperatorID> &path) const;
@@ -73,6 +89,10 @@ public:
 
     void dump(const TaskProxy &task_proxy) const;
     void print_statistics() const;
+
+    // Store and restore the search nodes of all states in the registry.
+    void save(utils::BinaryWriter &writer) const;
+    void load(utils::BinaryReader &reader);
 };
 
 #endif
@@ -1,5 +1,6 @@
 #include "search_statistics.h"
 
+#include "utils/binary_io.h"
 #include "utils/logging.h"
 #include "utils/timer.h"
 #include "utils/system.h"
@@ -97,3 +98,31 @@ void SearchStatistics::print_detailed_statistics() const {
                      << lastjump_generated_states << " state(s)." << endl;
     }
 }
+
+void SearchStatistics::save(utils::BinaryWriter &writer) const {
+    writer.write_vector<int>({
+        expanded_states, evaluated_states, evaluations, generated_states,
+        reopened_states, dead_end_states, generated_ops, lastjump_f_value,
+        lastjump_expanded_states, lastjump_reopened_states,
+        lastjump_evaluated_states, lastjump_generated_states});
+}
+
+void SearchStatistics::load(utils::BinaryReader &reader) {
+    vector<int> counters = reader.read_vector<int>();
+    if (counters.size() != 12) {
+        cerr << "Invalid search statistics." << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+    }
+    expanded_states = counters[0];
+    evaluated_states = counters[1];
+    evaluations = counters[2];
+    generated_states = counters[3];
+    reopened_states = counters[4];
+    dead_end_states = counters[5];
+    generated_ops = counters[6];
+    lastjump_f_value = counters[7];
+    lastjump_expanded_states = counters[8];
+    lastjump_reopened_states = counters[9];
+    lastjump_evaluated_states = counters[10];
+    lastjump_generated_states = counters[11];
+}
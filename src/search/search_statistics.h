@@ -14,6 +14,8 @@
 */
 
 namespace utils {
+class BinaryReader;
+class BinaryWriter;
 enum class Verbosity;
 }
 
@@ -66,6 +68,7 @@ public:
     int get_generated() const {return generated_states;}
     int get_reopened() const {return reopened_states;}
     int get_generated_ops() const {return generated_ops;}
+    int get_dead_ends() const {return dead_end_states;}
 
     /*
       Call the following method with the f value of every expanded
@@ -89,6 +92,10 @@ public:
     // output
     void print_basic_statistics() const;
     void print_detailed_statistics() const;
+
+    // Store and restore the counters, e.g. in a checkpoint.
+    void save(utils::BinaryWriter &writer) const;
+    void load(utils::BinaryReader &reader);
 };
 
 #endif
@@ -8,12 +8,17 @@
 
 class StateID {
     friend class StateRegistry;
+    friend class ConcurrentStateRegistry;
     friend std::ostream &operator<<(std::ostream &os, StateID id);
     template<typename>
     friend class PerStateInformation;
     template<typename>
     friend class PerStateArray;
+    template<typename>
+    friend class ConcurrentPerStateInformation;
     friend class PerStateBitset;
+    friend class SearchNodeInfo;
+    friend class SearchSpace;
 
     int value;
     explicit StateID(int value_)
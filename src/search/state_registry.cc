@@ -4,19 +4,48 @@
 #include "task_proxy.h"
 
 #include "task_utils/task_properties.h"
+#include "utils/binary_io.h"
 #include "utils/logging.h"
+#include "utils/system.h"
 
 using namespace std;
 
-StateRegistry::StateRegistry(const TaskProxy &task_proxy)
+StateRegistry::StateRegistry(
+    const TaskProxy &task_proxy, bool incremental_hashing,
+    const shared_ptr<segment_storage::SegmentStorage> &segment_storage)
     : task_proxy(task_proxy),
       state_packer(task_properties::g_state_packers[task_proxy]),
       axiom_evaluator(g_axiom_evaluators[task_proxy]),
       num_variables(task_proxy.get_variables().size()),
-      state_data_pool(get_bins_per_state()),
+      incremental_hashing(incremental_hashing),
+      segment_storage(segment_storage),
+      state_data_pool(get_bins_per_entry(), segment_storage),
       registered_states(
-          StateIDSemanticHash(state_data_pool, get_bins_per_state()),
-          StateIDSemanticEqual(state_data_pool, get_bins_per_state())) {
+          StateIDSemanticHash(
+              state_data_pool, get_bins_per_state(), incremental_hashing),
+          StateIDSemanticEqual(
+              state_data_pool, get_bins_per_state(), incremental_hashing)) {
+    if (incremental_hashing) {
+        // The keys only have to be fixed per task, so we hash the facts.
+        for (VariableProxy var : task_proxy.get_variables()) {
+            vector<PackedStateBin> keys;
+            for (int value = 0; value < var.get_domain_size(); ++value) {
+                utils::HashState hash_state;
+                hash_state.feed(var.get_id());
+                hash_state.feed(value);
+                keys.push_back(hash_state.get_hash32());
+            }
+            zobrist_keys.push_back(move(keys));
+        }
+    }
+}
+
+void StateRegistry::set_zobrist_hash(PackedStateBin *buffer) const {
+    PackedStateBin hash = 0;
+    for (int var = 0; var < num_variables; ++var) {
+        hash ^= zobrist_keys[var][state_packer.get(buffer, var)];
+    }
+    buffer[get_bins_per_state()] = hash;
 }
 
 StateID StateRegistry::insert_id_or_pop_state() {
@@ -43,7 +72,7 @@ State StateRegistry::lookup_state(StateID id) const {
 
 const State &StateRegistry::get_initial_state() {
     if (!cached_initial_state) {
-        int num_bins = get_bins_per_state();
+        int num_bins = get_bins_per_entry();
         unique_ptr<PackedStateBin[]> buffer(new PackedStateBin[num_bins]);
         // Avoid garbage values in half-full bins.
         fill_n(buffer.get(), num_bins, 0);
@@ -52,6 +81,9 @@ const State &StateRegistry::get_initial_state() {
         for (size_t i = 0; i < initial_state.size(); ++i) {
             state_packer.set(buffer.get(), i, initial_state[i].get_value());
         }
+        if (incremental_hashing) {
+            set_zobrist_hash(buffer.get());
+        }
         state_data_pool.push_back(buffer.get());
         StateID id = insert_id_or_pop_state();
         cached_initial_state = utils::make_unique_ptr<State>(lookup_state(id));
@@ -60,7 +92,7 @@ const State &StateRegistry::get_initial_state() {
 }
 
 State StateRegistry::insert_state(std::vector<int>&& state) {
-    int num_bins = get_bins_per_state();
+    int num_bins = get_bins_per_entry();
     unique_ptr<PackedStateBin[]> buffer(new PackedStateBin[num_bins]);
     // Avoid garbage values in half-full bins.
     fill_n(buffer.get(), num_bins, 0);
@@ -68,17 +100,40 @@ State StateRegistry::insert_state(std::vector<int>&& state) {
     for (size_t i = 0; i < state.size(); ++i) {
         state_packer.set(buffer.get(), i, state[i]);
     }
+    if (incremental_hashing) {
+        set_zobrist_hash(buffer.get());
+    }
     state_data_pool.push_back(buffer.get());
     // buffer is copied by push_back
     StateID id = insert_id_or_pop_state();
     return lookup_state(id);
  }
 
+StateID StateRegistry::find_state(const vector<int> &values) {
+    int num_bins = get_bins_per_entry();
+    unique_ptr<PackedStateBin[]> buffer(new PackedStateBin[num_bins]);
+    fill_n(buffer.get(), num_bins, 0);
+    for (size_t i = 0; i < values.size(); ++i) {
+        state_packer.set(buffer.get(), i, values[i]);
+    }
+    if (incremental_hashing) {
+        set_zobrist_hash(buffer.get());
+    }
+    // The hash set compares the entries of the pool, so the state is added
+    // temporarily.
+    state_data_pool.push_back(buffer.get());
+    int key = registered_states.find(state_data_pool.size() - 1);
+    state_data_pool.pop_back();
+    return key == -1 ? StateID::no_state : StateID(key);
+}
+
 //TODO it would be nice to move the actual state creation (and operator application)
 //     out of the StateRegistry. This could for example be done by global functions
 //     operating on state buffers (PackedStateBin *).
 State StateRegistry::get_successor_state(const State &predecessor, const OperatorProxy &op) {
     assert(!op.is_axiom());
+    // The stored hash of the predecessor is copied along with its data.
+    assert(!incremental_hashing || predecessor.get_registry() == this);
     state_data_pool.push_back(predecessor.get_buffer());
     PackedStateBin *buffer = state_data_pool[state_data_pool.size() - 1];
     /* Experiments for issue348 showed that for tasks with axioms it's faster
@@ -94,6 +149,12 @@ State StateRegistry::get_successor_state(const State &predecessor, const Operato
         }
         axiom_evaluator.evaluate(new_values);
         for (size_t i = 0; i < new_values.size(); ++i) {
+            if (incremental_hashing) {
+                int old_value = state_packer.get(buffer, i);
+                if (old_value != new_values[i]) {
+                    update_zobrist_hash(buffer, i, old_value, new_values[i]);
+                }
+            }
             state_packer.set(buffer, i, new_values[i]);
         }
         StateID id = insert_id_or_pop_state();
@@ -102,6 +163,14 @@ State StateRegistry::get_successor_state(const State &predecessor, const Operato
         for (EffectProxy effect : op.get_effects()) {
             if (does_fire(effect, predecessor)) {
                 FactPair effect_pair = effect.get_fact().get_pair();
+                if (incremental_hashing) {
+                    int old_value = state_packer.get(buffer, effect_pair.var);
+                    if (old_value != effect_pair.value) {
+                        update_zobrist_hash(
+                            buffer, effect_pair.var, old_value,
+                            effect_pair.value);
+                    }
+                }
                 state_packer.set(buffer, effect_pair.var, effect_pair.value);
             }
         }
@@ -114,11 +183,57 @@ int StateRegistry::get_bins_per_state() const {
     return state_packer.get_num_bins();
 }
 
+int StateRegistry::get_bins_per_entry() const {
+    return get_bins_per_state() + (incremental_hashing ? 1 : 0);
+}
+
 int StateRegistry::get_state_size_in_bytes() const {
-    return get_bins_per_state() * sizeof(PackedStateBin);
+    return get_bins_per_entry() * sizeof(PackedStateBin);
 }
 
 void StateRegistry::print_statistics() const {
     utils::g_log << "Number of registered states: " << size() << endl;
     registered_states.print_statistics();
+    if (segment_storage) {
+        segment_storage->print_statistics();
+    }
+}
+
+void StateRegistry::save(utils::BinaryWriter &writer) const {
+    int num_bins = get_bins_per_entry();
+    writer.write<int>(num_bins);
+    writer.write<uint64_t>(size());
+    for (size_t id = 0; id < size(); ++id) {
+        writer.write_bytes(state_data_pool[id], num_bins * sizeof(PackedStateBin));
+    }
+}
+
+void StateRegistry::load(utils::BinaryReader &reader) {
+    int num_bins = get_bins_per_entry();
+    if (reader.read<int>() != num_bins) {
+        cerr << "The stored states do not match the state representation "
+             << "of the task." << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+    }
+    size_t num_states = reader.read_size(num_bins * sizeof(PackedStateBin));
+    if (num_states < size()) {
+        cerr << "More states are registered than stored." << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+    }
+    vector<PackedStateBin> buffer(num_bins);
+    for (size_t id = 0; id < num_states; ++id) {
+        reader.read_bytes(buffer.data(), num_bins * sizeof(PackedStateBin));
+        if (id < size()) {
+            if (!equal(buffer.begin(), buffer.end(), state_data_pool[id])) {
+                cerr << "The stored states do not belong to this task." << endl;
+                utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+            }
+            continue;
+        }
+        state_data_pool.push_back(buffer.data());
+        if (insert_id_or_pop_state().value != static_cast<int>(id)) {
+            cerr << "The stored states contain duplicates." << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+        }
+    }
 }
@@ -7,6 +7,7 @@
 
 #include "algorithms/int_hash_set.h"
 #include "algorithms/int_packer.h"
+#include "algorithms/segment_storage.h"
 #include "algorithms/segmented_vector.h"
 #include "algorithms/subscriber.h"
 #include "utils/hash.h"
@@ -81,15 +82,16 @@
 
     SearchNodeInfo
       Remaining part of a search node besides the state that needs to be stored.
+      It is a view of a short int array whose layout (SearchNodeLayout) depends
+      on the information stored for reconstructing plans.
 
     SearchNode
-      A SearchNode combines a StateID, a reference to a SearchNodeInfo and
-      OperatorCost. It is generated for easier access and not intended for long
-      term storage. The state data is only stored once an can be accessed
-      through the StateID.
+      A SearchNode combines a StateID, a SearchNodeInfo and OperatorCost. It is
+      generated for easier access and not intended for long term storage. The
+      state data is only stored once an can be accessed through the StateID.
 
     SearchSpace
-      The SearchSpace uses PerStateInformation<SearchNodeInfo> to map StateIDs to
+      The SearchSpace uses PerStateArray<int> to map StateIDs to the data of
       SearchNodeInfos. The open lists only have to store StateIDs which can be
       used to look up a search node in the SearchSpace on demand.
 
@@ -109,22 +111,38 @@ namespace int_packer {
 class IntPacker;
 }
 
+namespace utils {
+class BinaryReader;
+class BinaryWriter;
+}
+
 using PackedStateBin = int_packer::IntPacker::Bin;
+using StateDataPool = segmented_vector::SegmentedArrayVector<
+    PackedStateBin, segment_storage::SegmentAllocator<PackedStateBin>>;
 
 
 class StateRegistry : public subscriber::SubscriberService<StateRegistry> {
+    /*
+      With incremental hashing, the hash of a state is stored in an extra bin
+      behind its packed data (at index state_size).
+    */
     struct StateIDSemanticHash {
-        const segmented_vector::SegmentedArrayVector<PackedStateBin> &state_data_pool;
+        const StateDataPool &state_data_pool;
         int state_size;
+        bool stored_hash;
         StateIDSemanticHash(
-            const segmented_vector::SegmentedArrayVector<PackedStateBin> &state_data_pool,
-            int state_size)
+            const StateDataPool &state_data_pool,
+            int state_size, bool stored_hash)
             : state_data_pool(state_data_pool),
-              state_size(state_size) {
+              state_size(state_size),
+              stored_hash(stored_hash) {
         }
 
         int_hash_set::HashType operator()(int id) const {
             const PackedStateBin *data = state_data_pool[id];
+            if (stored_hash) {
+                return data[state_size];
+            }
             utils::HashState hash_state;
             for (int i = 0; i < state_size; ++i) {
                 hash_state.feed(data[i]);
@@ -134,18 +152,23 @@ class StateRegistry : public subscriber::SubscriberService<StateRegistry> {
     };
 
     struct StateIDSemanticEqual {
-        const segmented_vector::SegmentedArrayVector<PackedStateBin> &state_data_pool;
+        const StateDataPool &state_data_pool;
         int state_size;
+        bool stored_hash;
         StateIDSemanticEqual(
-            const segmented_vector::SegmentedArrayVector<PackedStateBin> &state_data_pool,
-            int state_size)
+            const StateDataPool &state_data_pool,
+            int state_size, bool stored_hash)
             : state_data_pool(state_data_pool),
-              state_size(state_size) {
+              state_size(state_size),
+              stored_hash(stored_hash) {
         }
 
         bool operator()(int lhs, int rhs) const {
             const PackedStateBin *lhs_data = state_data_pool[lhs];
             const PackedStateBin *rhs_data = state_data_pool[rhs];
+            if (stored_hash && lhs_data[state_size] != rhs_data[state_size]) {
+                return false;
+            }
             return std::equal(lhs_data, lhs_data + state_size, rhs_data);
         }
     };
@@ -162,20 +185,49 @@ class StateRegistry : public subscriber::SubscriberService<StateRegistry> {
     AxiomEvaluator &axiom_evaluator;
     const int num_variables;
 
-    segmented_vector::SegmentedArrayVector<PackedStateBin> state_data_pool;
+    /*
+      Incremental (Zobrist) hashing: the hash of a state is the XOR of a
+      random key for each of its facts. The hash of a successor is derived
+      from its predecessor by exchanging the keys of the changed variables
+      only, instead of hashing the whole packed state.
+    */
+    const bool incremental_hashing;
+    std::vector<std::vector<PackedStateBin>> zobrist_keys;
+
+    /*
+      If the segment storage is not a null pointer, the state data and the
+      per-state information of this registry are stored there (possibly in
+      a memory-mapped file) instead of the heap.
+    */
+    const std::shared_ptr<segment_storage::SegmentStorage> segment_storage;
+    StateDataPool state_data_pool;
     StateIDSet registered_states;
 
     std::unique_ptr<State> cached_initial_state;
 
     StateID insert_id_or_pop_state();
     int get_bins_per_state() const;
+    // Bins per state in state_data_pool (including the stored hash).
+    int get_bins_per_entry() const;
+    void set_zobrist_hash(PackedStateBin *buffer) const;
+    void update_zobrist_hash(
+        PackedStateBin *buffer, int var, int old_value, int new_value) const {
+        buffer[get_bins_per_state()] ^=
+            zobrist_keys[var][old_value] ^ zobrist_keys[var][new_value];
+    }
 public:
-    explicit StateRegistry(const TaskProxy &task_proxy);
+    explicit StateRegistry(
+        const TaskProxy &task_proxy, bool incremental_hashing = false,
+        const std::shared_ptr<segment_storage::SegmentStorage> &segment_storage = nullptr);
 
     const TaskProxy &get_task_proxy() const {
         return task_proxy;
     }
 
+    const std::shared_ptr<segment_storage::SegmentStorage> &get_segment_storage() const {
+        return segment_storage;
+    }
+
     int get_num_variables() const {
         return num_variables;
     }
@@ -198,6 +250,12 @@ public:
 
     State insert_state(std::vector<int> &&state);
 
+    /*
+      Returns the ID of the state with the given values if it is registered
+      and StateID::no_state otherwise. The state is not registered.
+    */
+    StateID find_state(const std::vector<int> &values);
+
     /*
       Returns the state that results from applying op to predecessor and
       registers it if this was not done before. This is an expensive operation
@@ -216,6 +274,14 @@ public:
 
     void print_statistics() const;
 
+    /*
+      Store the packed data of all registered states. Loading re-registers
+      the stored states with the same IDs. States registered before loading
+      must be a prefix of the stored ones (usually only the initial state).
+    */
+    void save(utils::BinaryWriter &writer) const;
+    void load(utils::BinaryReader &reader);
+
     class const_iterator : public std::iterator<
                                std::forward_iterator_tag, StateID> {
         /*
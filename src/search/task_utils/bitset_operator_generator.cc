@@ -0,0 +1,97 @@
+#include "bitset_operator_generator.h"
+
+#include "../task_proxy.h"
+
+#include <cassert>
+#include <map>
+
+using namespace std;
+
+namespace successor_generator {
+BitsetOperatorGenerator::BitsetOperatorGenerator(const TaskProxy &task_proxy) {
+    VariablesProxy variables = task_proxy.get_variables();
+    fact_offsets.reserve(variables.size());
+    int num_facts = 0;
+    for (VariableProxy var : variables) {
+        fact_offsets.push_back(num_facts);
+        num_facts += var.get_domain_size();
+    }
+    num_words = (num_facts + BITS_PER_WORD - 1) / BITS_PER_WORD;
+    groups_by_fact.resize(num_facts + 1);
+
+    /*
+      Group the operators by their watched fact and the words their
+      preconditions occupy.
+    */
+    map<pair<int, vector<int>>, int> group_ids;
+    for (OperatorProxy op : task_proxy.get_operators()) {
+        map<int, Word> mask;
+        int watched_fact = num_facts;
+        int watched_domain_size = 0;
+        for (FactProxy fact : op.get_preconditions()) {
+            FactPair pair = fact.get_pair();
+            int bit = fact_offsets[pair.var] + pair.value;
+            mask[bit / BITS_PER_WORD] |= Word(1) << (bit % BITS_PER_WORD);
+            int domain_size = variables[pair.var].get_domain_size();
+            if (domain_size > watched_domain_size) {
+                watched_fact = bit;
+                watched_domain_size = domain_size;
+            }
+        }
+        vector<int> words;
+        words.reserve(mask.size());
+        for (const auto &entry : mask) {
+            words.push_back(entry.first);
+        }
+        auto inserted = group_ids.emplace(
+            make_pair(watched_fact, words), groups.size());
+        if (inserted.second) {
+            groups_by_fact[watched_fact].push_back(groups.size());
+            groups.emplace_back();
+            groups.back().words = move(words);
+        }
+        Group &group = groups[inserted.first->second];
+        for (const auto &entry : mask) {
+            group.masks.push_back(entry.second);
+        }
+        group.operators.emplace_back(op.get_id());
+    }
+}
+
+void BitsetOperatorGenerator::check_group(
+    const Group &group, const vector<Word> &state_bits,
+    vector<OperatorID> &applicable_ops) const {
+    const int num_group_words = group.words.size();
+    const int *words = group.words.data();
+    const Word *mask = group.masks.data();
+    for (OperatorID op_id : group.operators) {
+        Word missing = 0;
+        for (int i = 0; i < num_group_words; ++i) {
+            missing |= mask[i] & ~state_bits[words[i]];
+        }
+        if (!missing) {
+            applicable_ops.push_back(op_id);
+        }
+        mask += num_group_words;
+    }
+}
+
+void BitsetOperatorGenerator::generate_applicable_ops(
+    const vector<int> &state, vector<OperatorID> &applicable_ops) const {
+    assert(state.size() == fact_offsets.size());
+    vector<Word> state_bits(num_words, 0);
+    for (size_t var = 0; var < state.size(); ++var) {
+        int bit = fact_offsets[var] + state[var];
+        state_bits[bit / BITS_PER_WORD] |= Word(1) << (bit % BITS_PER_WORD);
+    }
+
+    for (size_t var = 0; var < state.size(); ++var) {
+        for (int group_id : groups_by_fact[fact_offsets[var] + state[var]]) {
+            check_group(groups[group_id], state_bits, applicable_ops);
+        }
+    }
+    for (int group_id : groups_by_fact.back()) {
+        check_group(groups[group_id], state_bits, applicable_ops);
+    }
+}
+}
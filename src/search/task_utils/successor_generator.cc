@@ -1,13 +1,20 @@
 #include "successor_generator.h"
 
+#include "bitset_operator_generator.h"
 #include "operator_generator_internals.h"
 #include "successor_generator_factory.h"
 
 using namespace std;
 
 namespace successor_generator {
-SuccessorGenerator::SuccessorGenerator(const TaskProxy &task_proxy)
-    : root(SuccessorGeneratorFactory(task_proxy).create()) {
+SuccessorGenerator::SuccessorGenerator(
+    const TaskProxy &task_proxy, SuccessorGeneratorType type) {
+    if (type == SuccessorGeneratorType::BITSET) {
+        bitset_generator =
+            utils::make_unique_ptr<BitsetOperatorGenerator>(task_proxy);
+    } else {
+        root = SuccessorGeneratorFactory(task_proxy).create();
+    }
 }
 
 SuccessorGenerator::~SuccessorGenerator() = default;
@@ -15,17 +22,31 @@ SuccessorGenerator::~SuccessorGenerator() = default;
 void SuccessorGenerator::generate_applicable_ops(
     const State &state, vector<OperatorID> &applicable_ops) const {
     state.unpack();
-    root->generate_applicable_ops(state.get_unpacked_values(), applicable_ops);
+    if (bitset_generator) {
+        bitset_generator->generate_applicable_ops(
+            state.get_unpacked_values(), applicable_ops);
+    } else {
+        root->generate_applicable_ops(
+            state.get_unpacked_values(), applicable_ops);
+    }
 }
 
 PerTaskInformation<SuccessorGenerator> g_successor_generators;
+PerTaskInformation<SuccessorGenerator> g_bitset_successor_generators(
+    [](const TaskProxy &task_proxy) {
+        return utils::make_unique_ptr<SuccessorGenerator>(
+            task_proxy, SuccessorGeneratorType::BITSET);
+    });
 
-SuccessorGenerator &get_successor_generator(const TaskProxy &task_proxy) {
+SuccessorGenerator &get_successor_generator(
+    const TaskProxy &task_proxy, SuccessorGeneratorType type) {
     utils::g_log << "Building successor generator..." << flush;
     int peak_memory_before = utils::get_peak_memory_in_kb();
     utils::Timer successor_generator_timer;
     SuccessorGenerator &successor_generator =
-            g_successor_generators[task_proxy];
+        (type == SuccessorGeneratorType::BITSET)
+        ? g_bitset_successor_generators[task_proxy]
+        : g_successor_generators[task_proxy];
     successor_generator_timer.stop();
     utils::g_log << "done!" << endl;
     int peak_memory_after = utils::get_peak_memory_in_kb();
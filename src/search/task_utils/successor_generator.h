@@ -13,12 +13,21 @@ namespace operator_generator {
     class GeneratorBase;
 }
 namespace successor_generator {
+class BitsetOperatorGenerator;
+
+enum class SuccessorGeneratorType {
+    TREE,
+    BITSET
+};
 
 class SuccessorGenerator {
     std::unique_ptr<operator_generator::GeneratorBase> root;
+    std::unique_ptr<BitsetOperatorGenerator> bitset_generator;
 
 public:
-    explicit SuccessorGenerator(const TaskProxy &task_proxy);
+    explicit SuccessorGenerator(
+        const TaskProxy &task_proxy,
+        SuccessorGeneratorType type = SuccessorGeneratorType::TREE);
     /*
       We cannot use the default destructor (implicitly or explicitly)
       here because GeneratorBase is a forward declaration and the
@@ -31,8 +40,11 @@ public:
 };
 
 extern PerTaskInformation<SuccessorGenerator> g_successor_generators;
+extern PerTaskInformation<SuccessorGenerator> g_bitset_successor_generators;
 
-SuccessorGenerator &get_successor_generator(const TaskProxy &task_proxy);
+SuccessorGenerator &get_successor_generator(
+    const TaskProxy &task_proxy,
+    SuccessorGeneratorType type = SuccessorGeneratorType::TREE);
 
 }
 
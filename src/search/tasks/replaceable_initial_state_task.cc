@@ -0,0 +1,23 @@
+#include "replaceable_initial_state_task.h"
+
+#include <cassert>
+
+using namespace std;
+
+namespace extra_tasks {
+ReplaceableInitialStateTask::ReplaceableInitialStateTask(
+    const shared_ptr<AbstractTask> &parent)
+    : DelegatingTask(parent),
+      initial_state(parent->get_initial_state_values()) {
+}
+
+vector<int> ReplaceableInitialStateTask::get_initial_state_values() const {
+    return initial_state;
+}
+
+void ReplaceableInitialStateTask::set_initial_state_values(
+    vector<int> &&values) {
+    assert(static_cast<int>(values.size()) == get_num_variables());
+    initial_state = move(values);
+}
+}
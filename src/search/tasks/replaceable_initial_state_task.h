@@ -0,0 +1,30 @@
+#ifndef TASKS_REPLACEABLE_INITIAL_STATE_TASK_H
+#define TASKS_REPLACEABLE_INITIAL_STATE_TASK_H
+
+#include "delegating_task.h"
+
+#include <vector>
+
+namespace extra_tasks {
+/*
+  Task whose initial state can be replaced after construction. Everything
+  else (including the goals) is delegated to the parent task. This allows
+  objects which are bound to a task (e.g. evaluators) to be reused for
+  several tasks which differ only in their initial states.
+
+  Replacing the initial state does not affect state registries which already
+  created their initial state.
+*/
+class ReplaceableInitialStateTask : public tasks::DelegatingTask {
+    std::vector<int> initial_state;
+public:
+    explicit ReplaceableInitialStateTask(
+        const std::shared_ptr<AbstractTask> &parent);
+    virtual ~ReplaceableInitialStateTask() override = default;
+
+    virtual std::vector<int> get_initial_state_values() const override;
+
+    void set_initial_state_values(std::vector<int> &&values);
+};
+}
+#endif
@@ -0,0 +1,66 @@
+#include "binary_io.h"
+
+#include "system.h"
+
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+using namespace std;
+
+namespace utils {
+void BinaryReader::read_bytes(void *data, size_t num_bytes) {
+    in.read(static_cast<char *>(data), num_bytes);
+    if (!in || static_cast<size_t>(in.gcount()) != num_bytes) {
+        cerr << "Unexpected end of binary input." << endl;
+        exit_with(ExitCode::SEARCH_INPUT_ERROR);
+    }
+}
+
+string BinaryReader::read_string() {
+    string str(read_size(), '\0');
+    read_bytes(&str[0], str.size());
+    return str;
+}
+
+size_t BinaryReader::read_size(size_t bytes_per_element) {
+    uint64_t size = read<uint64_t>();
+    // Guard against allocating huge amounts of memory for corrupted input.
+    streampos position = in.tellg();
+    if (position != streampos(-1)) {
+        in.seekg(0, ios::end);
+        streampos end = in.tellg();
+        in.seekg(position);
+        if (size > static_cast<uint64_t>(end - position) / bytes_per_element) {
+            cerr << "Corrupted binary input: size " << size
+                 << " exceeds the input." << endl;
+            exit_with(ExitCode::SEARCH_INPUT_ERROR);
+        }
+    }
+    return size;
+}
+
+bool write_file_atomically(
+    const string &filename,
+    const function<void(BinaryWriter &)> &write_content) {
+    /*
+      Processes and threads writing the same file (e.g. a shared cache) use
+      distinct temporary files.
+    */
+    static atomic<unsigned int> num_calls(0);
+    string tmp_filename = filename + ".tmp" + to_string(get_process_id()) +
+        "." + to_string(num_calls++);
+    {
+        ofstream out(tmp_filename, ios::binary | ios::trunc);
+        BinaryWriter writer(out);
+        write_content(writer);
+        out.close();
+        if (out.fail()) {
+            remove(tmp_filename.c_str());
+            return false;
+        }
+    }
+    return rename(tmp_filename.c_str(), filename.c_str()) == 0;
+}
+}
@@ -0,0 +1,99 @@
+#ifndef UTILS_BINARY_IO_H
+#define UTILS_BINARY_IO_H
+
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace utils {
+/*
+  Raw binary serialization of trivially copyable values, strings and
+  vectors, e.g. for checkpoints. Values are stored in the byte order of the
+  machine, so the files are only meant to be read on the same machine.
+*/
+class BinaryWriter {
+    std::ostream &out;
+public:
+    explicit BinaryWriter(std::ostream &out) : out(out) {
+    }
+
+    void write_bytes(const void *data, size_t num_bytes) {
+        out.write(static_cast<const char *>(data), num_bytes);
+    }
+
+    template<typename T>
+    void write(const T &value) {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "Only trivially copyable types can be written.");
+        write_bytes(&value, sizeof(T));
+    }
+
+    void write_string(const std::string &str) {
+        write<uint64_t>(str.size());
+        write_bytes(str.data(), str.size());
+    }
+
+    template<typename T>
+    void write_vector(const std::vector<T> &vec) {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "Only trivially copyable types can be written.");
+        write<uint64_t>(vec.size());
+        write_bytes(vec.data(), vec.size() * sizeof(T));
+    }
+
+    bool good() const {
+        return out.good();
+    }
+};
+
+/*
+  Reads the values written by BinaryWriter. Reading past the end of the
+  input or a corrupted size aborts the planner with an input error.
+*/
+class BinaryReader {
+    std::istream &in;
+public:
+    explicit BinaryReader(std::istream &in) : in(in) {
+    }
+
+    void read_bytes(void *data, size_t num_bytes);
+
+    template<typename T>
+    T read() {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "Only trivially copyable types can be read.");
+        T value;
+        read_bytes(&value, sizeof(T));
+        return value;
+    }
+
+    std::string read_string();
+
+    template<typename T>
+    std::vector<T> read_vector() {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "Only trivially copyable types can be read.");
+        std::vector<T> vec(read_size(sizeof(T)));
+        read_bytes(vec.data(), vec.size() * sizeof(T));
+        return vec;
+    }
+
+    // Read a size written as uint64_t and check it against the input size.
+    size_t read_size(size_t bytes_per_element = 1);
+};
+
+/*
+  Write a file via write_content and replace the given file only after
+  writing succeeded. Thus, the file always contains a complete version even
+  if the process is killed while writing. Return false on failure.
+*/
+extern bool write_file_atomically(
+    const std::string &filename,
+    const std::function<void(BinaryWriter &)> &write_content);
+}
+
+#endif
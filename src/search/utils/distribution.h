@@ -10,6 +10,7 @@
 #include <memory>
 #include <ostream>
 #include <random>
+#include <string>
 
 namespace utils {
 template<typename T>
@@ -26,6 +27,13 @@ public:
     virtual void dump_parameters(std::ostream &stream) = 0;
     virtual void upgrade_parameters();
 
+    std::string get_rng_state() const {
+        return get_mt19937_state(rng);
+    }
+
+    void set_rng_state(const std::string &state) {
+        set_mt19937_state(rng, state);
+    }
 };
 
 class DiscreteDistribution : public Distribution<int> {
@@ -3,6 +3,8 @@
 #include "system.h"
 
 #include <chrono>
+#include <iostream>
+#include <sstream>
 
 using namespace std;
 
@@ -33,6 +35,14 @@ void RandomNumberGenerator::seed(int seed) {
     rng.seed(seed);
 }
 
+string RandomNumberGenerator::get_state() const {
+    return get_mt19937_state(rng);
+}
+
+void RandomNumberGenerator::set_state(const string &state) {
+    set_mt19937_state(rng, state);
+}
+
 vector<int> RandomNumberGenerator::choose_n_of_N(int n, int N) {
     vector<int> result;
     result.reserve(n);
@@ -45,4 +55,19 @@ vector<int> RandomNumberGenerator::choose_n_of_N(int n, int N) {
     }
     return result;
 }
+
+string get_mt19937_state(const mt19937 &rng) {
+    ostringstream out;
+    out << rng;
+    return out.str();
+}
+
+void set_mt19937_state(mt19937 &rng, const string &state) {
+    istringstream in(state);
+    in >> rng;
+    if (in.fail()) {
+        cerr << "Invalid state of random number generator." << endl;
+        exit_with(ExitCode::SEARCH_INPUT_ERROR);
+    }
+}
 }
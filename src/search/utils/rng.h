@@ -4,6 +4,7 @@
 #include <algorithm>
 #include <cassert>
 #include <random>
+#include <string>
 #include <vector>
 
 namespace utils {
@@ -21,6 +22,10 @@ public:
 
     void seed(int seed);
 
+    // The state of the generator as text, e.g. to store it in a checkpoint.
+    std::string get_state() const;
+    void set_state(const std::string &state);
+
     // Return random double in [0..1).
     double operator()() {
         std::uniform_real_distribution<double> distribution(0.0, 1.0);
@@ -76,6 +81,9 @@ public:
 
     std::vector<int> choose_n_of_N(int n, int N);
 };
+
+extern std::string get_mt19937_state(const std::mt19937 &rng);
+extern void set_mt19937_state(std::mt19937 &rng, const std::string &state);
 }
 
 #endif